@@ -858,6 +858,7 @@ private:
     void init_ardupilot() override;
     void startup_INS_ground();
     void update_dynamic_notch() override;
+    void update_dynamic_notch(AP_InertialSensor::HarmonicNotch &notch);
     bool position_ok() const;
     bool ekf_position_ok() const;
     bool optflow_position_ok() const;
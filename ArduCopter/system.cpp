@@ -244,42 +244,52 @@ void Copter::startup_INS_ground()
     ahrs.reset();
 }
 
-// update the harmonic notch filter center frequency dynamically
+// update the harmonic notch filter center frequencies dynamically
 void Copter::update_dynamic_notch()
 {
-    if (!ins.gyro_harmonic_notch_enabled()) {
-        return;
+    for (auto &notch : ins.harmonic_notches) {
+        if (notch.enabled()) {
+            update_dynamic_notch(notch);
+        }
     }
-    const float ref_freq = ins.get_gyro_harmonic_notch_center_freq_hz();
-    const float ref = ins.get_gyro_harmonic_notch_reference();
+}
+
+// update the center frequency of one harmonic notch bank from its tracking source
+void Copter::update_dynamic_notch(AP_InertialSensor::HarmonicNotch &notch)
+{
+    const float ref_freq = notch.params().center_freq_hz();
+    const float ref = notch.params().reference();
     if (is_zero(ref)) {
-        ins.update_harmonic_notch_freq_hz(ref_freq);
+        notch.update_freq_hz(ref_freq);
         return;
     }
 
     const float throttle_freq = ref_freq * MAX(1.0f, sqrtf(motors->get_throttle_out() / ref));
 
-    switch (ins.get_gyro_harmonic_notch_tracking_mode()) {
+    switch (notch.params().tracking_mode()) {
         case HarmonicNotchDynamicMode::UpdateThrottle: // throttle based tracking
             // set the harmonic notch filter frequency approximately scaled on motor rpm implied by throttle
-            ins.update_harmonic_notch_freq_hz(throttle_freq);
+            notch.update_freq_hz(throttle_freq);
             break;
 
 #if RPM_ENABLED == ENABLED
         case HarmonicNotchDynamicMode::UpdateRPM: // rpm sensor based tracking
+        case HarmonicNotchDynamicMode::UpdateRPM2: {
+            const uint8_t sensor = (notch.params().tracking_mode() == HarmonicNotchDynamicMode::UpdateRPM) ? 0 : 1;
             float rpm;
-            if (rpm_sensor.get_rpm(0, rpm)) {
-                // set the harmonic notch filter frequency from the main rotor rpm
-                ins.update_harmonic_notch_freq_hz(MAX(ref_freq, rpm * ref / 60.0f));
+            if (rpm_sensor.get_rpm(sensor, rpm)) {
+                // set the harmonic notch filter frequency from the rpm sensor
+                notch.update_freq_hz(MAX(ref_freq, rpm * ref / 60.0f));
             } else {
-                ins.update_harmonic_notch_freq_hz(ref_freq);
+                notch.update_freq_hz(ref_freq);
             }
             break;
+        }
 #endif
 #ifdef HAVE_AP_BLHELI_SUPPORT
         case HarmonicNotchDynamicMode::UpdateBLHeli: // BLHeli based tracking
             // set the harmonic notch filter frequency scaled on measured frequency
-            if (ins.has_harmonic_option(HarmonicNotchFilterParams::Options::DynamicHarmonic)) {
+            if (notch.params().hasOption(HarmonicNotchFilterParams::Options::DynamicHarmonic)) {
                 float notches[INS_MAX_NOTCHES];
                 const uint8_t num_notches = AP_BLHeli::get_singleton()->get_motor_frequencies_hz(INS_MAX_NOTCHES, notches);
 
@@ -287,31 +297,31 @@ void Copter::update_dynamic_notch()
                     notches[i] =  MAX(ref_freq, notches[i]);
                 }
                 if (num_notches > 0) {
-                    ins.update_harmonic_notch_frequencies_hz(num_notches, notches);
+                    notch.update_frequencies_hz(num_notches, notches);
                 } else {    // throttle fallback
-                    ins.update_harmonic_notch_freq_hz(throttle_freq);
+                    notch.update_freq_hz(throttle_freq);
                 }
             } else {
-                ins.update_harmonic_notch_freq_hz(MAX(ref_freq, AP_BLHeli::get_singleton()->get_average_motor_frequency_hz() * ref));
+                notch.update_freq_hz(MAX(ref_freq, AP_BLHeli::get_singleton()->get_average_motor_frequency_hz() * ref));
             }
             break;
 #endif
 #if HAL_GYROFFT_ENABLED
         case HarmonicNotchDynamicMode::UpdateGyroFFT: // FFT based tracking
             // set the harmonic notch filter frequency scaled on measured frequency
-            if (ins.has_harmonic_option(HarmonicNotchFilterParams::Options::DynamicHarmonic)) {
+            if (notch.params().hasOption(HarmonicNotchFilterParams::Options::DynamicHarmonic)) {
                 float notches[INS_MAX_NOTCHES];
                 const uint8_t peaks = gyro_fft.get_weighted_noise_center_frequencies_hz(INS_MAX_NOTCHES, notches);
 
-                ins.update_harmonic_notch_frequencies_hz(peaks, notches);
+                notch.update_frequencies_hz(peaks, notches);
             } else {
-                ins.update_harmonic_notch_freq_hz(gyro_fft.get_weighted_noise_center_freq_hz());
+                notch.update_freq_hz(gyro_fft.get_weighted_noise_center_freq_hz());
             }
             break;
 #endif
         case HarmonicNotchDynamicMode::Fixed: // static
         default:
-            ins.update_harmonic_notch_freq_hz(ref_freq);
+            notch.update_freq_hz(ref_freq);
             break;
     }
 }
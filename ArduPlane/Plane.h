@@ -1022,6 +1022,7 @@ private:
     bool should_log(uint32_t mask);
     int8_t throttle_percentage(void);
     void update_dynamic_notch() override;
+    void update_dynamic_notch(AP_InertialSensor::HarmonicNotch &notch);
     void notify_mode(const Mode& mode);
 
     // takeoff.cpp
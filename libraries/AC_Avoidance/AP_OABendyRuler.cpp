@@ -535,7 +535,7 @@ bool AP_OABendyRuler::calc_margin_from_inclusion_and_exclusion_polygons(const Lo
         const Vector2f* boundary = fence->polyfence().get_inclusion_polygon(i, num_points);
      
         // if outside the fence margin is the closest distance but with negative sign
-        const float sign = Polygon_outside(start_NE, boundary, num_points) ? -1.0f : 1.0f;
+        const float sign = fence->polyfence().get_inclusion_polygon_index(i)->outside(start_NE) ? -1.0f : 1.0f;
 
         // calculate min distance (in meters) from line to polygon
         float margin_new = (sign * Polygon_closest_distance_line(boundary, num_points, start_NE, end_NE) * 0.01f) - fence_margin;
@@ -551,7 +551,7 @@ bool AP_OABendyRuler::calc_margin_from_inclusion_and_exclusion_polygons(const Lo
         const Vector2f* boundary = fence->polyfence().get_exclusion_polygon(i, num_points);
    
         // if start is inside the polygon the margin's sign is reversed
-        const float sign = Polygon_outside(start_NE, boundary, num_points) ? 1.0f : -1.0f;
+        const float sign = fence->polyfence().get_exclusion_polygon_index(i)->outside(start_NE) ? 1.0f : -1.0f;
 
         // calculate min distance (in meters) from line to polygon
         float margin_new = (sign * Polygon_closest_distance_line(boundary, num_points, start_NE, end_NE) * 0.01f) - fence_margin;
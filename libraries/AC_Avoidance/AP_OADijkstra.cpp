@@ -530,12 +530,11 @@ bool AP_OADijkstra::intersects_fence(const Vector2f &seg_start, const Vector2f &
     }
 
     // determine if segment crosses any of the inclusion polygons
-    uint16_t num_points = 0;
     for (uint8_t i = 0; i < fence->polyfence().get_inclusion_polygon_count(); i++) {
-        const Vector2f* boundary = fence->polyfence().get_inclusion_polygon(i, num_points);
+        const AP_PolygonIndex *boundary = fence->polyfence().get_inclusion_polygon_index(i);
         if (boundary != nullptr) {
             Vector2f intersection;
-            if (Polygon_intersects(boundary, num_points, seg_start, seg_end, intersection)) {
+            if (boundary->intersects(seg_start, seg_end, intersection)) {
                 return true;
             }
         }
@@ -543,10 +542,10 @@ bool AP_OADijkstra::intersects_fence(const Vector2f &seg_start, const Vector2f &
 
     // determine if segment crosses any of the exclusion polygons
     for (uint8_t i = 0; i < fence->polyfence().get_exclusion_polygon_count(); i++) {
-        const Vector2f* boundary = fence->polyfence().get_exclusion_polygon(i, num_points);
+        const AP_PolygonIndex *boundary = fence->polyfence().get_exclusion_polygon_index(i);
         if (boundary != nullptr) {
             Vector2f intersection;
-            if (Polygon_intersects(boundary, num_points, seg_start, seg_end, intersection)) {
+            if (boundary->intersects(seg_start, seg_end, intersection)) {
                 return true;
             }
         }
@@ -212,7 +212,7 @@ bool AC_PolyFence_loader::breached(const Vector2f& pos_cm) const
     // check we are inside each inclusion zone:
     for (uint8_t i=0; i<_num_loaded_inclusion_boundaries; i++) {
         const InclusionBoundary &boundary = _loaded_inclusion_boundary[i];
-        if (Polygon_outside(pos_cm, boundary.points, boundary.count)) {
+        if (boundary.index.outside(pos_cm)) {
             return true;
         }
     }
@@ -220,7 +220,7 @@ bool AC_PolyFence_loader::breached(const Vector2f& pos_cm) const
     // check we are outside each exclusion zone:
     for (uint8_t i=0; i<_num_loaded_exclusion_boundaries; i++) {
         const ExclusionBoundary &boundary = _loaded_exclusion_boundary[i];
-        if (!Polygon_outside(pos_cm, boundary.points, boundary.count)) {
+        if (!boundary.index.outside(pos_cm)) {
             return true;
         }
     }
@@ -728,6 +728,8 @@ bool AC_PolyFence_loader::load_from_eeprom()
                 storage_valid = false;
                 break;
             }
+            // checks still work, more slowly, if this fails
+            boundary.index.init(boundary.points, boundary.count);
             _num_loaded_inclusion_boundaries++;
             break;
         }
@@ -746,6 +748,8 @@ bool AC_PolyFence_loader::load_from_eeprom()
                 storage_valid = false;
                 break;
             }
+            // checks still work, more slowly, if this fails
+            boundary.index.init(boundary.points, boundary.count);
             _num_loaded_exclusion_boundaries++;
             break;
         }
@@ -840,6 +844,22 @@ Vector2f* AC_PolyFence_loader::get_inclusion_polygon(uint16_t index, uint16_t &n
     return boundary.points;
 }
 
+const AP_PolygonIndex *AC_PolyFence_loader::get_exclusion_polygon_index(uint16_t index) const
+{
+    if (index >= _num_loaded_exclusion_boundaries) {
+        return nullptr;
+    }
+    return &_loaded_exclusion_boundary[index].index;
+}
+
+const AP_PolygonIndex *AC_PolyFence_loader::get_inclusion_polygon_index(uint16_t index) const
+{
+    if (index >= _num_loaded_inclusion_boundaries) {
+        return nullptr;
+    }
+    return &_loaded_inclusion_boundary[index].index;
+}
+
 /// returns the specified exclusion circle
 /// circle center offsets in cm from EKF origin in NE frame, radius is in meters
 bool AC_PolyFence_loader::get_exclusion_circle(uint8_t index, Vector2f &center_pos_cm, float &radius) const
@@ -59,6 +59,10 @@ public:
     /// points are offsets in cm from EKF origin in NE frame
     Vector2f* get_exclusion_polygon(uint16_t index, uint16_t &num_points) const;
 
+    // returns the edge index of the specified exclusion polygon, for
+    // faster point in polygon and intersection checks
+    const AP_PolygonIndex *get_exclusion_polygon_index(uint16_t index) const;
+
     /// return system time of last update to the exclusion polygon points
     uint32_t get_exclusion_polygon_update_ms() const {
         return _load_time_ms;
@@ -76,6 +80,10 @@ public:
     /// points are offsets in cm from EKF origin in NE frame
     Vector2f* get_inclusion_polygon(uint16_t index, uint16_t &num_points) const;
 
+    // returns the edge index of the specified inclusion polygon, for
+    // faster point in polygon and intersection checks
+    const AP_PolygonIndex *get_inclusion_polygon_index(uint16_t index) const;
+
     /// return system time of last update to the inclusion polygon points
     uint32_t get_inclusion_polygon_update_ms() const {
         return _load_time_ms;
@@ -255,6 +263,7 @@ private:
     public:
         Vector2f *points; // pointer into the _loaded_offsets_from_origin array
         uint8_t count; // count of points in the boundary
+        AP_PolygonIndex index; // bounding box and edges by band of the points
     };
     InclusionBoundary *_loaded_inclusion_boundary;
     uint8_t _num_loaded_inclusion_boundaries;
@@ -263,6 +272,7 @@ private:
     public:
         Vector2f *points; // pointer into the _loaded_offsets_from_origin array
         uint8_t count; // count of points in the boundary
+        AP_PolygonIndex index; // bounding box and edges by band of the points
     };
     ExclusionBoundary *_loaded_exclusion_boundary;
     uint8_t _num_loaded_exclusion_boundaries;
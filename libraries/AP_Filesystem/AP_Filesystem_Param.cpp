@@ -137,12 +137,7 @@ uint8_t AP_Filesystem_Param::pack_param(const struct rfile &r, struct cursor &c,
 
     if (c.token_ofs == 0) {
         c.idx = 0;
-        ap = AP_Param::first(&c.token, &ptype);
-        uint16_t idx = 0;
-        while (idx < r.start && ap) {
-            ap = AP_Param::next_scalar(&c.token, &ptype);
-            idx++;
-        }
+        ap = AP_Param::find_by_index(r.start, &ptype, &c.token);
     } else {
         c.idx++;
         ap = AP_Param::next_scalar(&c.token, &ptype);
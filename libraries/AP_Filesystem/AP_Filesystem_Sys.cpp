@@ -22,6 +22,7 @@
 #include <AP_Math/AP_Math.h>
 #include <AP_CANManager/AP_CANManager.h>
 #include <AP_Scheduler/AP_Scheduler.h>
+#include <AP_Scripting/AP_Scripting.h>
 
 extern const AP_HAL::HAL& hal;
 
@@ -54,6 +55,17 @@ int AP_Filesystem_Sys::open(const char *fname, int flags)
             r.data->length = hal.util->thread_info(r.data->data, max_size);
         }
     }
+    if (strcmp(fname, "storage.txt") == 0) {
+        const uint32_t max_size = 256;
+        r.data->data = (char *)malloc(max_size);
+        if (r.data->data) {
+            r.data->length = hal.storage->get_stats(r.data->data, max_size);
+            if (r.data->length == 0) { // not supported by this HAL
+                free(r.data->data);
+                r.data->data = nullptr;
+            }
+        }
+    }
     if (strcmp(fname, "tasks.txt") == 0) {
         const uint32_t max_size = 6144;
         r.data->data = (char *)malloc(max_size);
@@ -65,6 +77,22 @@ int AP_Filesystem_Sys::open(const char *fname, int flags)
             }
         }
     }
+#ifdef ENABLE_SCRIPTING
+    if (strcmp(fname, "scripts.txt") == 0) {
+        AP_Scripting *scripting = AP::scripting();
+        if (scripting != nullptr) {
+            const uint32_t max_size = 2048;
+            r.data->data = (char *)malloc(max_size);
+            if (r.data->data) {
+                r.data->length = scripting->script_stats(r.data->data, max_size);
+                if (r.data->length == 0) { // scripting may not be running
+                    free(r.data->data);
+                    r.data->data = nullptr;
+                }
+            }
+        }
+    }
+#endif
 #if HAL_MAX_CAN_PROTOCOL_DRIVERS
     int8_t can_stats_num = -1;
     if (strcmp(fname, "can_log.txt") == 0) {
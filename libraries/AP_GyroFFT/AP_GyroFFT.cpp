@@ -250,8 +250,9 @@ void AP_GyroFFT::init(uint32_t target_looptime_us)
     }
 
     // count the number of active harmonics
+    const uint8_t notch_harmonics = harmonic_notch().params().harmonics();
     for (uint8_t i = 0; i < HNF_MAX_HARMONICS; i++) {
-        if (_ins->get_gyro_harmonic_notch_harmonics() & (1<<i)) {
+        if (notch_harmonics & (1<<i)) {
             _harmonics++;
         }
     }
@@ -262,7 +263,7 @@ void AP_GyroFFT::init(uint32_t target_looptime_us)
     uint8_t first_harmonic = 0;
     if (_harmonic_fit > 0) {
         for (uint8_t i = 0; i < HNF_MAX_HARMONICS; i++) {
-            if (_ins->get_gyro_harmonic_notch_harmonics() & (1<<i)) {
+            if (notch_harmonics & (1<<i)) {
                 if (first_harmonic == 0) {
                     first_harmonic = i + 1;
                 } else {
@@ -280,7 +281,7 @@ void AP_GyroFFT::init(uint32_t target_looptime_us)
         return;
     }
 
-    // per-axis frame time
+    // frame time, each frame analyses all three axes
     _frame_time_ms = _samples_per_frame * 1000 / _fft_sampling_rate_hz;
     // The update rate for the output, defaults are 1Khz / (1 - 0.5) * 32 == 62hz
     const float output_rate = _fft_sampling_rate_hz / _samples_per_frame;
@@ -392,7 +393,7 @@ uint16_t AP_GyroFFT::run_cycle()
 
     // do we have enough samples for another pass?
     if (!start_analysis()) {
-        uint16_t new_sample_count =  get_available_samples(_update_axis);
+        uint16_t new_sample_count = get_available_samples();
         _sem.give();
         return new_sample_count;
     }
@@ -404,37 +405,45 @@ uint16_t AP_GyroFFT::run_cycle()
 
     uint32_t now = AP_HAL::micros();
 
-    // get the appropriate gyro buffer
-    FloatBuffer& gyro_buffer = (_sample_mode == 0 ?_ins->get_raw_gyro_window(_update_axis) : _downsampled_gyro_data[_update_axis]);
-    // if we have many more samples than the window size then we are struggling to 
-    // stay ahead of the gyro loop so drop samples so that this cycle will use all available samples
-    if (gyro_buffer.available() > uint32_t(_state->_window_size + uint16_t(_samples_per_frame >> 1))) { // half the frame size is a heuristic
-        gyro_buffer.advance(gyro_buffer.available() - _state->_window_size);
+    // if we have many more samples than the window size then we are struggling to
+    // stay ahead of the gyro loop so drop samples so that this frame will use all available samples.
+    // all axes are trimmed before any are analysed so that the three windows cover the same samples
+    for (uint8_t axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        FloatBuffer& gyro_buffer = get_gyro_buffer(axis);
+        if (gyro_buffer.available() > uint32_t(_state->_window_size + uint16_t(_samples_per_frame >> 1))) { // half the frame size is a heuristic
+            gyro_buffer.advance(gyro_buffer.available() - _state->_window_size);
+        }
     }
-    // let's go!
-    hal.dsp->fft_start(_state, gyro_buffer, _samples_per_frame);
 
-    // calculate FFT and update filters outside the semaphore
-    uint16_t bin_max = hal.dsp->fft_analyse(_state, config._fft_start_bin, config._fft_end_bin, config._attenuation_cutoff);
+    // analyse all three axes as one frame. The gyro buffers hold the window being analysed followed
+    // by the samples collected for the next frame. New samples are only ever appended, so each
+    // window stays fixed while earlier axes are analysed and collection carries on in parallel
+    for (uint8_t axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        _update_axis = axis;
 
-    // something has been detected, update the peak frequency and associated metrics
-    update_ref_energy(bin_max);
-    calculate_noise(false, config);
+        // let's go!
+        hal.dsp->fft_start(_state, get_gyro_buffer(axis), _samples_per_frame);
 
-    // record how we are doing
-    _thread_state._last_output_us[_update_axis] = AP_HAL::micros();
-    _output_cycle_micros = _thread_state._last_output_us[_update_axis] - now;
+        // calculate FFT and update filters outside the semaphore
+        uint16_t bin_max = hal.dsp->fft_analyse(_state, config._fft_start_bin, config._fft_end_bin, config._attenuation_cutoff);
+
+        // something has been detected, update the peak frequency and associated metrics
+        update_ref_energy(bin_max);
+        calculate_noise(false, config);
 
-    // move onto the next axis
-    _update_axis = (_update_axis + 1) % XYZ_AXIS_COUNT;
+        _thread_state._last_output_us[axis] = AP_HAL::micros();
+    }
+
+    // record how we are doing
+    _output_cycle_micros = AP_HAL::micros() - now;
 
     // ready to receive another frame, because lock contention is so expensive we don't lock
     // around this flag but rather rely on the semaphore at the beginning of the loop to
     // ensure eventual visibility to the main loop
     _thread_state._analysis_started = false;
 
-    // samples remaining in the next axis
-    return get_available_samples(_update_axis);
+    // samples available for the next frame
+    return get_available_samples();
 }
 
 // whether analysis can be run again or not
@@ -448,13 +457,23 @@ bool AP_GyroFFT::start_analysis() {
         return false;
     }
 
-    if (get_available_samples(_update_axis) >= _state->_window_size) {
+    if (get_available_samples() >= _state->_window_size) {
         _thread_state._analysis_started = true;
         return true;
     }
     return false;
 }
 
+// return samples available in the gyro windows, the least across all axes
+uint16_t AP_GyroFFT::get_available_samples()
+{
+    uint16_t samples = get_gyro_buffer(0).available();
+    for (uint8_t axis = 1; axis < XYZ_AXIS_COUNT; axis++) {
+        samples = MIN(samples, get_gyro_buffer(axis).available());
+    }
+    return samples;
+}
+
 // update calculated values of dynamic parameters - runs at 1Hz
 void AP_GyroFFT::update_parameters()
 {
@@ -773,7 +792,21 @@ float AP_GyroFFT::calculate_weighted_freq_hz(const Vector3f& energy, const Vecto
 // @Field: FtY: harmonic fit on pitch of the highest noise peak to the second highest noise peak
 // @Field: FtZ: harmonic fit on yaw of the highest noise peak to the second highest noise peak
 // @Field: FH: FFT health
-// @Field: Tc: FFT cycle time
+// @Field: Tc: FFT frame time, covering all three axes
+
+/*
+  the harmonic notch tracking the FFT, its harmonics decide which peaks
+  are tracked. Use the first harmonic notch if none are
+ */
+const AP_InertialSensor::HarmonicNotch& AP_GyroFFT::harmonic_notch() const
+{
+    for (const auto &notch : _ins->harmonic_notches) {
+        if (notch.enabled() && notch.params().tracking_mode() == HarmonicNotchDynamicMode::UpdateGyroFFT) {
+            return notch;
+        }
+    }
+    return _ins->harmonic_notches[0];
+}
 
 // log gyro fft messages
 void AP_GyroFFT::write_log_messages()
@@ -793,7 +826,7 @@ void AP_GyroFFT::write_log_messages()
         AP_HAL::micros64(),
         get_weighted_noise_center_freq_hz(),
         get_weighted_noise_center_bandwidth_hz(),
-        _ins->get_gyro_dynamic_notch_center_freq_hz(),
+        harmonic_notch().calculated_freq_hz(),
         get_noise_signal_to_noise_db().x,
         get_noise_signal_to_noise_db().y,
         get_noise_signal_to_noise_db().z,
@@ -802,7 +835,7 @@ void AP_GyroFFT::write_log_messages()
         get_raw_noise_harmonic_fit().z,
         _health, _output_cycle_micros);
 
-    const float* notches = _ins->get_gyro_dynamic_notch_center_frequencies_hz();
+    const float* notches = harmonic_notch().calculated_frequencies_hz();
 
     log_noise_peak(0, FrequencyPeak::CENTER, notches[0]);
     if (_harmonics > 1) {
@@ -177,6 +177,8 @@ private:
     }
     // write single log mesages
     void log_noise_peak(uint8_t id, FrequencyPeak peak, float notch_freq);
+    // the harmonic notch tracking the FFT, the first one if none are
+    const AP_InertialSensor::HarmonicNotch& harmonic_notch() const;
     // calculate the peak noise frequency
     void calculate_noise(bool calibrating, const EngineConfig& config);
     // calculate noise peaks based on energy and history
@@ -203,10 +205,12 @@ private:
     bool analysis_enabled() const { return _initialized && _analysis_enabled && _thread_created; };
     // whether analysis can be run again or not
     bool start_analysis();
-    // return samples available in the gyro window
-    uint16_t get_available_samples(uint8_t axis) {
-        return _sample_mode == 0 ?_ins->get_raw_gyro_window(axis).available() : _downsampled_gyro_data[axis].available();
+    // return the gyro window for an axis
+    FloatBuffer& get_gyro_buffer(uint8_t axis) {
+        return _sample_mode == 0 ? _ins->get_raw_gyro_window(axis) : _downsampled_gyro_data[axis];
     }
+    // return samples available in the gyro windows of all axes
+    uint16_t get_available_samples();
     // semaphore for access to shared FFT data
     HAL_Semaphore _sem;
 
@@ -265,7 +269,7 @@ private:
 
     // state of the FFT engine
     AP_HAL::DSP::FFTWindowState* _state;
-    // update state machine step information
+    // axis currently being analysed within a frame
     uint8_t _update_axis;
     // noise base of the gyros
     Vector3f* _ref_energy;
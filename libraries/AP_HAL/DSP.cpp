@@ -21,6 +21,15 @@
 
 #if HAL_WITH_DSP
 
+#include <cmath>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define DSP_USE_NEON 1
+#else
+#define DSP_USE_NEON 0
+#endif
+
 using namespace AP_HAL;
 
 extern const AP_HAL::HAL &hal;
@@ -56,6 +65,7 @@ DSP::FFTWindowState::FFTWindowState(uint16_t window_size, uint16_t sample_rate,
 
     // create the Hanning window
     // https://holometer.fnal.gov/GH_FFT.pdf - equation 19
+    _window_scale = 0.0f;
     for (uint16_t i = 0; i < window_size; i++) {
         _hanning_window[i] = (0.5f - 0.5f * cosf(2.0f * M_PI * i / ((float)window_size - 1)));
         _window_scale += _hanning_window[i];
@@ -76,6 +86,146 @@ DSP::FFTWindowState::~FFTWindowState()
     _rfft_data = nullptr;
 }
 
+// The real FFT of N samples is calculated as an N/2 point complex FFT followed by a split step, see
+// https://www.dsprelated.com/showarticle/800.php "Computing an FFT of Complex-Valued Data Using a Real Only FFT Algorithm"
+DSP::RealFFT::RealFFT(uint16_t window_size, bool positive_exponent)
+    : _n(window_size / 2)
+{
+    _twiddle = new float[2 * _n];
+    _split_twiddle = new float[_n + 2];
+    _bitrev = new uint16_t[_n];
+    if (!valid()) {
+        return;
+    }
+
+    const double sign = positive_exponent ? 1.0 : -1.0;
+
+    // per-stage twiddles so that every butterfly stage reads them sequentially
+    for (uint16_t h = 1; h < _n; h <<= 1) {
+        for (uint16_t j = 0; j < h; j++) {
+            const double angle = sign * M_PI * j / h;
+            _twiddle[2 * (h - 1 + j)] = cos(angle);
+            _twiddle[2 * (h - 1 + j) + 1] = sin(angle);
+        }
+    }
+
+    for (uint16_t k = 0; k <= _n / 2; k++) {
+        const double angle = sign * 2.0 * M_PI * k / window_size;
+        _split_twiddle[2 * k] = cos(angle);
+        _split_twiddle[2 * k + 1] = sin(angle);
+    }
+
+    uint16_t bits = 0;
+    while ((1U << bits) < _n) {
+        bits++;
+    }
+    for (uint16_t i = 0; i < _n; i++) {
+        uint16_t r = 0;
+        for (uint16_t b = 0; b < bits; b++) {
+            r |= ((i >> b) & 1U) << (bits - 1 - b);
+        }
+        _bitrev[i] = r;
+    }
+}
+
+DSP::RealFFT::~RealFFT()
+{
+    delete[] _twiddle;
+    delete[] _split_twiddle;
+    delete[] _bitrev;
+}
+
+void DSP::RealFFT::calculate(float* data, float* out) const
+{
+    cfft(data);
+    split(data, out);
+}
+
+// in-place radix-2 FFT of the samples viewed as N/2 interleaved complex values
+void DSP::RealFFT::cfft(float* z) const
+{
+    const uint16_t n = _n;
+
+    for (uint16_t i = 0; i < n; i++) {
+        const uint16_t j = _bitrev[i];
+        if (j > i) {
+            const float re = z[2 * i];
+            const float im = z[2 * i + 1];
+            z[2 * i] = z[2 * j];
+            z[2 * i + 1] = z[2 * j + 1];
+            z[2 * j] = re;
+            z[2 * j + 1] = im;
+        }
+    }
+
+    for (uint16_t h = 1; h < n; h <<= 1) {
+        const float* w = &_twiddle[2 * (h - 1)];
+        for (uint16_t base = 0; base < n; base += 2 * h) {
+            float* a = &z[2 * base];
+            float* b = &z[2 * (base + h)];
+            uint16_t j = 0;
+#if DSP_USE_NEON
+            for (; j + 4 <= h; j += 4) {
+                const float32x4x2_t va = vld2q_f32(&a[2 * j]);
+                const float32x4x2_t vb = vld2q_f32(&b[2 * j]);
+                const float32x4x2_t vw = vld2q_f32(&w[2 * j]);
+                const float32x4_t tr = vmlsq_f32(vmulq_f32(vw.val[0], vb.val[0]), vw.val[1], vb.val[1]);
+                const float32x4_t ti = vmlaq_f32(vmulq_f32(vw.val[0], vb.val[1]), vw.val[1], vb.val[0]);
+                float32x4x2_t outa, outb;
+                outa.val[0] = vaddq_f32(va.val[0], tr);
+                outa.val[1] = vaddq_f32(va.val[1], ti);
+                outb.val[0] = vsubq_f32(va.val[0], tr);
+                outb.val[1] = vsubq_f32(va.val[1], ti);
+                vst2q_f32(&a[2 * j], outa);
+                vst2q_f32(&b[2 * j], outb);
+            }
+#endif
+            for (; j < h; j++) {
+                const float wr = w[2 * j];
+                const float wi = w[2 * j + 1];
+                const float tr = wr * b[2 * j] - wi * b[2 * j + 1];
+                const float ti = wr * b[2 * j + 1] + wi * b[2 * j];
+                b[2 * j] = a[2 * j] - tr;
+                b[2 * j + 1] = a[2 * j + 1] - ti;
+                a[2 * j] += tr;
+                a[2 * j + 1] += ti;
+            }
+        }
+    }
+}
+
+// convert the half length complex FFT into the N/2+1 bins of the real FFT
+void DSP::RealFFT::split(const float* z, float* x) const
+{
+    const uint16_t n = _n;
+
+    // DC and Nyquist components are real only
+    x[0] = z[0] + z[1];
+    x[1] = 0.0f;
+    x[2 * n] = z[0] - z[1];
+    x[2 * n + 1] = 0.0f;
+
+    for (uint16_t k = 1; k <= n / 2; k++) {
+        // even samples from Z[k] + conj(Z[n-k]), odd samples from Z[k] - conj(Z[n-k])
+        const float zr = z[2 * k];
+        const float zi = z[2 * k + 1];
+        const float cr = z[2 * (n - k)];
+        const float ci = -z[2 * (n - k) + 1];
+        const float even_r = 0.5f * (zr + cr);
+        const float even_i = 0.5f * (zi + ci);
+        const float odd_r = 0.5f * (zi - ci);
+        const float odd_i = -0.5f * (zr - cr);
+        const float wr = _split_twiddle[2 * k];
+        const float wi = _split_twiddle[2 * k + 1];
+        const float tr = wr * odd_r - wi * odd_i;
+        const float ti = wr * odd_i + wi * odd_r;
+        x[2 * k] = even_r + tr;
+        x[2 * k + 1] = even_i + ti;
+        x[2 * (n - k)] = even_r - tr;
+        x[2 * (n - k) + 1] = ti - even_i;
+    }
+}
+
 // step 3: find the magnitudes of the complex data
 void DSP::step_cmplx_mag(FFTWindowState* fft, uint16_t start_bin, uint16_t end_bin, float noise_att_cutoff)
 {
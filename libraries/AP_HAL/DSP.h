@@ -73,6 +73,41 @@ public:
         virtual ~FFTWindowState();
         FFTWindowState(uint16_t window_size, uint16_t sample_rate, uint8_t harmonics);
     };
+
+    // real FFT of window_size samples, calculated as a complex FFT of
+    // half the length followed by a split step. Used by the HALs that
+    // have no FFT library of their own
+    class RealFFT {
+    public:
+        // the exponent is negative for the usual forward transform
+        RealFFT(uint16_t window_size, bool positive_exponent);
+        ~RealFFT();
+
+        /* Do not allow copies */
+        RealFFT(const RealFFT &other) = delete;
+        RealFFT &operator=(const RealFFT&) = delete;
+
+        // true if the tables were allocated
+        bool valid() const { return _twiddle != nullptr && _split_twiddle != nullptr && _bitrev != nullptr; }
+
+        // transform the window_size real samples in data, which is used as
+        // scratch space, into the window_size/2+1 interleaved complex bins in out
+        void calculate(float* data, float* out) const;
+
+    private:
+        void cfft(float* z) const;
+        void split(const float* z, float* x) const;
+
+        // length of the complex FFT
+        const uint16_t _n;
+        // twiddle factors for every butterfly stage of the half length FFT,
+        // interleaved real/imaginary, stage with span h starts at element h-1
+        float* _twiddle;
+        // twiddle factors used to split the half length FFT into the real FFT
+        float* _split_twiddle;
+        // bit reversed index of each element of the half length FFT
+        uint16_t* _bitrev;
+    };
     // initialise an FFT instance
     virtual FFTWindowState* fft_init(uint16_t window_size, uint16_t sample_rate, uint8_t harmonics) = 0;
     // start an FFT analysis with an ObjectBuffer
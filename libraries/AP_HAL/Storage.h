@@ -11,4 +11,7 @@ public:
     virtual void write_block(uint16_t dst, const void* src, size_t n) = 0;
     virtual void _timer_tick(void) {};
     virtual bool healthy(void) { return true; }
+
+    // get text description of the write statistics
+    virtual uint32_t get_stats(char* data, uint32_t max_size) { return 0; }
 };
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+/*
+  wait-free single producer, single consumer handoff of the latest
+  value of an object. The producer fills in back() and calls
+  publish(), the consumer calls update() and reads front(). Neither
+  side ever blocks or spins, and the consumer always sees a complete
+  object. Intermediate values are dropped if the producer publishes
+  faster than the consumer updates, so this is for state, not streams
+  (use ObjectBuffer for those).
+ */
+template <class T>
+class TripleBuffer {
+public:
+    TripleBuffer(void) {}
+
+    // producer: object to fill in before publish(). It holds whatever
+    // was published two calls ago, so must be completely rewritten
+    // unless the producer only ever modifies it in place
+    T &back(void) { return buffer[back_idx]; }
+
+    // producer: make back() available to the consumer
+    void publish(void) {
+        back_idx = middle.exchange(back_idx | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // consumer: true if the producer has published since the last update()
+    bool fresh(void) const {
+        return (middle.load(std::memory_order_acquire) & FRESH) != 0;
+    }
+
+    // consumer: switch front() to the latest published object. Returns
+    // false, leaving front() unchanged, if nothing new was published
+    bool update(void) {
+        if (!fresh()) {
+            return false;
+        }
+        front_idx = middle.exchange(front_idx, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    // consumer: object made current by the last successful update()
+    const T &front(void) const { return buffer[front_idx]; }
+
+private:
+    static const uint8_t INDEX_MASK = 0x03;
+    static const uint8_t FRESH = 0x04;
+
+    T buffer[3] {};
+    uint8_t back_idx = 0;
+    uint8_t front_idx = 1;
+    // index of the buffer between the two sides, with FRESH set if the
+    // producer has published into it since the consumer last took it
+    std::atomic<uint8_t> middle{2};
+};
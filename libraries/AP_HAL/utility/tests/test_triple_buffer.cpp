@@ -0,0 +1,95 @@
+/*
+ * This file is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <AP_gtest.h>
+
+#include <thread>
+#include <AP_HAL/utility/TripleBuffer.h>
+
+TEST(TripleBufferTest, NothingPublished)
+{
+    TripleBuffer<int> tb;
+
+    EXPECT_FALSE(tb.fresh());
+    EXPECT_FALSE(tb.update());
+    EXPECT_EQ(tb.front(), 0);
+}
+
+TEST(TripleBufferTest, LatestWins)
+{
+    TripleBuffer<int> tb;
+
+    tb.back() = 1;
+    tb.publish();
+    EXPECT_TRUE(tb.fresh());
+    tb.back() = 2;
+    tb.publish();
+
+    EXPECT_TRUE(tb.update());
+    EXPECT_EQ(tb.front(), 2);
+    EXPECT_FALSE(tb.fresh());
+
+    // front stays valid until the next successful update
+    EXPECT_FALSE(tb.update());
+    EXPECT_EQ(tb.front(), 2);
+
+    tb.back() = 3;
+    tb.publish();
+    EXPECT_EQ(tb.front(), 2);
+    EXPECT_TRUE(tb.update());
+    EXPECT_EQ(tb.front(), 3);
+}
+
+struct TornCheck {
+    uint32_t a;
+    uint32_t b[15];
+};
+
+TEST(TripleBufferTest, NoTornReads)
+{
+    TripleBuffer<TornCheck> tb;
+    const uint32_t count = 200000;
+
+    std::thread producer([&tb, count]() {
+        for (uint32_t i = 1; i <= count; i++) {
+            TornCheck &t = tb.back();
+            t.a = i;
+            for (uint8_t j = 0; j < 15; j++) {
+                t.b[j] = i;
+            }
+            tb.publish();
+        }
+    });
+
+    uint32_t last = 0;
+    bool ok = true;
+    while (ok && last < count) {
+        if (!tb.update()) {
+            continue;
+        }
+        const TornCheck &t = tb.front();
+        for (uint8_t j = 0; j < 15; j++) {
+            ok &= (t.b[j] == t.a);
+        }
+        // values never go backwards
+        ok &= (t.a > last);
+        last = t.a;
+    }
+
+    producer.join();
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(last, count);
+}
+
+AP_GTEST_MAIN()
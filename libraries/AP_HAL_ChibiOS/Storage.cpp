@@ -219,7 +219,10 @@ void Storage::_mark_dirty(uint16_t loc, uint16_t length)
     for (uint16_t line=loc>>CH_STORAGE_LINE_SHIFT;
          line <= end>>CH_STORAGE_LINE_SHIFT;
          line++) {
-        _dirty_mask.set(line);
+        if (!_dirty_mask.get(line)) {
+            _dirty_mask.set(line);
+            _stats.lines_dirtied++;
+        }
     }
 }
 
@@ -242,6 +245,7 @@ void Storage::write_block(uint16_t loc, const void *src, size_t n)
         WITH_SEMAPHORE(sem);
         memcpy(&_buffer[loc], src, n);
         _mark_dirty(loc, n);
+        _stats.bytes_changed += n;
     }
 }
 
@@ -255,8 +259,13 @@ void Storage::_timer_tick(void)
         return;
     }
 
-    // write out the first dirty line. We don't write more
-    // than one to keep the latency of this call to a minimum
+    if (AP_HAL::millis() - _last_empty_ms < CH_STORAGE_COALESCE_MS) {
+        // give changes made together time to arrive
+        return;
+    }
+
+    // write out the first run of dirty lines. We don't write more
+    // than one run to keep the latency of this call to a minimum
     uint16_t i;
     for (i=0; i<CH_STORAGE_NUM_LINES; i++) {
         if (_dirty_mask.get(i)) {
@@ -267,18 +276,26 @@ void Storage::_timer_tick(void)
         // this shouldn't be possible
         return;
     }
+    uint16_t n;
+    for (n=1; n < CH_STORAGE_MAX_WRITE_LINES && i+n < CH_STORAGE_NUM_LINES; n++) {
+        if (!_dirty_mask.get(i+n)) {
+            break;
+        }
+    }
+    const uint32_t offset = CH_STORAGE_LINE_SIZE*i;
+    const uint16_t length = CH_STORAGE_LINE_SIZE*n;
 
     {
-        // take a copy of the line we are writing with a semaphore held
+        // take a copy of the lines we are writing with a semaphore held
         WITH_SEMAPHORE(sem);
-        memcpy(tmpline, &_buffer[CH_STORAGE_LINE_SIZE*i], CH_STORAGE_LINE_SIZE);
+        memcpy(tmplines, &_buffer[offset], length);
     }
 
     bool write_ok = false;
 
 #if HAL_WITH_RAMTRON
     if (_initialisedType == StorageBackend::FRAM) {
-        if (fram.write(CH_STORAGE_LINE_SIZE*i, tmpline, CH_STORAGE_LINE_SIZE)) {
+        if (fram.write(offset, tmplines, length)) {
             write_ok = true;
         }
     }
@@ -286,11 +303,10 @@ void Storage::_timer_tick(void)
 
 #ifdef USE_POSIX
     if ((_initialisedType == StorageBackend::SDCard) && log_fd != -1) {
-        uint32_t offset = CH_STORAGE_LINE_SIZE*i;
         if (AP::FS().lseek(log_fd, offset, SEEK_SET) != offset) {
             return;
         }
-        if (AP::FS().write(log_fd, &_buffer[offset], CH_STORAGE_LINE_SIZE) != CH_STORAGE_LINE_SIZE) {
+        if (AP::FS().write(log_fd, tmplines, length) != length) {
             return;
         }
         if (AP::FS().fsync(log_fd) != 0) {
@@ -303,7 +319,7 @@ void Storage::_timer_tick(void)
 #ifdef STORAGE_FLASH_PAGE
     if (_initialisedType == StorageBackend::Flash) {
         // save to storage backend
-        if (_flash_write(i)) {
+        if (_flash_write(i, n)) {
             write_ok = true;
         }
     }
@@ -311,15 +327,19 @@ void Storage::_timer_tick(void)
 
     if (write_ok) {
         WITH_SEMAPHORE(sem);
-        // while holding the semaphore we check if the copy of the
+        // while holding the semaphore we check if the copy of each
         // line is different from the original line. If it is
         // different then someone has re-dirtied the line while we
         // were writing it, in which case we should not mark it
         // clean. If it matches then we know we can mark the line as
         // clean
-        if (memcmp(tmpline, &_buffer[CH_STORAGE_LINE_SIZE*i], CH_STORAGE_LINE_SIZE) == 0) {
-            _dirty_mask.clear(i);
+        for (uint16_t j=0; j<n; j++) {
+            if (memcmp(&tmplines[CH_STORAGE_LINE_SIZE*j], &_buffer[offset+CH_STORAGE_LINE_SIZE*j], CH_STORAGE_LINE_SIZE) == 0) {
+                _dirty_mask.clear(i+j);
+            }
         }
+        _stats.lines_written += n;
+        _stats.writes++;
     }
 }
 
@@ -342,12 +362,12 @@ void Storage::_flash_load(void)
 }
 
 /*
-  write one storage line. This also updates _dirty_mask.
+  write a run of storage lines
 */
-bool Storage::_flash_write(uint16_t line)
+bool Storage::_flash_write(uint16_t line, uint16_t nlines)
 {
 #ifdef STORAGE_FLASH_PAGE
-    return _flash.write(line*CH_STORAGE_LINE_SIZE, CH_STORAGE_LINE_SIZE);
+    return _flash.write(line*CH_STORAGE_LINE_SIZE, nlines*CH_STORAGE_LINE_SIZE);
 #else
     return false;
 #endif
@@ -447,6 +467,32 @@ bool Storage::healthy(void)
             (AP_HAL::millis() - _last_empty_ms < 2000u));
 }
 
+/*
+  get write statistics. Write amplification is the ratio of bytes
+  written to the backend to bytes changed, in percent
+ */
+uint32_t Storage::get_stats(char* data, uint32_t max_size)
+{
+    if (data == nullptr) {
+        return 0;
+    }
+    WITH_SEMAPHORE(sem);
+    const uint32_t bytes_written = _stats.lines_written * CH_STORAGE_LINE_SIZE;
+    return snprintf(data, max_size,
+                    "bytes_changed:  %lu\n"
+                    "lines_dirtied:  %lu\n"
+                    "lines_written:  %lu\n"
+                    "lines_dirty:    %u\n"
+                    "writes:         %lu\n"
+                    "amplification:  %lu%%\n",
+                    (unsigned long)_stats.bytes_changed,
+                    (unsigned long)_stats.lines_dirtied,
+                    (unsigned long)_stats.lines_written,
+                    (unsigned)_dirty_mask.count(),
+                    (unsigned long)_stats.writes,
+                    (unsigned long)(_stats.bytes_changed ? (100ULL * bytes_written) / _stats.bytes_changed : 0));
+}
+
 /*
   erase all storage
  */
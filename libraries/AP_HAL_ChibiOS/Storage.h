@@ -34,6 +34,17 @@
 #define CH_STORAGE_LINE_SIZE (1<<CH_STORAGE_LINE_SHIFT)
 #define CH_STORAGE_NUM_LINES (CH_STORAGE_SIZE/CH_STORAGE_LINE_SIZE)
 
+// consecutive dirty lines are written together, up to this many
+// bytes. This matches the largest write of AP_FlashStorage
+#define CH_STORAGE_MAX_WRITE 64
+#define CH_STORAGE_MAX_WRITE_LINES (CH_STORAGE_MAX_WRITE/CH_STORAGE_LINE_SIZE)
+
+// wait this long after the first change before writing, so that
+// changes made together are written together
+#ifndef CH_STORAGE_COALESCE_MS
+#define CH_STORAGE_COALESCE_MS 50
+#endif
+
 static_assert(CH_STORAGE_SIZE % CH_STORAGE_LINE_SIZE == 0,
               "Storage is not multiple of line size");
 
@@ -46,6 +57,7 @@ public:
 
     void _timer_tick(void) override;
     bool healthy(void) override;
+    uint32_t get_stats(char* data, uint32_t max_size) override;
 
 private:
     enum class StorageBackend: uint8_t {
@@ -62,7 +74,14 @@ private:
     uint8_t _buffer[CH_STORAGE_SIZE] __attribute__((aligned(4)));
     Bitmask<CH_STORAGE_NUM_LINES> _dirty_mask;
     HAL_Semaphore sem;
-    uint8_t tmpline[CH_STORAGE_LINE_SIZE];
+    uint8_t tmplines[CH_STORAGE_MAX_WRITE];
+
+    struct {
+        uint32_t bytes_changed;  // bytes changed by write_block()
+        uint32_t lines_dirtied;  // clean lines made dirty
+        uint32_t lines_written;  // lines written to the backend
+        uint32_t writes;         // backend writes
+    } _stats;
 
     bool _flash_write_data(uint8_t sector, uint32_t offset, const uint8_t *data, uint16_t length);
     bool _flash_read_data(uint8_t sector, uint32_t offset, uint8_t *data, uint16_t length);
@@ -83,7 +102,7 @@ private:
 #endif
 
     void _flash_load(void);
-    bool _flash_write(uint16_t line);
+    bool _flash_write(uint16_t line, uint16_t nlines);
 
 #if HAL_WITH_RAMTRON
     AP_RAMTRON fram;
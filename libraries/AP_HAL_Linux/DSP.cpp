@@ -0,0 +1,207 @@
+/*
+ * This file is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <AP_HAL/AP_HAL.h>
+
+#if HAL_WITH_DSP
+
+#include <AP_Math/AP_Math.h>
+#include <GCS_MAVLink/GCS.h>
+#include "DSP.h"
+#include <cmath>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define DSP_USE_NEON 1
+#else
+#define DSP_USE_NEON 0
+#endif
+
+using namespace Linux;
+
+extern const AP_HAL::HAL& hal;
+
+// The windowing, peak finding and frequency estimation follow the ChibiOS and SITL implementations, see
+// https://holometer.fnal.gov/GH_FFT.pdf - Heinzel et. al, referred to as [Heinz] throughout the code.
+
+#if DSP_USE_NEON
+// horizontal max and sum, usable on both armv7 and aarch64
+static inline float neon_hmax(float32x4_t v)
+{
+    float32x2_t m = vpmax_f32(vget_low_f32(v), vget_high_f32(v));
+    m = vpmax_f32(m, m);
+    return vget_lane_f32(m, 0);
+}
+
+static inline float neon_hsum(float32x4_t v)
+{
+    float32x2_t s = vpadd_f32(vget_low_f32(v), vget_high_f32(v));
+    s = vpadd_f32(s, s);
+    return vget_lane_f32(s, 0);
+}
+#endif
+
+// initialize the FFT state machine
+AP_HAL::DSP::FFTWindowState* DSP::fft_init(uint16_t window_size, uint16_t sample_rate, uint8_t harmonics)
+{
+    DSP::FFTWindowStateLinux* fft = new DSP::FFTWindowStateLinux(window_size, sample_rate, harmonics);
+    if (fft == nullptr || fft->_hanning_window == nullptr || fft->_rfft_data == nullptr || fft->_freq_bins == nullptr || fft->_derivative_freq_bins == nullptr
+        || !fft->_rfft.valid()) {
+        delete fft;
+        return nullptr;
+    }
+    return fft;
+}
+
+// start an FFT analysis
+void DSP::fft_start(AP_HAL::DSP::FFTWindowState* state, FloatBuffer& samples, uint16_t advance)
+{
+    step_hanning((FFTWindowStateLinux*)state, samples, advance);
+}
+
+// perform remaining steps of an FFT analysis
+uint16_t DSP::fft_analyse(AP_HAL::DSP::FFTWindowState* state, uint16_t start_bin, uint16_t end_bin, float noise_att_cutoff)
+{
+    FFTWindowStateLinux* fft = (FFTWindowStateLinux*)state;
+    fft->_rfft.calculate(fft->_freq_bins, fft->_rfft_data);
+    step_cmplx_mag_squared(fft);
+    step_cmplx_mag(fft, start_bin, end_bin, noise_att_cutoff);
+    return step_calc_frequencies(fft, start_bin, end_bin);
+}
+
+// create an instance of the FFT state machine
+DSP::FFTWindowStateLinux::FFTWindowStateLinux(uint16_t window_size, uint16_t sample_rate, uint8_t harmonics)
+    : AP_HAL::DSP::FFTWindowState::FFTWindowState(window_size, sample_rate, harmonics),
+      _rfft(window_size, false)
+{
+    if (_freq_bins == nullptr || _hanning_window == nullptr || _rfft_data == nullptr || _derivative_freq_bins == nullptr) {
+        GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "Failed to allocate window for DSP");
+        return;
+    }
+    if (!_rfft.valid()) {
+        GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "Failed to allocate tables for DSP");
+    }
+}
+
+// step 1: filter the incoming samples through a Hanning window
+void DSP::step_hanning(FFTWindowStateLinux* fft, FloatBuffer& samples, uint16_t advance)
+{
+    // apply hanning window to gyro samples and store result in _freq_bins
+    samples.peek(&fft->_freq_bins[0], fft->_window_size); // the caller ensures we get a full buffer of samples
+    samples.advance(advance);
+    mult_f32(&fft->_freq_bins[0], &fft->_hanning_window[0], &fft->_freq_bins[0], fft->_window_size);
+}
+
+// step 3: calculate the power in each bin, including the Nyquist bin
+void DSP::step_cmplx_mag_squared(FFTWindowStateLinux* fft)
+{
+    const float* x = fft->_rfft_data;
+    float* mag = fft->_freq_bins;
+    const uint16_t bins = fft->_bin_count + 1;
+    uint16_t k = 0;
+#if DSP_USE_NEON
+    for (; k + 4 <= bins; k += 4) {
+        const float32x4x2_t v = vld2q_f32(&x[2 * k]);
+        vst1q_f32(&mag[k], vmlaq_f32(vmulq_f32(v.val[0], v.val[0]), v.val[1], v.val[1]));
+    }
+#endif
+    for (; k < bins; k++) {
+        mag[k] = sq(x[2 * k]) + sq(x[2 * k + 1]);
+    }
+}
+
+void DSP::mult_f32(const float* v1, const float* v2, float* vout, uint16_t len) const
+{
+    uint16_t i = 0;
+#if DSP_USE_NEON
+    for (; i + 4 <= len; i += 4) {
+        vst1q_f32(&vout[i], vmulq_f32(vld1q_f32(&v1[i]), vld1q_f32(&v2[i])));
+    }
+#endif
+    for (; i < len; i++) {
+        vout[i] = v1[i] * v2[i];
+    }
+}
+
+void DSP::vector_max_float(const float* vin, uint16_t len, float* max_value, uint16_t* max_index) const
+{
+    uint16_t i = 1;
+    float value = vin[0];
+#if DSP_USE_NEON
+    if (len >= 4) {
+        // find the maximum value, then the first index holding it
+        float32x4_t vmax = vld1q_f32(&vin[0]);
+        for (i = 4; i + 4 <= len; i += 4) {
+            vmax = vmaxq_f32(vmax, vld1q_f32(&vin[i]));
+        }
+        value = neon_hmax(vmax);
+        for (; i < len; i++) {
+            if (vin[i] > value) {
+                value = vin[i];
+            }
+        }
+        for (uint16_t j = 0; j < len; j++) {
+            if (vin[j] == value) {
+                *max_value = value;
+                *max_index = j;
+                return;
+            }
+        }
+        i = 1;
+        value = vin[0];
+    }
+#endif
+    uint16_t index = 0;
+    for (; i < len; i++) {
+        if (vin[i] > value) {
+            value = vin[i];
+            index = i;
+        }
+    }
+    *max_value = value;
+    *max_index = index;
+}
+
+void DSP::vector_scale_float(const float* vin, float scale, float* vout, uint16_t len) const
+{
+    uint16_t i = 0;
+#if DSP_USE_NEON
+    for (; i + 4 <= len; i += 4) {
+        vst1q_f32(&vout[i], vmulq_n_f32(vld1q_f32(&vin[i]), scale));
+    }
+#endif
+    for (; i < len; i++) {
+        vout[i] = vin[i] * scale;
+    }
+}
+
+float DSP::vector_mean_float(const float* vin, uint16_t len) const
+{
+    float sum = 0.0f;
+    uint16_t i = 0;
+#if DSP_USE_NEON
+    float32x4_t vsum = vdupq_n_f32(0.0f);
+    for (; i + 4 <= len; i += 4) {
+        vsum = vaddq_f32(vsum, vld1q_f32(&vin[i]));
+    }
+    sum = neon_hsum(vsum);
+#endif
+    for (; i < len; i++) {
+        sum += vin[i];
+    }
+    return sum / len;
+}
+
+#endif // HAL_WITH_DSP
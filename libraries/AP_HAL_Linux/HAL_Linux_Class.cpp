@@ -14,6 +14,7 @@
 #include <AP_Module/AP_Module.h>
 
 #include "AnalogIn_ADS1115.h"
+#include "DSP.h"
 #include "AnalogIn_IIO.h"
 #include "AnalogIn_Navio2.h"
 #include "GPIO.h"
@@ -216,7 +217,11 @@ static OpticalFlow_Onboard opticalFlow;
 static Empty::OpticalFlow opticalFlow;
 #endif
 
+#if HAL_WITH_DSP
+static DSP dspDriver;
+#else
 static Empty::DSP dspDriver;
+#endif
 static Empty::Flash flashDriver;
 
 #if HAL_NUM_CAN_IFACES
@@ -190,7 +190,10 @@ void Storage::_mark_dirty(uint16_t loc, uint16_t length)
     for (uint8_t line=loc>>LINUX_STORAGE_LINE_SHIFT;
          line <= end>>LINUX_STORAGE_LINE_SHIFT;
          line++) {
-        _dirty_mask |= 1U << line;
+        if (!(_dirty_mask & (1U << line))) {
+            _dirty_mask |= 1U << line;
+            _stats.lines_dirtied++;
+        }
     }
 }
 
@@ -212,6 +215,7 @@ void Storage::write_block(uint16_t loc, const void *src, size_t n)
         init();
         memcpy(&_buffer[loc], src, n);
         _mark_dirty(loc, n);
+        _stats.bytes_changed += n;
     }
 }
 
@@ -257,6 +261,9 @@ void Storage::_timer_tick(void)
             _dirty_mask |= write_mask;
             close(_fd);
             _fd = -1;
+        } else {
+            _stats.lines_written += n;
+            _stats.writes++;
         }
         if (_dirty_mask == 0) {
             if (fsync(_fd) != 0) {
@@ -266,3 +273,34 @@ void Storage::_timer_tick(void)
         }
     }
 }
+
+/*
+  get write statistics. Write amplification is the ratio of bytes
+  written to the file to bytes changed, in percent
+ */
+uint32_t Storage::get_stats(char* data, uint32_t max_size)
+{
+    if (data == nullptr) {
+        return 0;
+    }
+    uint8_t lines_dirty = 0;
+    for (uint8_t i=0; i<LINUX_STORAGE_NUM_LINES; i++) {
+        if (_dirty_mask & (1U<<i)) {
+            lines_dirty++;
+        }
+    }
+    const uint32_t bytes_written = _stats.lines_written * LINUX_STORAGE_LINE_SIZE;
+    return snprintf(data, max_size,
+                    "bytes_changed:  %lu\n"
+                    "lines_dirtied:  %lu\n"
+                    "lines_written:  %lu\n"
+                    "lines_dirty:    %u\n"
+                    "writes:         %lu\n"
+                    "amplification:  %lu%%\n",
+                    (unsigned long)_stats.bytes_changed,
+                    (unsigned long)_stats.lines_dirtied,
+                    (unsigned long)_stats.lines_written,
+                    (unsigned)lines_dirty,
+                    (unsigned long)_stats.writes,
+                    (unsigned long)(_stats.bytes_changed ? (100ULL * bytes_written) / _stats.bytes_changed : 0));
+}
@@ -33,6 +33,7 @@ public:
     void write_block(uint16_t dst, const void* src, size_t n) override;
 
     virtual void _timer_tick(void) override;
+    uint32_t get_stats(char* data, uint32_t max_size) override;
 
 protected:
     void _mark_dirty(uint16_t loc, uint16_t length);
@@ -42,6 +43,13 @@ protected:
     volatile bool _initialised;
     volatile uint32_t _dirty_mask;
     uint8_t _buffer[LINUX_STORAGE_SIZE];
+
+    struct {
+        uint32_t bytes_changed;  // bytes changed by write_block()
+        uint32_t lines_dirtied;  // clean lines made dirty
+        uint32_t lines_written;  // lines written to the file
+        uint32_t writes;         // file writes
+    } _stats;
 };
 
 }
@@ -0,0 +1,40 @@
+#include <AP_gbenchmark.h>
+#include <AP_HAL/AP_HAL.h>
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX && HAL_WITH_DSP
+
+#include <AP_HAL_Linux/DSP.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+// two tones and some broadband noise sampled at 1kHz
+static void fill_samples(FloatBuffer& samples, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++) {
+        const float v = sinf(2 * M_PI * 117.3f * i / 1000.0f) + 0.3f * cosf(2 * M_PI * 33.0f * i / 1000.0f)
+            + 0.01f * (rand() % 100);
+        samples.push(v);
+    }
+}
+
+static void BM_LinuxFFT(benchmark::State& state)
+{
+    const uint16_t window_size = state.range_x();
+    Linux::DSP dsp;
+    AP_HAL::DSP::FFTWindowState* fft = dsp.fft_init(window_size, 1000, 1);
+    FloatBuffer samples(window_size);
+    fill_samples(samples, window_size);
+
+    while (state.KeepRunning()) {
+        dsp.fft_start(fft, samples, 0);
+        uint16_t bin = dsp.fft_analyse(fft, 2, window_size / 2 - 2, 0.5f);
+        gbenchmark_escape(&bin);
+    }
+
+    delete fft;
+}
+
+BENCHMARK(BM_LinuxFFT)->Arg(32)->Arg(64)->Arg(128)->Arg(256)->Arg(512);
+#endif
+
+BENCHMARK_MAIN()
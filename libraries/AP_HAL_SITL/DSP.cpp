@@ -38,7 +38,8 @@ extern const AP_HAL::HAL& hal;
 AP_HAL::DSP::FFTWindowState* DSP::fft_init(uint16_t window_size, uint16_t sample_rate, uint8_t harmonics)
 {
     DSP::FFTWindowStateSITL* fft = new DSP::FFTWindowStateSITL(window_size, sample_rate, harmonics);
-    if (fft == nullptr || fft->_hanning_window == nullptr || fft->_rfft_data == nullptr || fft->_freq_bins == nullptr || fft->_derivative_freq_bins == nullptr) {
+    if (fft == nullptr || fft->_hanning_window == nullptr || fft->_rfft_data == nullptr || fft->_freq_bins == nullptr || fft->_derivative_freq_bins == nullptr
+        || !fft->_rfft.valid()) {
         delete fft;
         return nullptr;
     }
@@ -62,19 +63,15 @@ uint16_t DSP::fft_analyse(AP_HAL::DSP::FFTWindowState* state, uint16_t start_bin
 
 // create an instance of the FFT state machine
 DSP::FFTWindowStateSITL::FFTWindowStateSITL(uint16_t window_size, uint16_t sample_rate, uint8_t harmonics)
-    : AP_HAL::DSP::FFTWindowState::FFTWindowState(window_size, sample_rate, harmonics)
+    : AP_HAL::DSP::FFTWindowState::FFTWindowState(window_size, sample_rate, harmonics),
+      // a positive exponent gives the same output as the original full
+      // length complex FFT
+      _rfft(window_size, true)
 {
     if (_freq_bins == nullptr || _hanning_window == nullptr || _rfft_data == nullptr || _derivative_freq_bins == nullptr) {
         GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "Failed to allocate window for DSP");
         return;
     }
-
-    buf = new complexf[window_size];
-}
-
-DSP::FFTWindowStateSITL::~FFTWindowStateSITL()
-{
-    delete[] buf;
 }
 
 // step 1: filter the incoming samples through a Hanning window
@@ -89,23 +86,17 @@ void DSP::step_hanning(FFTWindowStateSITL* fft, FloatBuffer& samples, uint16_t a
     mult_f32(&fft->_freq_bins[0], &fft->_hanning_window[0], &fft->_freq_bins[0], fft->_window_size);
 }
 
-// step 2: performm an in-place FFT on the windowed data
+// step 2: performm an FFT on the windowed data, the real samples in _freq_bins are
+// transformed in place as interleaved complex values and then split into _rfft_data
 void DSP::step_fft(FFTWindowStateSITL* fft)
 {
-    for (uint16_t i = 0; i < fft->_window_size; i++) {
-        fft->buf[i] = complexf(fft->_freq_bins[i], 0);
-    }
-
-    calculate_fft(fft->buf, fft->_window_size);
+    fft->_rfft.calculate(fft->_freq_bins, fft->_rfft_data);
 
-    for (uint16_t i = 0; i < fft->_bin_count; i++) {
-        fft->_freq_bins[i] = std::norm(fft->buf[i]);
-    }
-
-    // components at the nyquist frequency are real only
-    for (uint16_t i = 0, j = 0; i <= fft->_bin_count; i++, j += 2) {
-        fft->_rfft_data[j] = fft->buf[i].real();
-        fft->_rfft_data[j+1] = fft->buf[i].imag();
+    // power in each bin, including the nyquist frequency
+    const float* x = fft->_rfft_data;
+    float* mag = fft->_freq_bins;
+    for (uint16_t i = 0; i <= fft->_bin_count; i++) {
+        mag[i] = x[2 * i] * x[2 * i] + x[2 * i + 1] * x[2 * i + 1];
     }
 }
 
@@ -118,12 +109,17 @@ void DSP::mult_f32(const float* v1, const float* v2, float* vout, uint16_t len)
 
 void DSP::vector_max_float(const float* vin, uint16_t len, float* maxValue, uint16_t* maxIndex) const
 {
-    *maxValue = vin[0];
-    *maxIndex = 0;
+    // find the value with a branch free loop, then the first index holding it
+    float value = vin[0];
     for (uint16_t i = 1; i < len; i++) {
-        if (vin[i] > *maxValue) {
-            *maxValue = vin[i];
+        value = vin[i] > value ? vin[i] : value;
+    }
+    *maxValue = value;
+    *maxIndex = 0;
+    for (uint16_t i = 0; i < len; i++) {
+        if (vin[i] == value) {
             *maxIndex = i;
+            break;
         }
     }
 }
@@ -144,59 +140,3 @@ float DSP::vector_mean_float(const float* vin, uint16_t len) const
     mean_value /= len;
     return mean_value;
 }
-
-// simple integer log2
-static uint16_t fft_log2(uint16_t n)
-{
-    uint16_t k = n, i = 0;
-    while (k) {
-        k >>= 1;
-        i++;
-    }
-    return i - 1;
-}
-
-// calculate the in-place FFT of the input using the Cooley–Tukey algorithm
-// this is a translation of Ron Nicholson's version in http://www.nicholson.com/dsp.fft1.html
-void DSP::calculate_fft(complexf *samples, uint16_t fftlen)
-{
-    uint16_t m = fft_log2(fftlen);
-    // shuffle data using bit reversed addressing ***
-    for (uint16_t k = 0; k < fftlen; k++) {
-        // generate a bit reversed address for samples[k] ***
-        uint16_t ki = k, kr = 0;
-        for (uint16_t i=1; i<=m; i++) {
-            kr <<= 1; //  left shift result kr by 1 bit
-            if (ki % 2 == 1) {
-                kr++;
-            }
-            ki >>= 1; // right shift temp ki by 1 bit
-        }
-        // swap data samples[k] to bit reversed address samples[kr]
-        if (kr > k) {
-            complexf t = samples[kr];
-            samples[kr] = samples[k];
-            samples[k] = t;
-        }
-    }
-
-    // do fft butterflys in place
-    uint16_t istep = 2;
-    while (istep <= fftlen) {// layers 2,4,8,16, ... ,n
-        uint16_t is2 = istep / 2;
-        uint16_t astep = fftlen / istep;
-        for (uint16_t km = 0; km < is2; km++) { // outer row loop
-            uint16_t a  = km * astep; // twiddle angle index
-            complexf w(sinf(2 * M_PI * (a+(fftlen/4)) / fftlen), sinf(2 * M_PI * a / fftlen));
-            for (uint16_t ki = 0; ki <= (fftlen - istep); ki += istep) { // inner column loop
-                uint16_t i = km + ki;
-                uint16_t j = is2 + i;
-                complexf t = w * samples[j];
-                complexf q = samples[i];
-                samples[j] = q - t;
-                samples[i] = q + t;
-            }
-        }
-        istep <<= 1;
-    }
-}
@@ -19,10 +19,6 @@
 #include <AP_HAL/AP_HAL.h>
 #include "AP_HAL_SITL.h"
 
-#include <complex>
-
-typedef std::complex<float> complexf;
-
 // ChibiOS implementation of FFT analysis to run on STM32 processors
 class HALSITL::DSP : public AP_HAL::DSP {
 public:
@@ -39,10 +35,9 @@ public:
 
     public:
         FFTWindowStateSITL(uint16_t window_size, uint16_t sample_rate, uint8_t harmonics);
-        virtual ~FFTWindowStateSITL();
 
     private:
-        complexf* buf;
+        RealFFT _rfft;
     };
 
 private:
@@ -52,5 +47,4 @@ private:
     void vector_max_float(const float* vin, uint16_t len, float* maxValue, uint16_t* maxIndex) const override;
     void vector_scale_float(const float* vin, float scale, float* vout, uint16_t len) const override;
     float vector_mean_float(const float* vin, uint16_t len) const override;
-    void calculate_fft(complexf* f, uint16_t length);
 };
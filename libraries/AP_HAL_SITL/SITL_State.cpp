@@ -13,6 +13,7 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <sched.h>
 #include <sys/select.h>
 
 #include <AP_Param/AP_Param.h>
@@ -151,8 +152,10 @@ void SITL_State::_fdm_input_step(void)
 
     _fdm_input_local();
 
-    /* make sure we die if our parent dies */
-    if (kill(_parent_pid, 0) != 0) {
+    /* make sure we die if our parent dies. In fast time mode this
+       syscall dominates the step cost, so only check occasionally */
+    if ((!_fast_time || _update_count % 1000 == 0) &&
+        kill(_parent_pid, 0) != 0) {
         exit(1);
     }
 
@@ -201,12 +204,15 @@ void SITL_State::_fdm_input_step(void)
 
 void SITL_State::wait_clock(uint64_t wait_time_usec)
 {
-    while (AP_HAL::micros64() < wait_time_usec) {
+    uint64_t now_usec;
+    while ((now_usec = AP_HAL::micros64()) < wait_time_usec) {
         if (hal.scheduler->in_main_thread() ||
             Scheduler::from(hal.scheduler)->semaphore_wait_hack_required()) {
             _fdm_input_step();
         } else {
-            usleep(1000);
+            // sleep until the main thread moves time on, rather than
+            // polling, so this thread keeps up however fast time runs
+            Scheduler::from(hal.scheduler)->wait_clock_change(now_usec, MIN(wait_time_usec - now_usec, 100000ULL));
         }
     }
     // check the outbound TCP queue size.  If it is too long then
@@ -197,6 +197,9 @@ private:
 
     bool _synthetic_clock_mode;
 
+    // advance simulated time as fast as possible, with no wall clock waits
+    bool _fast_time;
+
     bool _use_rtscts;
     bool _use_fg_view;
     
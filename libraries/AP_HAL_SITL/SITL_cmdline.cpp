@@ -34,6 +34,7 @@
 #include <SITL/SIM_Scrimmage.h>
 #include <SITL/SIM_Webots.h>
 #include <SITL/SIM_JSON.h>
+#include <SITL/SIM_SharedMem.h>
 
 #include <signal.h>
 #include <stdio.h>
@@ -96,7 +97,9 @@ void SITL_State::_usage(void)
            "\t--sim-port-in PORT       set port num for simulator in\n"
            "\t--sim-port-out PORT      set port num for simulator out\n"
            "\t--irlock-port PORT       set port num for irlock\n"
-           "\t--start-time TIMESTR     set simulation start time in UNIX timestamp"
+           "\t--start-time TIMESTR     set simulation start time in UNIX timestamp\n"
+           "\t--fast-time              run as fast as possible, without wall clock sync\n"
+           "\t--seed SEED              set random number seed for simulated noise"
         );
 }
 
@@ -151,6 +154,7 @@ static const struct {
     { "scrimmage",          Scrimmage::create },
     { "webots",             Webots::create },
     { "JSON",               JSON::create },
+    { "shm",                SharedMem::create },
 };
 
 void SITL_State::_set_signal_handlers(void) const
@@ -228,6 +232,8 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         CMDLINE_SIM_PORT_OUT,
         CMDLINE_IRLOCK_PORT,
         CMDLINE_START_TIME,
+        CMDLINE_FAST_TIME,
+        CMDLINE_SEED,
     };
 
     const struct GetOptLong::option options[] = {
@@ -264,6 +270,8 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         {"sim-port-out",    true,   0, CMDLINE_SIM_PORT_OUT},
         {"irlock-port",     true,   0, CMDLINE_IRLOCK_PORT},
         {"start-time",      true,   0, CMDLINE_START_TIME},
+        {"fast-time",       false,  0, CMDLINE_FAST_TIME},
+        {"seed",            true,   0, CMDLINE_SEED},
         {0, false, 0, 0}
     };
 
@@ -385,6 +393,15 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         case CMDLINE_START_TIME:
             start_time_UTC = atoi(gopt.optarg);
             break;
+        case CMDLINE_FAST_TIME:
+            _fast_time = true;
+            break;
+        case CMDLINE_SEED: {
+            const unsigned seed = strtoul(gopt.optarg, nullptr, 0);
+            srand(seed);
+            srandom(seed);
+            break;
+        }
         default:
             _usage();
             exit(1);
@@ -420,6 +437,11 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
             sitl_model->set_instance(_instance);
             sitl_model->set_autotest_dir(autotest_dir);
             sitl_model->set_config(config);
+            if (_fast_time) {
+                // only override time sync when asked, some models
+                // turn it off themselves
+                sitl_model->set_fast_time(true);
+            }
             _synthetic_clock_mode = true;
             break;
         }
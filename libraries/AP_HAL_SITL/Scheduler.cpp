@@ -256,13 +256,35 @@ void Scheduler::_run_io_procs()
  */
 void Scheduler::stop_clock(uint64_t time_usec)
 {
+    pthread_mutex_lock(&_clock_mutex);
     _stopped_clock_usec = time_usec;
+    pthread_cond_broadcast(&_clock_cond);
+    pthread_mutex_unlock(&_clock_mutex);
     if (time_usec - _last_io_run > 10000) {
         _last_io_run = time_usec;
         _run_io_procs();
     }
 }
 
+void Scheduler::wait_clock_change(uint64_t seen_usec, uint32_t timeout_us)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    const uint64_t nsec = ts.tv_nsec + timeout_us * 1000ULL;
+    ts.tv_sec += nsec / 1000000000ULL;
+    ts.tv_nsec = nsec % 1000000000ULL;
+
+    pthread_mutex_lock(&_clock_mutex);
+    // while the clock isn't stopped time runs on its own, so just
+    // wait for the timeout
+    while (_stopped_clock_usec == 0 || _stopped_clock_usec == seen_usec) {
+        if (pthread_cond_timedwait(&_clock_cond, &_clock_mutex, &ts) != 0) {
+            break;
+        }
+    }
+    pthread_mutex_unlock(&_clock_mutex);
+}
+
 /*
   trampoline for thread create
 */
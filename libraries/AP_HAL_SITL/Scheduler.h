@@ -48,6 +48,10 @@ public:
 
     uint64_t stopped_clock_usec() const { return _stopped_clock_usec; }
 
+    // block until the main thread moves the stopped clock on from
+    // seen_usec, or timeout_us of wall clock time passes
+    void wait_clock_change(uint64_t seen_usec, uint32_t timeout_us);
+
     static void _run_io_procs();
     static bool _should_reboot;
     static bool _should_exit;
@@ -93,6 +97,9 @@ private:
     
     bool _initialized;
     uint64_t _stopped_clock_usec;
+    // signalled each time the stopped clock is moved on
+    pthread_mutex_t _clock_mutex = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t _clock_cond = PTHREAD_COND_INITIALIZER;
     uint64_t _last_io_run;
     pthread_t _main_ctx;
 
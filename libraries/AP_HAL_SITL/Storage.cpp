@@ -100,7 +100,10 @@ void Storage::_mark_dirty(uint16_t loc, uint16_t length)
     for (uint16_t line=loc>>STORAGE_LINE_SHIFT;
          line <= end>>STORAGE_LINE_SHIFT;
          line++) {
-        _dirty_mask.set(line);
+        if (!_dirty_mask.get(line)) {
+            _dirty_mask.set(line);
+            _stats.lines_dirtied++;
+        }
     }
 }
 
@@ -122,6 +125,7 @@ void Storage::write_block(uint16_t loc, const void *src, size_t n)
         _storage_open();
         memcpy(&_buffer[loc], src, n);
         _mark_dirty(loc, n);
+        _stats.bytes_changed += n;
     }
 }
 
@@ -135,8 +139,13 @@ void Storage::_timer_tick(void)
         return;
     }
 
-    // write out the first dirty line. We don't write more
-    // than one to keep the latency of this call to a minimum
+    if (AP_HAL::millis() - _last_empty_ms < STORAGE_COALESCE_MS) {
+        // give changes made together time to arrive
+        return;
+    }
+
+    // write out the first run of dirty lines. We don't write more
+    // than one run to keep the latency of this call to a minimum
     uint16_t i;
     for (i=0; i<STORAGE_NUM_LINES; i++) {
         if (_dirty_mask.get(i)) {
@@ -147,24 +156,35 @@ void Storage::_timer_tick(void)
         // this shouldn't be possible
         return;
     }
+    uint16_t n;
+    for (n=1; n < STORAGE_MAX_WRITE_LINES && i+n < STORAGE_NUM_LINES; n++) {
+        if (!_dirty_mask.get(i+n)) {
+            break;
+        }
+    }
 
 #if STORAGE_USE_POSIX
     if (using_filesystem && log_fd != -1) {
         const off_t offset = STORAGE_LINE_SIZE*i;
+        const ssize_t length = STORAGE_LINE_SIZE*n;
         if (lseek(log_fd, offset, SEEK_SET) != offset) {
             return;
         }
-        if (write(log_fd, &_buffer[offset], STORAGE_LINE_SIZE) != STORAGE_LINE_SIZE) {
+        if (write(log_fd, &_buffer[offset], length) != length) {
             return;
         }
-        _dirty_mask.clear(i);
+        for (uint16_t j=0; j<n; j++) {
+            _dirty_mask.clear(i+j);
+        }
+        _stats.lines_written += n;
+        _stats.writes++;
         return;
     } 
 #endif
     
 #if STORAGE_USE_FLASH
     // save to storage backend
-    _flash_write(i);
+    _flash_write(i, n);
 #endif
 }
 
@@ -183,14 +203,18 @@ void Storage::_flash_load(void)
 }
 
 /*
-  write one storage line. This also updates _dirty_mask. 
+  write a run of storage lines. This also updates _dirty_mask. 
 */
-void Storage::_flash_write(uint16_t line)
+void Storage::_flash_write(uint16_t line, uint16_t nlines)
 {
 #if STORAGE_USE_FLASH
-    if (_flash.write(line*STORAGE_LINE_SIZE, STORAGE_LINE_SIZE)) {
-        // mark the line clean
-        _dirty_mask.clear(line);
+    if (_flash.write(line*STORAGE_LINE_SIZE, nlines*STORAGE_LINE_SIZE)) {
+        // mark the lines clean
+        for (uint16_t j=0; j<nlines; j++) {
+            _dirty_mask.clear(line+j);
+        }
+        _stats.lines_written += nlines;
+        _stats.writes++;
     }
 #endif
 }
@@ -340,4 +364,27 @@ bool Storage::healthy(void)
     return _initialised && AP_HAL::millis() - _last_empty_ms < 2000;
 }
 
-
+/*
+  get write statistics. Write amplification is the ratio of bytes
+  written to the backend to bytes changed, in percent
+ */
+uint32_t Storage::get_stats(char* data, uint32_t max_size)
+{
+    if (data == nullptr) {
+        return 0;
+    }
+    const uint32_t bytes_written = _stats.lines_written * STORAGE_LINE_SIZE;
+    return snprintf(data, max_size,
+                    "bytes_changed:  %lu\n"
+                    "lines_dirtied:  %lu\n"
+                    "lines_written:  %lu\n"
+                    "lines_dirty:    %u\n"
+                    "writes:         %lu\n"
+                    "amplification:  %lu%%\n",
+                    (unsigned long)_stats.bytes_changed,
+                    (unsigned long)_stats.lines_dirtied,
+                    (unsigned long)_stats.lines_written,
+                    (unsigned)_dirty_mask.count(),
+                    (unsigned long)_stats.writes,
+                    (unsigned long)(_stats.bytes_changed ? (100ULL * bytes_written) / _stats.bytes_changed : 0));
+}
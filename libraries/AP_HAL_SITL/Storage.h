@@ -22,6 +22,17 @@
 #define STORAGE_LINE_SIZE (1<<STORAGE_LINE_SHIFT)
 #define STORAGE_NUM_LINES (HAL_STORAGE_SIZE/STORAGE_LINE_SIZE)
 
+// consecutive dirty lines are written together, up to this many
+// bytes. This matches the largest write of AP_FlashStorage
+#define STORAGE_MAX_WRITE 64
+#define STORAGE_MAX_WRITE_LINES (STORAGE_MAX_WRITE/STORAGE_LINE_SIZE)
+
+// wait this long after the first change before writing, so that
+// changes made together are written together
+#ifndef STORAGE_COALESCE_MS
+#define STORAGE_COALESCE_MS 50
+#endif
+
 class HALSITL::Storage : public AP_HAL::Storage {
 public:
     void init() override {}
@@ -30,6 +41,7 @@ public:
 
     void _timer_tick(void) override;
     bool healthy(void) override;
+    uint32_t get_stats(char* data, uint32_t max_size) override;
 
 private:
     volatile bool _initialised;
@@ -40,6 +52,13 @@ private:
     uint8_t _buffer[HAL_STORAGE_SIZE] __attribute__((aligned(4)));
     Bitmask<STORAGE_NUM_LINES> _dirty_mask;
 
+    struct {
+        uint32_t bytes_changed;  // bytes changed by write_block()
+        uint32_t lines_dirtied;  // clean lines made dirty
+        uint32_t lines_written;  // lines written to the backend
+        uint32_t writes;         // backend writes
+    } _stats;
+
 #if STORAGE_USE_FLASH
     bool _flash_write_data(uint8_t sector, uint32_t offset, const uint8_t *data, uint16_t length);
     bool _flash_read_data(uint8_t sector, uint32_t offset, uint8_t *data, uint16_t length);
@@ -61,7 +80,7 @@ private:
 #endif
     
     void _flash_load(void);
-    void _flash_write(uint16_t line);
+    void _flash_write(uint16_t line, uint16_t nlines);
 
 #if STORAGE_USE_POSIX
     bool using_filesystem;
@@ -1,4 +1,5 @@
 #include "Util.h"
+#include "SITL_State.h"
 #include <sys/time.h>
 
 #ifdef WITH_SITL_TONEALARM
@@ -7,6 +8,10 @@ HALSITL::ToneAlarm_SF HALSITL::Util::_toneAlarm;
 
 uint64_t HALSITL::Util::get_hw_rtc() const
 {
+    if (sitlState->_fast_time && sitlState->_sitl != nullptr) {
+        // follow simulated time so runs are reproducible
+        return sitlState->_sitl->start_time_UTC * 1000000ULL + AP_HAL::micros64();
+    }
 #ifndef CLOCK_REALTIME
     struct timeval ts;
     gettimeofday(&ts, nullptr);
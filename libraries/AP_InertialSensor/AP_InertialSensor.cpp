@@ -9,6 +9,7 @@
 #include <AP_Vehicle/AP_Vehicle.h>
 #include <AP_BoardConfig/AP_BoardConfig.h>
 #include <AP_AHRS/AP_AHRS.h>
+#include <AP_Logger/AP_Logger.h>
 
 #include "AP_InertialSensor.h"
 #include "AP_InertialSensor_BMI160.h"
@@ -499,7 +500,7 @@ const AP_Param::GroupInfo AP_InertialSensor::var_info[] = {
 
     // @Group: HNTCH_
     // @Path: ../Filter/HarmonicNotchFilter.cpp
-    AP_SUBGROUPINFO(_harmonic_notch_filter, "HNTCH_",  41, AP_InertialSensor, HarmonicNotchFilterParams),
+    AP_SUBGROUPINFO(harmonic_notches[0]._params, "HNTCH_",  41, AP_InertialSensor, HarmonicNotchFilterParams),
 
     // @Param: GYRO_RATE
     // @DisplayName: Gyro rate for IMUs with Fast Sampling enabled
@@ -509,6 +510,12 @@ const AP_Param::GroupInfo AP_InertialSensor::var_info[] = {
     // @RebootRequired: True
     AP_GROUPINFO("GYRO_RATE",  42, AP_InertialSensor, _fast_sampling_rate, MPU_FIFO_FASTSAMPLE_DEFAULT),
 
+#if HAL_INS_NUM_HARMONIC_NOTCH_FILTERS > 1
+    // @Group: HNTC2_
+    // @Path: ../Filter/HarmonicNotchFilter.cpp
+    AP_SUBGROUPINFO(harmonic_notches[1]._params, "HNTC2_",  43, AP_InertialSensor, HarmonicNotchFilterParams),
+#endif
+
     /*
       NOTE: parameter indexes have gaps above. When adding new
       parameters check for conflicts carefully
@@ -736,17 +743,19 @@ AP_InertialSensor::init(uint16_t loop_rate)
     // initialise IMU batch logging
     batchsampler.init();
 
-    // the center frequency of the harmonic notch is always taken from the calculated value so that it can be updated
-    // dynamically, the calculated value is always some multiple of the configured center frequency, so start with the
-    // configured value
-    _calculated_harmonic_notch_freq_hz[0] = _harmonic_notch_filter.center_freq_hz();
-    _num_calculated_harmonic_notch_frequencies = 1;
-
-    for (uint8_t i=0; i<get_gyro_count(); i++) {
-        _gyro_harmonic_notch_filter[i].allocate_filters(_harmonic_notch_filter.harmonics(), _harmonic_notch_filter.hasOption(HarmonicNotchFilterParams::Options::DoubleNotch));
-        // initialise default settings, these will be subsequently changed in AP_InertialSensor_Backend::update_gyro()
-        _gyro_harmonic_notch_filter[i].init(_gyro_raw_sample_rates[i], _calculated_harmonic_notch_freq_hz[0],
-             _harmonic_notch_filter.bandwidth_hz(), _harmonic_notch_filter.attenuation_dB());
+    for (auto &notch : harmonic_notches) {
+        // the center frequency of the harmonic notch is always taken from the calculated value so that it can be updated
+        // dynamically, the calculated value is always some multiple of the configured center frequency, so start with the
+        // configured value
+        notch._calculated_freq_hz[0] = notch._params.center_freq_hz();
+        notch._num_calculated_frequencies = 1;
+
+        for (uint8_t i=0; i<get_gyro_count(); i++) {
+            notch._filter[i].allocate_filters(notch._params.harmonics(), notch._params.hasOption(HarmonicNotchFilterParams::Options::DoubleNotch));
+            // initialise default settings, these will be subsequently changed in AP_InertialSensor_Backend::update_gyro()
+            notch._filter[i].init(_gyro_raw_sample_rates[i], notch._calculated_freq_hz[0],
+                                 notch._params.bandwidth_hz(), notch._params.attenuation_dB());
+        }
     }
 }
 
@@ -1346,14 +1355,6 @@ void AP_InertialSensor::update(void)
             _backends[i]->update();
         }
 
-        // clear accumulators
-        for (uint8_t i = 0; i < INS_MAX_INSTANCES; i++) {
-            _delta_velocity_acc[i].zero();
-            _delta_velocity_acc_dt[i] = 0;
-            _delta_angle_acc[i].zero();
-            _delta_angle_acc_dt[i] = 0;
-        }
-
         if (!_startup_error_counts_set) {
             for (uint8_t i=0; i<INS_MAX_INSTANCES; i++) {
                 _accel_startup_error_count[i] = _accel_error_count[i];
@@ -1418,6 +1419,42 @@ void AP_InertialSensor::update(void)
     _last_update_usec = AP_HAL::micros();
     
     _have_sample = false;
+
+    log_wait_stats();
+}
+
+// @LoggerMessage: ISWT
+// @Description: IMU sample wait statistics
+// @Field: TimeUS: Time since system startup
+// @Field: N: number of waits for sensor data since the last message
+// @Field: Avg: average time spent waiting for sensor data once a sample was due
+// @Field: Max: longest time spent waiting for sensor data once a sample was due
+// @Field: TO: number of waits that gave up before every sensor in use had data
+
+/*
+  log how long wait_for_sample() waited on the sensors, once a second
+ */
+void AP_InertialSensor::log_wait_stats()
+{
+    const uint32_t now_ms = AP_HAL::millis();
+    if (now_ms - _wait_stats.last_log_ms < 1000) {
+        return;
+    }
+    _wait_stats.last_log_ms = now_ms;
+
+    AP_Logger *logger = AP_Logger::get_singleton();
+    if (logger != nullptr && _wait_stats.count > 0) {
+        logger->Write("ISWT", "TimeUS,N,Avg,Max,TO", "s-ss-", "F-FF-", "QIIII",
+                      AP_HAL::micros64(),
+                      _wait_stats.count,
+                      _wait_stats.sum_us / _wait_stats.count,
+                      _wait_stats.max_us,
+                      _wait_stats.timeouts);
+    }
+    _wait_stats.count = 0;
+    _wait_stats.sum_us = 0;
+    _wait_stats.max_us = 0;
+    _wait_stats.timeouts = 0;
 }
 
 /*
@@ -1483,6 +1520,7 @@ check_sample:
         uint8_t gyro_available_mask = 0;
         uint8_t accel_available_mask = 0;
         uint32_t wait_counter = 0;
+        const uint32_t wait_start_us = AP_HAL::micros();
 
         while (true) {
             for (uint8_t i=0; i<_backend_count; i++) {
@@ -1492,7 +1530,7 @@ check_sample:
             }
 
             for (uint8_t i=0; i<_gyro_count; i++) {
-                if (_new_gyro_data[i]) {
+                if (_gyro_channel[i].available()) {
                     const uint8_t imask = (1U<<i);
                     gyro_available_mask |= imask;
                     if (_use[i]) {
@@ -1503,7 +1541,7 @@ check_sample:
                 }
             }
             for (uint8_t i=0; i<_accel_count; i++) {
-                if (_new_accel_data[i]) {
+                if (_accel_channel[i].available()) {
                     const uint8_t imask = (1U<<i);
                     accel_available_mask |= imask;
                     if (_use[i]) {
@@ -1531,6 +1569,7 @@ check_sample:
                     // comes back we will start waiting on it again
                     _gyro_wait_mask &= gyro_available_mask;
                     _accel_wait_mask &= accel_available_mask;
+                    _wait_stats.timeouts++;
                     break;
                 }
             }
@@ -1538,6 +1577,11 @@ check_sample:
             hal.scheduler->delay_microseconds_boost(100);
             wait_counter++;
         }
+
+        const uint32_t wait_us = AP_HAL::micros() - wait_start_us;
+        _wait_stats.count++;
+        _wait_stats.sum_us += wait_us;
+        _wait_stats.max_us = MAX(_wait_stats.max_us, wait_us);
     }
 
     now = AP_HAL::micros();
@@ -1816,24 +1860,25 @@ void AP_InertialSensor::acal_update()
 }
 
 // Update the harmonic notch frequency
-void AP_InertialSensor::update_harmonic_notch_freq_hz(float scaled_freq) {
+void AP_InertialSensor::HarmonicNotch::update_freq_hz(float scaled_freq) {
     // protect against zero as the scaled frequency
     if (is_positive(scaled_freq)) {
-        _calculated_harmonic_notch_freq_hz[0] = scaled_freq;
+        _calculated_freq_hz[0] = scaled_freq;
     }
-    _num_calculated_harmonic_notch_frequencies = 1;
+    _num_calculated_frequencies = 1;
 }
 
 // Update the harmonic notch frequency
-void AP_InertialSensor::update_harmonic_notch_frequencies_hz(uint8_t num_freqs, const float scaled_freq[]) {
+void AP_InertialSensor::HarmonicNotch::update_frequencies_hz(uint8_t num_freqs, const float scaled_freq[]) {
+    num_freqs = MIN(num_freqs, INS_MAX_NOTCHES);
     // protect against zero as the scaled frequency
     for (uint8_t i = 0; i < num_freqs; i++) {
         if (is_positive(scaled_freq[i])) {
-            _calculated_harmonic_notch_freq_hz[i] = scaled_freq[i];
+            _calculated_freq_hz[i] = scaled_freq[i];
         }
     }
     // any uncalculated frequencies will float at the previous value or the initialized freq if none
-    _num_calculated_harmonic_notch_frequencies = num_freqs;
+    _num_calculated_frequencies = num_freqs;
 }
 
 /*
@@ -14,6 +14,9 @@
 #define INS_MAX_INSTANCES 3
 #define INS_MAX_BACKENDS  6
 #define INS_MAX_NOTCHES 4
+#ifndef HAL_INS_NUM_HARMONIC_NOTCH_FILTERS
+#define HAL_INS_NUM_HARMONIC_NOTCH_FILTERS 2
+#endif
 #define INS_VIBRATION_CHECK_INSTANCES 2
 #define XYZ_AXIS_COUNT    3
 // The maximum we need to store is gyro-rate / loop-rate, worst case ArduCopter with BMI088 is 2000/400
@@ -26,11 +29,16 @@
 #include <AP_AccelCal/AP_AccelCal.h>
 #include <AP_HAL/AP_HAL.h>
 #include <AP_HAL/utility/RingBuffer.h>
+#include <AP_HAL/utility/TripleBuffer.h>
 #include <AP_Math/AP_Math.h>
 #include <Filter/LowPassFilter2p.h>
 #include <Filter/LowPassFilter.h>
 #include <Filter/NotchFilter.h>
 #include <Filter/HarmonicNotchFilter.h>
+#include <Filter/BiquadCascade.h>
+
+static_assert(1 + HAL_INS_NUM_HARMONIC_NOTCH_FILTERS * HNF_MAX_FILTERS <= BIQUAD_CASCADE_MAX_NOTCHES,
+              "gyro filter chain too short for the harmonic notch banks");
 
 class AP_InertialSensor_Backend;
 class AuxiliaryBus;
@@ -52,6 +60,7 @@ class AP_Logger;
 class AP_InertialSensor : AP_AccelCal_Client
 {
     friend class AP_InertialSensor_Backend;
+    friend class AP_InertialSensor_Test;
 
 public:
     AP_InertialSensor();
@@ -220,11 +229,6 @@ public:
     uint8_t get_primary_accel(void) const { return _primary_accel; }
     uint8_t get_primary_gyro(void) const { return _primary_gyro; }
 
-    // Update the harmonic notch frequency
-    void update_harmonic_notch_freq_hz(float scaled_freq);
-    // Update the harmonic notch frequencies
-    void update_harmonic_notch_frequencies_hz(uint8_t num_freqs, const float scaled_freq[]);
-
     // enable HIL mode
     void set_hil_mode(void) { _hil_mode = true; }
 
@@ -234,31 +238,45 @@ public:
     // get the accel filter rate in Hz
     uint16_t get_accel_filter_hz(void) const { return _accel_filter_cutoff; }
 
-    // harmonic notch current center frequency
-    float get_gyro_dynamic_notch_center_freq_hz(void) const { return _calculated_harmonic_notch_freq_hz[0]; }
+    /*
+      a bank of harmonic notches applied to every gyro. Each bank has
+      its own parameters and tracking source, so that for example motor
+      and rotor harmonics can be tracked at the same time
+     */
+    class HarmonicNotch {
+        friend class AP_InertialSensor;
+        friend class AP_InertialSensor_Backend;
 
-    // set of harmonic notch current center frequencies
-    const float* get_gyro_dynamic_notch_center_frequencies_hz(void) const { return _calculated_harmonic_notch_freq_hz; }
+    public:
+        // Update the harmonic notch frequency
+        void update_freq_hz(float scaled_freq);
+        // Update the harmonic notch frequencies
+        void update_frequencies_hz(uint8_t num_freqs, const float scaled_freq[]);
 
-    // number of harmonic notch current center frequencies
-    uint8_t get_num_gyro_dynamic_notch_center_frequencies(void) const { return _num_calculated_harmonic_notch_frequencies; }
+        // return true if this bank is enabled
+        bool enabled(void) const { return _params.enabled(); }
 
-    // harmonic notch reference center frequency
-    float get_gyro_harmonic_notch_center_freq_hz(void) const { return _harmonic_notch_filter.center_freq_hz(); }
+        // the parameters of this bank
+        const HarmonicNotchFilterParams &params(void) const { return _params; }
 
-    // harmonic notch reference scale factor
-    float get_gyro_harmonic_notch_reference(void) const { return _harmonic_notch_filter.reference(); }
+        // current center frequency of the notch
+        float calculated_freq_hz(void) const { return _calculated_freq_hz[0]; }
 
-    // harmonic notch tracking mode
-    HarmonicNotchDynamicMode get_gyro_harmonic_notch_tracking_mode(void) const { return _harmonic_notch_filter.tracking_mode(); }
+        // set of current center frequencies of the notch
+        const float* calculated_frequencies_hz(void) const { return _calculated_freq_hz; }
 
-    // harmonic notch harmonics
-    uint8_t get_gyro_harmonic_notch_harmonics(void) const { return _harmonic_notch_filter.harmonics(); }
+        // number of current center frequencies of the notch
+        uint8_t num_calculated_frequencies(void) const { return _num_calculated_frequencies; }
 
-    // harmonic notch options
-    bool has_harmonic_option(HarmonicNotchFilterParams::Options option) {
-        return _harmonic_notch_filter.hasOption(option);
-    }
+    private:
+        HarmonicNotchFilterParams _params;
+        HarmonicNotchFilterVector3f _filter[INS_MAX_INSTANCES];
+
+        // the current center frequencies for the notch
+        float _calculated_freq_hz[INS_MAX_NOTCHES];
+        uint8_t _num_calculated_frequencies;
+    };
+    HarmonicNotch harmonic_notches[HAL_INS_NUM_HARMONIC_NOTCH_FILTERS];
 
     // indicate which bit in LOG_BITMASK indicates raw logging enabled
     void set_log_raw_bit(uint32_t log_raw_bit) { _log_raw_bit = log_raw_bit; }
@@ -276,9 +294,6 @@ public:
     // check for vibration movement. True when all axis show nearly zero movement
     bool is_still();
 
-    // return true if harmonic notch enabled
-    bool gyro_harmonic_notch_enabled(void) const { return _harmonic_notch_filter.enabled(); }
-
     /*
       HIL set functions. The minimum for HIL is set_accel() and
       set_gyro(). The others are option for higher fidelity log
@@ -348,7 +363,7 @@ public:
         // a function called by the main thread at the main loop rate:
         void periodic();
 
-        bool doing_sensor_rate_logging() const { return _doing_sensor_rate_logging; }
+        bool doing_sensor_rate_logging(uint8_t instance, IMU_SENSOR_TYPE type) const;
         bool doing_post_filter_logging() const { return _doing_post_filter_logging; }
 
         // class level parameters
@@ -377,6 +392,34 @@ public:
         enum batch_opt_t {
             BATCH_OPT_SENSOR_RATE = (1<<0),
             BATCH_OPT_POST_FILTER = (1<<1),
+            BATCH_OPT_STREAMING   = (1<<2),
+        };
+
+        // one ISBD message worth of samples
+        struct isb_block {
+            uint64_t sample_us; // time of the first sample
+            bool gap;           // samples were lost before this block
+            int16_t x[32];
+            int16_t y[32];
+            int16_t z[32];
+        };
+
+        // continuous capture of one sensor. The sensor thread fills
+        // the staging block and pushes it to the ring, the main
+        // thread drains the ring to the log
+        struct isb_stream {
+            ObjectBuffer<isb_block> ring;
+            // owned by the sensor thread
+            isb_block staging;
+            uint8_t staging_count;
+            bool dropped_last;
+            uint32_t sample_count;
+            uint32_t dropped_count;
+            // owned by the main thread
+            uint16_t multiplier;
+            uint16_t seqnum;
+            uint16_t block_count; // blocks written in the current batch
+            bool header_sent;
         };
 
         void rotate_to_next_sensor();
@@ -385,12 +428,18 @@ public:
         bool should_log(uint8_t instance, IMU_SENSOR_TYPE type);
         void push_data_to_log();
 
+        void init_streaming();
+        void sample_streaming(uint8_t instance, IMU_SENSOR_TYPE type, uint64_t sample_us, const Vector3f &sample);
+        void push_streams_to_log();
+        float sample_rate_hz(uint8_t instance, IMU_SENSOR_TYPE type) const;
+
         uint64_t measurement_started_us;
 
         bool initialised : 1;
         bool isbh_sent : 1;
         bool _doing_sensor_rate_logging : 1;
         bool _doing_post_filter_logging : 1;
+        bool _streaming : 1;
         uint8_t instance : 3; // instance we are sending data for
         AP_InertialSensor::IMU_SENSOR_TYPE type : 1;
         uint16_t isb_seqnum;
@@ -404,11 +453,74 @@ public:
         // all samples are multiplied by this
         uint16_t multiplier; // initialised as part of init()
 
+        // streaming mode state, indexed by instance and sensor type
+        isb_stream *streams[INS_MAX_INSTANCES][2];
+        uint32_t last_stream_stats_ms;
+        uint8_t next_stream; // stream to drain first on the next push
+
         const AP_InertialSensor &_imu;
     };
     BatchSampler batchsampler{*this};
 
 private:
+    /*
+      lock-free handoff of one gyro or accel from the backend sample
+      path to the main loop. The sample path integrates into its own
+      accumulator and publishes a snapshot after every sample. The main
+      loop takes the latest snapshot and tells the sample path how much
+      of the accumulator it has taken, which the sample path then drops
+     */
+    class SampleChannel {
+    public:
+        // sample path: drop whatever the main loop has taken so far,
+        // called before each new sample
+        void sync();
+        // sample path: integrated value not yet taken by the main loop
+        const Vector3f &accumulated() const { return _acc; }
+        // sample path: throw away the integrated value, e.g. after a gap
+        void discard();
+        // sample path: integrate a sample and publish the latest state
+        void publish(const Vector3f &delta, float dt, const Vector3f &filtered, const Vector3f &raw);
+
+        // main loop: true if a sample has been published since the last take()
+        bool available() const { return _snapshot.fresh(); }
+        // main loop: get the latest filtered and raw values and what has been
+        // integrated since the last take(). Returns false if nothing is new
+        bool take(Vector3f &filtered, Vector3f &raw, Vector3f &delta, float &delta_dt);
+
+    private:
+        struct snapshot {
+            Vector3f filtered;
+            Vector3f raw;
+            Vector3f acc;
+            float acc_dt;
+            // what was dropped from the accumulator when the
+            // generation last moved on
+            Vector3f dropped;
+            float dropped_dt;
+            uint8_t generation;
+        };
+        struct taken {
+            Vector3f acc;
+            float acc_dt;
+            uint8_t generation;
+        };
+        TripleBuffer<snapshot> _snapshot;
+        TripleBuffer<taken> _taken;
+
+        // owned by the sample path
+        Vector3f _acc;
+        float _acc_dt;
+        Vector3f _dropped;
+        float _dropped_dt;
+        uint8_t _generation;
+
+        // owned by the main loop
+        Vector3f _last_acc;
+        float _last_acc_dt;
+        uint8_t _last_generation;
+    };
+
     // load backend drivers
     bool _add_backend(AP_InertialSensor_Backend *backend);
     void _start_backends();
@@ -446,10 +558,6 @@ private:
     Vector3f _delta_velocity[INS_MAX_INSTANCES];
     float _delta_velocity_dt[INS_MAX_INSTANCES];
     bool _delta_velocity_valid[INS_MAX_INSTANCES];
-    // delta velocity accumulator
-    Vector3f _delta_velocity_acc[INS_MAX_INSTANCES];
-    // time accumulator for delta velocity accumulator
-    float _delta_velocity_acc_dt[INS_MAX_INSTANCES];
 
     // Low Pass filters for gyro and accel
     LowPassFilter2pVector3f _accel_filter[INS_MAX_INSTANCES];
@@ -462,28 +570,25 @@ private:
     FloatBuffer _gyro_window[INS_MAX_INSTANCES][XYZ_AXIS_COUNT];
     uint16_t _gyro_window_size;
 #endif
-    bool _new_accel_data[INS_MAX_INSTANCES];
-    bool _new_gyro_data[INS_MAX_INSTANCES];
+    // samples and their integrals handed from the backends to the main loop
+    SampleChannel _accel_channel[INS_MAX_INSTANCES];
+    SampleChannel _gyro_channel[INS_MAX_INSTANCES];
 
     // optional notch filter on gyro
     NotchFilterParams _notch_filter;
     NotchFilterVector3f _gyro_notch_filter[INS_MAX_INSTANCES];
 
-    // optional harmonic notch filter on gyro
-    HarmonicNotchFilterParams _harmonic_notch_filter;
-    HarmonicNotchFilterVector3f _gyro_harmonic_notch_filter[INS_MAX_INSTANCES];
-    // the current center frequency for the notch
-    float _calculated_harmonic_notch_freq_hz[INS_MAX_NOTCHES];
-    uint8_t _num_calculated_harmonic_notch_frequencies;
+    // the notch, harmonic notch banks and low pass filters run as a
+    // single cascade on the sample path. The coefficients are designed
+    // from the filters above in the main loop and handed over lock-free
+    BiquadCascadeVector3f _gyro_filter_chain[INS_MAX_INSTANCES];
+    TripleBuffer<BiquadCascadeCoefficients> _gyro_filter_coeffs[INS_MAX_INSTANCES];
 
     // Most recent gyro reading
     Vector3f _gyro[INS_MAX_INSTANCES];
     Vector3f _delta_angle[INS_MAX_INSTANCES];
     float _delta_angle_dt[INS_MAX_INSTANCES];
     bool _delta_angle_valid[INS_MAX_INSTANCES];
-    // time accumulator for delta angle accumulator
-    float _delta_angle_acc_dt[INS_MAX_INSTANCES];
-    Vector3f _delta_angle_acc[INS_MAX_INSTANCES];
     Vector3f _last_delta_angle[INS_MAX_INSTANCES];
     Vector3f _last_raw_gyro[INS_MAX_INSTANCES];
 
@@ -597,6 +702,17 @@ private:
     // time between samples in microseconds
     uint32_t _sample_period_usec;
 
+    // time wait_for_sample() spent waiting for sensor data once a
+    // sample was due, logged once a second
+    struct {
+        uint32_t count;
+        uint32_t sum_us;
+        uint32_t max_us;
+        uint32_t timeouts;
+        uint32_t last_log_ms;
+    } _wait_stats;
+    void log_wait_stats();
+
     // last time update() completed
     uint32_t _last_update_usec;
 
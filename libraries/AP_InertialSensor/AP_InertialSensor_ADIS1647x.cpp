@@ -272,16 +272,18 @@ void AP_InertialSensor_ADIS1647x::read_sensor(void)
     done_first_read = true;
     last_counter = counter;
 
-    Vector3f accel{float(int16_t(be16toh(data.ax))), float(int16_t(be16toh(data.ay))), float(int16_t(be16toh(data.az)))};
-    Vector3f gyro{float(int16_t(be16toh(data.gx))), float(int16_t(be16toh(data.gy))), float(int16_t(be16toh(data.gz)))};
-
-    accel *= accel_scale;
-    gyro *= gyro_scale;
-
-    _rotate_and_correct_accel(accel_instance, accel);
+    // the burst is a single big endian sample, words counted from gx
+    static const FIFOAxisLayout gyro_layout {{0, 1, 2}, {1, 1, 1}, true};
+    static const FIFOAxisLayout accel_layout {{3, 4, 5}, {1, 1, 1}, true};
+    const uint8_t *burst = (const uint8_t *)&data.gx;
+    Vector3f accel, gyro;
+    _convert_fifo_block(burst, sizeof(data), 1, accel_layout, &accel);
+    _convert_fifo_block(burst, sizeof(data), 1, gyro_layout, &gyro);
+
+    _rotate_and_correct_accel_block(accel_instance, &accel, 1, accel_scale);
     _notify_new_accel_raw_sample(accel_instance, accel, sample_start_us);
 
-    _rotate_and_correct_gyro(gyro_instance, gyro);
+    _rotate_and_correct_gyro_block(gyro_instance, &gyro, 1, gyro_scale);
     _notify_new_gyro_raw_sample(gyro_instance, gyro, sample_start_us);
 
     /*
@@ -59,8 +59,15 @@
 #define ACCEL_BACKEND_SAMPLE_RATE   1600
 #define GYRO_BACKEND_SAMPLE_RATE    2000
 
+// accel FIFO frames are 7 bytes, plus two bytes of SPI read header
+#define ACCEL_FIFO_BUFFER_LEN (2 + BMI088_FIFO_MAX_FRAMES*7)
+#define GYRO_FIFO_BUFFER_LEN  (BMI088_FIFO_MAX_FRAMES*6)
+
 extern const AP_HAL::HAL& hal;
 
+// both sensors give little endian x, y, z words
+const AP_InertialSensor_BMI088::FIFOAxisLayout AP_InertialSensor_BMI088::fifo_layout {{0, 1, 2}, {1, 1, 1}, false};
+
 AP_InertialSensor_BMI088::AP_InertialSensor_BMI088(AP_InertialSensor &imu,
                                                    AP_HAL::OwnPtr<AP_HAL::Device> _dev_accel,
                                                    AP_HAL::OwnPtr<AP_HAL::Device> _dev_gyro,
@@ -72,6 +79,16 @@ AP_InertialSensor_BMI088::AP_InertialSensor_BMI088(AP_InertialSensor &imu,
 {
 }
 
+AP_InertialSensor_BMI088::~AP_InertialSensor_BMI088()
+{
+    if (accel_fifo_buffer != nullptr) {
+        hal.util->free_type(accel_fifo_buffer, ACCEL_FIFO_BUFFER_LEN, AP_HAL::Util::MEM_DMA_SAFE);
+    }
+    if (gyro_fifo_buffer != nullptr) {
+        hal.util->free_type(gyro_fifo_buffer, GYRO_FIFO_BUFFER_LEN, AP_HAL::Util::MEM_DMA_SAFE);
+    }
+}
+
 AP_InertialSensor_Backend *
 AP_InertialSensor_BMI088::probe(AP_InertialSensor &imu,
                                 AP_HAL::OwnPtr<AP_HAL::Device> dev_accel,
@@ -104,6 +121,13 @@ void AP_InertialSensor_BMI088::start()
     set_gyro_orientation(gyro_instance, rotation);
     set_accel_orientation(accel_instance, rotation);
 
+    // allocate fifo buffers
+    accel_fifo_buffer = (uint8_t *)hal.util->malloc_type(ACCEL_FIFO_BUFFER_LEN, AP_HAL::Util::MEM_DMA_SAFE);
+    gyro_fifo_buffer = (uint8_t *)hal.util->malloc_type(GYRO_FIFO_BUFFER_LEN, AP_HAL::Util::MEM_DMA_SAFE);
+    if (accel_fifo_buffer == nullptr || gyro_fifo_buffer == nullptr) {
+        AP_HAL::panic("BMI088: Unable to allocate FIFO buffer");
+    }
+
     // setup callbacks
     dev_accel->register_periodic_callback(1000000UL / ACCEL_BACKEND_SAMPLE_RATE,
                                           FUNCTOR_BIND_MEMBER(&AP_InertialSensor_BMI088::read_fifo_accel, void));
@@ -290,43 +314,50 @@ void AP_InertialSensor_BMI088::read_fifo_accel(void)
     }
 
     // don't read more than 8 frames at a time
-    if (fifo_length > 8*7) {
-        fifo_length = 8*7;
+    if (fifo_length > BMI088_FIFO_MAX_FRAMES*7) {
+        fifo_length = BMI088_FIFO_MAX_FRAMES*7;
     }
     if (fifo_length == 0) {
         return;
     }
-    
-    uint8_t data[fifo_length];
-    if (!read_accel_registers(REGA_FIFO_DATA, data, fifo_length)) {
-        _inc_accel_error_count(accel_instance);
-        return;
+
+    /*
+      read straight into the DMA safe buffer. On SPI the first two
+      bytes are the register and the dummy byte the sensor sends
+      before the data
+     */
+    uint8_t *data = accel_fifo_buffer + 2;
+    if (dev_accel->bus_type() != AP_HAL::Device::BUS_TYPE_SPI) {
+        if (!dev_accel->read_registers(REGA_FIFO_DATA, data, fifo_length)) {
+            _inc_accel_error_count(accel_instance);
+            return;
+        }
+    } else {
+        accel_fifo_buffer[0] = REGA_FIFO_DATA | 0x80;
+        memset(&accel_fifo_buffer[1], 0, fifo_length+1);
+        if (!dev_accel->transfer(accel_fifo_buffer, fifo_length+2, accel_fifo_buffer, fifo_length+2)) {
+            _inc_accel_error_count(accel_instance);
+            return;
+        }
     }
-    // assume configured for 24g range
-    const float scale = (1.0/32768.0) * GRAVITY_MSS * 24.0;
-    const uint8_t *p = &data[0];
+
+    /*
+      the fifo frames are variable length, with the frame type in the
+      first byte. Pack the accel payloads together at the start of the
+      buffer so they can be converted as one block. The packed data
+      never overtakes the frame being parsed
+     */
+    uint8_t n_accel = 0;
+    const uint8_t *p = data;
     while (fifo_length >= 7) {
-        /*
-          the fifo frames are variable length, with the frame type in the first byte
-         */
         uint8_t frame_len = 2;
         switch (p[0] & 0xFC) {
-        case 0x84: {
+        case 0x84:
             // accel frame
             frame_len = 7;
-            const uint8_t *d = p+1;
-            int16_t xyz[3] {
-                int16_t(uint16_t(d[0] | (d[1]<<8))),
-                int16_t(uint16_t(d[2] | (d[3]<<8))),
-                int16_t(uint16_t(d[4] | (d[5]<<8)))};
-            Vector3f accel(xyz[0], xyz[1], xyz[2]);
-
-            accel *= scale;
-
-            _rotate_and_correct_accel(accel_instance, accel);
-            _notify_new_accel_raw_sample(accel_instance, accel);
+            memmove(&accel_fifo_buffer[6*n_accel], p+1, 6);
+            n_accel++;
             break;
-        }
         case 0x40:
             // skip frame
             frame_len = 2;
@@ -348,6 +379,14 @@ void AP_InertialSensor_BMI088::read_fifo_accel(void)
         fifo_length -= frame_len;
     }
 
+    // assume configured for 24g range
+    const float scale = (1.0/32768.0) * GRAVITY_MSS * 24.0;
+    _convert_fifo_block(accel_fifo_buffer, 6, n_accel, fifo_layout, accel_block);
+    _rotate_and_correct_accel_block(accel_instance, accel_block, n_accel, scale);
+    for (uint8_t i = 0; i < n_accel; i++) {
+        _notify_new_accel_raw_sample(accel_instance, accel_block[i]);
+    }
+
     if (temperature_counter++ == 100) {
         temperature_counter = 0;
         uint8_t tbuf[2];
@@ -375,31 +414,23 @@ void AP_InertialSensor_BMI088::read_fifo_gyro(void)
     num_frames &= 0x7F;
     
     // don't read more than 8 frames at a time
-    if (num_frames > 8) {
-        num_frames = 8;
+    if (num_frames > BMI088_FIFO_MAX_FRAMES) {
+        num_frames = BMI088_FIFO_MAX_FRAMES;
     }
     if (num_frames == 0) {
         return;
     }
-    uint8_t data[6*num_frames];
-    if (!dev_gyro->read_registers(REGG_FIFO_DATA, data, num_frames*6)) {
+    if (!dev_gyro->read_registers(REGG_FIFO_DATA, gyro_fifo_buffer, num_frames*6)) {
         _inc_gyro_error_count(gyro_instance);
         return;
     }
 
     // data is 16 bits with 2000dps range
     const float scale = radians(2000.0f) / 32767.0f;
+    _convert_fifo_block(gyro_fifo_buffer, 6, num_frames, fifo_layout, gyro_block);
+    _rotate_and_correct_gyro_block(gyro_instance, gyro_block, num_frames, scale);
     for (uint8_t i = 0; i < num_frames; i++) {
-        const uint8_t *d = &data[i*6];
-        int16_t xyz[3] {
-                    int16_t(uint16_t(d[0] | d[1]<<8)),
-                    int16_t(uint16_t(d[2] | d[3]<<8)),
-                    int16_t(uint16_t(d[4] | d[5]<<8)) };
-        Vector3f gyro(xyz[0], xyz[1], xyz[2]);
-        gyro *= scale;
-
-        _rotate_and_correct_gyro(gyro_instance, gyro);
-        _notify_new_gyro_raw_sample(gyro_instance, gyro);
+        _notify_new_gyro_raw_sample(gyro_instance, gyro_block[i]);
     }
 
     if (!dev_gyro->check_next_register()) {
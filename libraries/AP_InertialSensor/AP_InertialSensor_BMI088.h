@@ -23,6 +23,9 @@
 #include "AP_InertialSensor.h"
 #include "AP_InertialSensor_Backend.h"
 
+// most FIFO frames read from each sensor in one go
+#define BMI088_FIFO_MAX_FRAMES 8
+
 class AP_InertialSensor_BMI088 : public AP_InertialSensor_Backend {
 public:
     static AP_InertialSensor_Backend *probe(AP_InertialSensor &imu,
@@ -36,6 +39,8 @@ public:
     void start() override;
     bool update() override;
 
+    virtual ~AP_InertialSensor_BMI088();
+
 private:
     AP_InertialSensor_BMI088(AP_InertialSensor &imu,
                              AP_HAL::OwnPtr<AP_HAL::Device> dev_accel,
@@ -84,4 +89,13 @@ private:
 
     bool done_accel_config;
     uint32_t accel_config_count;
+
+    // DMA safe buffers for fifo reads
+    uint8_t *accel_fifo_buffer;
+    uint8_t *gyro_fifo_buffer;
+
+    // fifo frames converted to vectors
+    Vector3f accel_block[BMI088_FIFO_MAX_FRAMES];
+    Vector3f gyro_block[BMI088_FIFO_MAX_FRAMES];
+    static const FIFOAxisLayout fifo_layout;
 };
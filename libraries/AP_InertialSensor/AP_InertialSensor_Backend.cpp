@@ -10,6 +10,9 @@
 
 #define SENSOR_RATE_DEBUG 0
 
+// shortest block worth transforming with a single combined matrix
+#define FIFO_BLOCK_MIN_SAMPLES 4
+
 const extern AP_HAL::HAL& hal;
 
 AP_InertialSensor_Backend::AP_InertialSensor_Backend(AP_InertialSensor &imu) :
@@ -105,11 +108,7 @@ void AP_InertialSensor_Backend::_rotate_and_correct_accel(uint8_t instance, Vect
     accel.z *= accel_scale.z;
 
     // rotate to body frame
-    if (_imu._board_orientation == ROTATION_CUSTOM && _imu._custom_rotation) {
-        accel = *_imu._custom_rotation * accel;
-    } else {
-        accel.rotate(_imu._board_orientation);
-    }
+    _rotate_to_body(accel);
 }
 
 void AP_InertialSensor_Backend::_rotate_and_correct_gyro(uint8_t instance, Vector3f &gyro) 
@@ -120,17 +119,124 @@ void AP_InertialSensor_Backend::_rotate_and_correct_gyro(uint8_t instance, Vecto
     // gyro calibration is always assumed to have been done in sensor frame
     gyro -= _imu._gyro_offset[instance];
 
+    _rotate_to_body(gyro);
+}
+
+/*
+  rotate a sensor frame vector by the board orientation
+ */
+void AP_InertialSensor_Backend::_rotate_to_body(Vector3f &v) const
+{
     if (_imu._board_orientation == ROTATION_CUSTOM && _imu._custom_rotation) {
-        gyro = *_imu._custom_rotation * gyro;
+        v = *_imu._custom_rotation * v;
     } else {
-        gyro.rotate(_imu._board_orientation);
+        v.rotate(_imu._board_orientation);
+    }
+}
+
+/*
+  convert a block of raw FIFO frames into unscaled sensor frame
+  vectors. Each frame is stride bytes long and holds the three axes
+  as 16 bit words at the positions given by the layout
+ */
+void AP_InertialSensor_Backend::_convert_fifo_block(const uint8_t *frames, uint16_t stride, uint16_t n,
+                                                    const FIFOAxisLayout &layout, Vector3f *out)
+{
+    for (uint16_t i = 0; i < n; i++) {
+        const uint8_t *d = frames + i * stride;
+        int32_t v[3];
+        for (uint8_t axis = 0; axis < 3; axis++) {
+            const uint8_t *w = d + 2 * layout.word[axis];
+            const int16_t raw = layout.big_endian ?
+                int16_t(uint16_t((w[0] << 8) | w[1])) :
+                int16_t(uint16_t(w[0] | (w[1] << 8)));
+            v[axis] = layout.sign[axis] * raw;
+        }
+        out[i] = Vector3f(v[0], v[1], v[2]);
+    }
+}
+
+/*
+  build the transform equivalent to multiplying a raw sample by scale
+  and then rotating and correcting it. The sensor orientation, axis
+  scaling and board orientation become one matrix and the offsets a
+  bias. Columns come from transforming the axis vectors, so rotations
+  that only permute axes stay exact
+ */
+void AP_InertialSensor_Backend::_block_transform(enum Rotation orientation, const Vector3f &offset,
+                                                 const Vector3f &axis_scale, float scale,
+                                                 Matrix3f &m, Vector3f &bias) const
+{
+    for (uint8_t i = 0; i < 3; i++) {
+        Vector3f col;
+        col[i] = scale;
+        col.rotate(orientation);
+        col.x *= axis_scale.x;
+        col.y *= axis_scale.y;
+        col.z *= axis_scale.z;
+        _rotate_to_body(col);
+        m.a[i] = col.x;
+        m.b[i] = col.y;
+        m.c[i] = col.z;
+    }
+    bias = offset;
+    bias.x *= axis_scale.x;
+    bias.y *= axis_scale.y;
+    bias.z *= axis_scale.z;
+    _rotate_to_body(bias);
+}
+
+void AP_InertialSensor_Backend::_apply_block_transform(const Matrix3f &m, const Vector3f &bias, Vector3f *v, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++) {
+        v[i] = m * v[i] - bias;
+    }
+}
+
+/*
+  scale, rotate and correct a block of accel samples. Short blocks are
+  done one sample at a time as building the transform costs about as
+  much as transforming three samples
+ */
+void AP_InertialSensor_Backend::_rotate_and_correct_accel_block(uint8_t instance, Vector3f *accel, uint16_t n, float scale)
+{
+    if (n < FIFO_BLOCK_MIN_SAMPLES) {
+        for (uint16_t i = 0; i < n; i++) {
+            accel[i] *= scale;
+            _rotate_and_correct_accel(instance, accel[i]);
+        }
+        return;
+    }
+    Matrix3f m;
+    Vector3f bias;
+    _block_transform(_imu._accel_orientation[instance], _imu._accel_offset[instance],
+                     _imu._accel_scale[instance].get(), scale, m, bias);
+    _apply_block_transform(m, bias, accel, n);
+}
+
+/*
+  scale, rotate and correct a block of gyro samples
+ */
+void AP_InertialSensor_Backend::_rotate_and_correct_gyro_block(uint8_t instance, Vector3f *gyro, uint16_t n, float scale)
+{
+    if (n < FIFO_BLOCK_MIN_SAMPLES) {
+        for (uint16_t i = 0; i < n; i++) {
+            gyro[i] *= scale;
+            _rotate_and_correct_gyro(instance, gyro[i]);
+        }
+        return;
     }
+    Matrix3f m;
+    Vector3f bias;
+    _block_transform(_imu._gyro_orientation[instance], _imu._gyro_offset[instance],
+                     Vector3f(1, 1, 1), scale, m, bias);
+    _apply_block_transform(m, bias, gyro, n);
 }
 
 /*
   rotate gyro vector and add the gyro offset
  */
-void AP_InertialSensor_Backend::_publish_gyro(uint8_t instance, const Vector3f &gyro)
+void AP_InertialSensor_Backend::_publish_gyro(uint8_t instance, const Vector3f &gyro, const Vector3f &delta_angle, float delta_angle_dt)
 {
     if ((1U<<instance) & _imu.imu_kill_mask) {
         return;
@@ -139,8 +245,8 @@ void AP_InertialSensor_Backend::_publish_gyro(uint8_t instance, const Vector3f &
     _imu._gyro_healthy[instance] = true;
 
     // publish delta angle
-    _imu._delta_angle[instance] = _imu._delta_angle_acc[instance];
-    _imu._delta_angle_dt[instance] = _imu._delta_angle_acc_dt[instance];
+    _imu._delta_angle[instance] = delta_angle;
+    _imu._delta_angle_dt[instance] = delta_angle_dt;
     _imu._delta_angle_valid[instance] = true;
 }
 
@@ -190,6 +296,16 @@ void AP_InertialSensor_Backend::_notify_new_gyro_raw_sample(uint8_t instance,
         hal.opticalflow->push_gyro(gyro.x, gyro.y, dt);
     }
     
+    AP_InertialSensor::SampleChannel &channel = _imu._gyro_channel[instance];
+    channel.sync();
+
+    uint64_t now = AP_HAL::micros64();
+    if (now - last_sample_us > 100000U) {
+        // zero accumulator if sensor was unhealthy for 0.1s
+        channel.discard();
+        dt = 0;
+    }
+
     // compute delta angle
     Vector3f delta_angle = (gyro + _imu._last_raw_gyro[instance]) * 0.5f * dt;
 
@@ -198,69 +314,45 @@ void AP_InertialSensor_Backend::_notify_new_gyro_raw_sample(uint8_t instance,
     // Tian et al (2010) Three-loop Integration of GPS and Strapdown INS with Coning and Sculling Compensation
     // Available: http://www.sage.unsw.edu.au/snap/publications/tian_etal2010b.pdf
     // see also examples/coning.py
-    Vector3f delta_coning = (_imu._delta_angle_acc[instance] +
+    Vector3f delta_coning = (channel.accumulated() +
                              _imu._last_delta_angle[instance] * (1.0f / 6.0f));
     delta_coning = delta_coning % delta_angle;
     delta_coning *= 0.5f;
 
-    {
-        WITH_SEMAPHORE(_sem);
-        uint64_t now = AP_HAL::micros64();
-
-        if (now - last_sample_us > 100000U) {
-            // zero accumulator if sensor was unhealthy for 0.1s
-            _imu._delta_angle_acc[instance].zero();
-            _imu._delta_angle_acc_dt[instance] = 0;
-            dt = 0;
-            delta_angle.zero();
-        }
-
-        // integrate delta angle accumulator
-        // the angles and coning corrections are accumulated separately in the
-        // referenced paper, but in simulation little difference was found between
-        // integrating together and integrating separately (see examples/coning.py)
-        _imu._delta_angle_acc[instance] += delta_angle + delta_coning;
-        _imu._delta_angle_acc_dt[instance] += dt;
-
-        // save previous delta angle for coning correction
-        _imu._last_delta_angle[instance] = delta_angle;
-        _imu._last_raw_gyro[instance] = gyro;
+    // save previous delta angle for coning correction
+    _imu._last_delta_angle[instance] = delta_angle;
+    _imu._last_raw_gyro[instance] = gyro;
 #if HAL_WITH_DSP
-        // capture gyro window for FFT analysis
-        if (_imu._gyro_window_size > 0) {
-            const Vector3f& scaled_gyro = gyro * _imu._gyro_raw_sampling_multiplier[instance];
-            _imu._gyro_window[instance][0].push(scaled_gyro.x);
-            _imu._gyro_window[instance][1].push(scaled_gyro.y);
-            _imu._gyro_window[instance][2].push(scaled_gyro.z);
-        }
+    // capture gyro window for FFT analysis
+    if (_imu._gyro_window_size > 0) {
+        const Vector3f& scaled_gyro = gyro * _imu._gyro_raw_sampling_multiplier[instance];
+        _imu._gyro_window[instance][0].push(scaled_gyro.x);
+        _imu._gyro_window[instance][1].push(scaled_gyro.y);
+        _imu._gyro_window[instance][2].push(scaled_gyro.z);
+    }
 #endif
-        Vector3f gyro_filtered = gyro;
-
-        // apply the notch filter
-        if (_gyro_notch_enabled()) {
-            gyro_filtered = _imu._gyro_notch_filter[instance].apply(gyro_filtered);
-        }
-
-        // apply the harmonic notch filter
-        if (gyro_harmonic_notch_enabled()) {
-            gyro_filtered = _imu._gyro_harmonic_notch_filter[instance].apply(gyro_filtered);
-        }
 
-        // apply the low pass filter last to attentuate any notch induced noise
-        gyro_filtered = _imu._gyro_filter[instance].apply(gyro_filtered);
+    // pick up any new coefficients designed in update_gyro()
+    TripleBuffer<BiquadCascadeCoefficients> &coeffs = _imu._gyro_filter_coeffs[instance];
+    coeffs.update();
 
-        // if the filtering failed in any way then reset the filters and keep the old value
-        if (gyro_filtered.is_nan() || gyro_filtered.is_inf()) {
-            _imu._gyro_filter[instance].reset();
-            _imu._gyro_notch_filter[instance].reset();
-            _imu._gyro_harmonic_notch_filter[instance].reset();
-        } else {
-            _imu._gyro_filtered[instance] = gyro_filtered;
-        }
+    // apply the notch, harmonic notch and then the low pass filter to
+    // attenuate any notch induced noise
+    Vector3f gyro_filtered = _imu._gyro_filter_chain[instance].apply(coeffs.front(), gyro);
 
-        _imu._new_gyro_data[instance] = true;
+    // if the filtering failed in any way then reset the filters and keep the old value
+    if (gyro_filtered.is_nan() || gyro_filtered.is_inf()) {
+        _imu._gyro_filter_chain[instance].reset();
+    } else {
+        _imu._gyro_filtered[instance] = gyro_filtered;
     }
 
+    // integrate delta angle accumulator and hand the sample to the main
+    // loop. The angles and coning corrections are accumulated separately in the
+    // referenced paper, but in simulation little difference was found between
+    // integrating together and integrating separately (see examples/coning.py)
+    channel.publish(delta_angle + delta_coning, dt, _imu._gyro_filtered[instance], gyro);
+
     if (!_imu.batchsampler.doing_post_filter_logging()) {
         log_gyro_raw(instance, sample_us, gyro);
     }
@@ -288,7 +380,7 @@ void AP_InertialSensor_Backend::log_gyro_raw(uint8_t instance, const uint64_t sa
         };
         logger->WriteBlock(&pkt, sizeof(pkt));
     } else {
-        if (!_imu.batchsampler.doing_sensor_rate_logging()) {
+        if (!_imu.batchsampler.doing_sensor_rate_logging(instance, AP_InertialSensor::IMU_SENSOR_TYPE_GYRO)) {
             _imu.batchsampler.sample(instance, AP_InertialSensor::IMU_SENSOR_TYPE_GYRO, sample_us, gyro);
         }
     }
@@ -297,7 +389,7 @@ void AP_InertialSensor_Backend::log_gyro_raw(uint8_t instance, const uint64_t sa
 /*
   rotate accel vector, scale and add the accel offset
  */
-void AP_InertialSensor_Backend::_publish_accel(uint8_t instance, const Vector3f &accel)
+void AP_InertialSensor_Backend::_publish_accel(uint8_t instance, const Vector3f &accel, const Vector3f &delta_velocity, float delta_velocity_dt)
 {
     if ((1U<<instance) & _imu.imu_kill_mask) {
         return;
@@ -306,8 +398,8 @@ void AP_InertialSensor_Backend::_publish_accel(uint8_t instance, const Vector3f
     _imu._accel_healthy[instance] = true;
 
     // publish delta velocity
-    _imu._delta_velocity[instance] = _imu._delta_velocity_acc[instance];
-    _imu._delta_velocity_dt[instance] = _imu._delta_velocity_acc_dt[instance];
+    _imu._delta_velocity[instance] = delta_velocity;
+    _imu._delta_velocity_dt[instance] = delta_velocity_dt;
     _imu._delta_velocity_valid[instance] = true;
 
 
@@ -374,31 +466,32 @@ void AP_InertialSensor_Backend::_notify_new_accel_raw_sample(uint8_t instance,
     
     _imu.calc_vibration_and_clipping(instance, accel, dt);
 
-    {
-        WITH_SEMAPHORE(_sem);
+    AP_InertialSensor::SampleChannel &channel = _imu._accel_channel[instance];
+    channel.sync();
 
-        uint64_t now = AP_HAL::micros64();
+    uint64_t now = AP_HAL::micros64();
+    if (now - last_sample_us > 100000U) {
+        // zero accumulator if sensor was unhealthy for 0.1s
+        channel.discard();
+        dt = 0;
+    }
 
-        if (now - last_sample_us > 100000U) {
-            // zero accumulator if sensor was unhealthy for 0.1s
-            _imu._delta_velocity_acc[instance].zero();
-            _imu._delta_velocity_acc_dt[instance] = 0;
-            dt = 0;
-        }
-        
-        // delta velocity
-        _imu._delta_velocity_acc[instance] += accel * dt;
-        _imu._delta_velocity_acc_dt[instance] += dt;
+    // possibly update filter frequency. This is only a parameter
+    // change, so is cheap enough to check here where the filter runs
+    if (_last_accel_filter_hz != _accel_filter_cutoff()) {
+        _imu._accel_filter[instance].set_cutoff_frequency(_accel_raw_sample_rate(instance), _accel_filter_cutoff());
+        _last_accel_filter_hz = _accel_filter_cutoff();
+    }
 
-        _imu._accel_filtered[instance] = _imu._accel_filter[instance].apply(accel);
-        if (_imu._accel_filtered[instance].is_nan() || _imu._accel_filtered[instance].is_inf()) {
-            _imu._accel_filter[instance].reset();
-        }
+    _imu._accel_filtered[instance] = _imu._accel_filter[instance].apply(accel);
+    if (_imu._accel_filtered[instance].is_nan() || _imu._accel_filtered[instance].is_inf()) {
+        _imu._accel_filter[instance].reset();
+    }
 
-        _imu.set_accel_peak_hold(instance, _imu._accel_filtered[instance]);
+    _imu.set_accel_peak_hold(instance, _imu._accel_filtered[instance]);
 
-        _imu._new_accel_data[instance] = true;
-    }
+    // integrate delta velocity and hand the sample to the main loop
+    channel.publish(accel * dt, dt, _imu._accel_filtered[instance], accel);
 
     if (!_imu.batchsampler.doing_post_filter_logging()) {
         log_accel_raw(instance, sample_us, accel);
@@ -409,7 +502,7 @@ void AP_InertialSensor_Backend::_notify_new_accel_raw_sample(uint8_t instance,
 
 void AP_InertialSensor_Backend::_notify_new_accel_sensor_rate_sample(uint8_t instance, const Vector3f &accel)
 {
-    if (!_imu.batchsampler.doing_sensor_rate_logging()) {
+    if (!_imu.batchsampler.doing_sensor_rate_logging(instance, AP_InertialSensor::IMU_SENSOR_TYPE_ACCEL)) {
         return;
     }
 
@@ -418,7 +511,7 @@ void AP_InertialSensor_Backend::_notify_new_accel_sensor_rate_sample(uint8_t ins
 
 void AP_InertialSensor_Backend::_notify_new_gyro_sensor_rate_sample(uint8_t instance, const Vector3f &gyro)
 {
-    if (!_imu.batchsampler.doing_sensor_rate_logging()) {
+    if (!_imu.batchsampler.doing_sensor_rate_logging(instance, AP_InertialSensor::IMU_SENSOR_TYPE_GYRO)) {
         return;
     }
     _imu.batchsampler.sample(instance, AP_InertialSensor::IMU_SENSOR_TYPE_GYRO, AP_HAL::micros64(), gyro);
@@ -443,7 +536,7 @@ void AP_InertialSensor_Backend::log_accel_raw(uint8_t instance, const uint64_t s
         };
         logger->WriteBlock(&pkt, sizeof(pkt));
     } else {
-        if (!_imu.batchsampler.doing_sensor_rate_logging()) {
+        if (!_imu.batchsampler.doing_sensor_rate_logging(instance, AP_InertialSensor::IMU_SENSOR_TYPE_ACCEL)) {
             _imu.batchsampler.sample(instance, AP_InertialSensor::IMU_SENSOR_TYPE_ACCEL, sample_us, accel);
         }
     }
@@ -512,41 +605,52 @@ void AP_InertialSensor_Backend::_publish_temperature(uint8_t instance, float tem
  */
 void AP_InertialSensor_Backend::update_gyro(uint8_t instance)
 {    
-    WITH_SEMAPHORE(_sem);
-
     if ((1U<<instance) & _imu.imu_kill_mask) {
         return;
     }
-    if (_imu._new_gyro_data[instance]) {
-        _publish_gyro(instance, _imu._gyro_filtered[instance]);
+    Vector3f gyro, raw_gyro, delta_angle;
+    float delta_angle_dt;
+    if (_imu._gyro_channel[instance].take(gyro, raw_gyro, delta_angle, delta_angle_dt)) {
+        _publish_gyro(instance, gyro, delta_angle, delta_angle_dt);
         // copy the gyro samples from the backend to the frontend window
 #if HAL_WITH_DSP
-        _imu._gyro_raw[instance] = _imu._last_raw_gyro[instance] * _imu._gyro_raw_sampling_multiplier[instance];
+        _imu._gyro_raw[instance] = raw_gyro * _imu._gyro_raw_sampling_multiplier[instance];
 #endif
-        _imu._new_gyro_data[instance] = false;
     }
 
+    bool filters_changed = false;
+
     // possibly update filter frequency
     if (_last_gyro_filter_hz != _gyro_filter_cutoff() || sensors_converging()) {
         _imu._gyro_filter[instance].set_cutoff_frequency(_gyro_raw_sample_rate(instance), _gyro_filter_cutoff());
         _last_gyro_filter_hz = _gyro_filter_cutoff();
-    }
-
-    // possily update the harmonic notch filter parameters
-    if (!is_equal(_last_harmonic_notch_bandwidth_hz, gyro_harmonic_notch_bandwidth_hz()) ||
-        !is_equal(_last_harmonic_notch_attenuation_dB, gyro_harmonic_notch_attenuation_dB()) ||
-        sensors_converging()) {
-        _imu._gyro_harmonic_notch_filter[instance].init(_gyro_raw_sample_rate(instance), gyro_harmonic_notch_center_freq_hz(), gyro_harmonic_notch_bandwidth_hz(), gyro_harmonic_notch_attenuation_dB());
-        _last_harmonic_notch_center_freq_hz = gyro_harmonic_notch_center_freq_hz();
-        _last_harmonic_notch_bandwidth_hz = gyro_harmonic_notch_bandwidth_hz();
-        _last_harmonic_notch_attenuation_dB = gyro_harmonic_notch_attenuation_dB();
-    } else if (!is_equal(_last_harmonic_notch_center_freq_hz, gyro_harmonic_notch_center_freq_hz())) {
-        if (num_gyro_harmonic_notch_center_frequencies() > 1) {
-            _imu._gyro_harmonic_notch_filter[instance].update(num_gyro_harmonic_notch_center_frequencies(), gyro_harmonic_notch_center_frequencies_hz());
-        } else {
-            _imu._gyro_harmonic_notch_filter[instance].update(gyro_harmonic_notch_center_freq_hz());
+        filters_changed = true;
+    }
+
+    // possily update the harmonic notch filter parameters of each bank
+    for (uint8_t i = 0; i < HAL_INS_NUM_HARMONIC_NOTCH_FILTERS; i++) {
+        AP_InertialSensor::HarmonicNotch &notch = _imu.harmonic_notches[i];
+        const float center_freq_hz = notch.calculated_freq_hz();
+        if (!is_equal(_last_harmonic_notch_bandwidth_hz[i], notch.params().bandwidth_hz()) ||
+            !is_equal(_last_harmonic_notch_attenuation_dB[i], notch.params().attenuation_dB()) ||
+            sensors_converging()) {
+            notch._filter[instance].init(_gyro_raw_sample_rate(instance), center_freq_hz, notch.params().bandwidth_hz(), notch.params().attenuation_dB());
+            _last_harmonic_notch_center_freq_hz[i] = center_freq_hz;
+            _last_harmonic_notch_bandwidth_hz[i] = notch.params().bandwidth_hz();
+            _last_harmonic_notch_attenuation_dB[i] = notch.params().attenuation_dB();
+            filters_changed = true;
+        } else if (!is_equal(_last_harmonic_notch_center_freq_hz[i], center_freq_hz)) {
+            if (notch.num_calculated_frequencies() > 1) {
+                notch._filter[instance].update(notch.num_calculated_frequencies(), notch.calculated_frequencies_hz());
+            } else {
+                notch._filter[instance].update(center_freq_hz);
+            }
+            _last_harmonic_notch_center_freq_hz[i] = center_freq_hz;
+            filters_changed = true;
+        }
+        if (_last_harmonic_notch_enabled[i] != notch.enabled()) {
+            filters_changed = true;
         }
-        _last_harmonic_notch_center_freq_hz = gyro_harmonic_notch_center_freq_hz();
     }
     // possily update the notch filter parameters
     if (!is_equal(_last_notch_center_freq_hz, _gyro_notch_center_freq_hz()) ||
@@ -557,28 +661,67 @@ void AP_InertialSensor_Backend::update_gyro(uint8_t instance)
         _last_notch_center_freq_hz = _gyro_notch_center_freq_hz();
         _last_notch_bandwidth_hz = _gyro_notch_bandwidth_hz();
         _last_notch_attenuation_dB = _gyro_notch_attenuation_dB();
+        filters_changed = true;
+    }
+
+    if (filters_changed || _last_notch_enabled != _gyro_notch_enabled()) {
+        update_gyro_filter_chain(instance);
     }
 }
 
+/*
+  hand the current gyro filter coefficients to the filter chain used on
+  the sample path. Only called when a filter has changed, so the sample
+  path never has to check the filter parameters. The sample path picks
+  up the new block on its next sample, neither side waits for the other
+ */
+void AP_InertialSensor_Backend::update_gyro_filter_chain(uint8_t instance)
+{
+    TripleBuffer<BiquadCascadeCoefficients> &chain_coeffs = _imu._gyro_filter_coeffs[instance];
+    // the back buffer holds an old block, so every stage is set again
+    BiquadCascadeCoefficients &chain = chain_coeffs.back();
+
+    chain.clear_notches();
+
+    // stage 0 is the static notch, each harmonic notch bank follows
+    // with its own fixed range of stages
+    _last_notch_enabled = _gyro_notch_enabled();
+    if (_last_notch_enabled) {
+        NotchFilterCoefficients coeffs;
+        _imu._gyro_notch_filter[instance].get_coefficients(coeffs);
+        chain.set_notch(0, coeffs);
+    }
+
+    for (uint8_t i = 0; i < HAL_INS_NUM_HARMONIC_NOTCH_FILTERS; i++) {
+        const AP_InertialSensor::HarmonicNotch &notch = _imu.harmonic_notches[i];
+        _last_harmonic_notch_enabled[i] = notch.enabled();
+        if (!_last_harmonic_notch_enabled[i]) {
+            continue;
+        }
+        NotchFilterCoefficients coeffs[HNF_MAX_FILTERS];
+        const uint8_t num_filters = notch._filter[instance].get_coefficients(coeffs, HNF_MAX_FILTERS);
+        for (uint8_t j = 0; j < num_filters; j++) {
+            chain.set_notch(1 + i * HNF_MAX_FILTERS + j, coeffs[j]);
+        }
+    }
+
+    chain.set_low_pass(_imu._gyro_filter[instance].get_params());
+
+    chain_coeffs.publish();
+}
+
 /*
   common accel update function for all backends
  */
 void AP_InertialSensor_Backend::update_accel(uint8_t instance)
 {    
-    WITH_SEMAPHORE(_sem);
-
     if ((1U<<instance) & _imu.imu_kill_mask) {
         return;
     }
-    if (_imu._new_accel_data[instance]) {
-        _publish_accel(instance, _imu._accel_filtered[instance]);
-        _imu._new_accel_data[instance] = false;
-    }
-    
-    // possibly update filter frequency
-    if (_last_accel_filter_hz != _accel_filter_cutoff()) {
-        _imu._accel_filter[instance].set_cutoff_frequency(_accel_raw_sample_rate(instance), _accel_filter_cutoff());
-        _last_accel_filter_hz = _accel_filter_cutoff();
+    Vector3f accel, raw_accel, delta_velocity;
+    float delta_velocity_dt;
+    if (_imu._accel_channel[instance].take(accel, raw_accel, delta_velocity, delta_velocity_dt)) {
+        _publish_accel(instance, accel, delta_velocity, delta_velocity_dt);
     }
 }
 
@@ -118,8 +118,6 @@ protected:
     // access to frontend
     AP_InertialSensor &_imu;
 
-    // semaphore for access to shared frontend data
-    HAL_Semaphore _sem;
 
     //Default Clip Limit
     float _clip_limit = 15.5f * GRAVITY_MSS;
@@ -127,8 +125,29 @@ protected:
     void _rotate_and_correct_accel(uint8_t instance, Vector3f &accel);
     void _rotate_and_correct_gyro(uint8_t instance, Vector3f &gyro);
 
-    // rotate gyro vector, offset and publish
-    void _publish_gyro(uint8_t instance, const Vector3f &gyro);
+    /*
+      where the three 16 bit axis words sit in a raw FIFO frame. word[]
+      is the index of the word giving each sensor frame axis and sign[]
+      is +1 or -1
+     */
+    struct FIFOAxisLayout {
+        uint8_t word[3];
+        int8_t sign[3];
+        bool big_endian;
+    };
+
+    // convert n raw FIFO frames, stride bytes apart, to unscaled vectors
+    static void _convert_fifo_block(const uint8_t *frames, uint16_t stride, uint16_t n,
+                                    const FIFOAxisLayout &layout, Vector3f *out);
+
+    // multiply a block of samples by scale then rotate and correct them,
+    // giving the same result as _rotate_and_correct_accel/gyro() on
+    // each sample
+    void _rotate_and_correct_accel_block(uint8_t instance, Vector3f *accel, uint16_t n, float scale);
+    void _rotate_and_correct_gyro_block(uint8_t instance, Vector3f *gyro, uint16_t n, float scale);
+
+    // publish a filtered gyro sample and the delta angle since the last one
+    void _publish_gyro(uint8_t instance, const Vector3f &gyro, const Vector3f &delta_angle, float delta_angle_dt);
 
     // this should be called every time a new gyro raw sample is
     // available - be it published or not the sample is raw in the
@@ -138,8 +157,8 @@ protected:
     // sensors, and should be set to zero for FIFO based sensors
     void _notify_new_gyro_raw_sample(uint8_t instance, const Vector3f &accel, uint64_t sample_us=0);
 
-    // rotate accel vector, scale, offset and publish
-    void _publish_accel(uint8_t instance, const Vector3f &accel);
+    // publish a filtered accel sample and the delta velocity since the last one
+    void _publish_accel(uint8_t instance, const Vector3f &accel, const Vector3f &delta_velocity, float delta_velocity_dt);
 
     // this should be called every time a new accel raw sample is available -
     // be it published or not
@@ -250,23 +269,6 @@ protected:
 
     bool _gyro_notch_enabled(void) const { return _imu._notch_filter.enabled(); }
 
-    // return the harmonic notch filter center in Hz for the sample rate
-    float gyro_harmonic_notch_center_freq_hz() const { return _imu.get_gyro_dynamic_notch_center_freq_hz(); }
-
-    // set of harmonic notch current center frequencies
-    const float* gyro_harmonic_notch_center_frequencies_hz(void) const { return _imu.get_gyro_dynamic_notch_center_frequencies_hz(); }
-
-    // number of harmonic notch current center frequencies
-    uint8_t num_gyro_harmonic_notch_center_frequencies(void) const { return _imu.get_num_gyro_dynamic_notch_center_frequencies(); }
-
-    // return the harmonic notch filter bandwidth in Hz for the sample rate
-    float gyro_harmonic_notch_bandwidth_hz(void) const { return _imu._harmonic_notch_filter.bandwidth_hz(); }
-
-    // return the harmonic notch filter attenuation in dB for the sample rate
-    float gyro_harmonic_notch_attenuation_dB(void) const { return _imu._harmonic_notch_filter.attenuation_dB(); }
-
-    bool gyro_harmonic_notch_enabled(void) const { return _imu._harmonic_notch_filter.enabled(); }
-
     // common gyro update function for all backends
     void update_gyro(uint8_t instance);
 
@@ -281,9 +283,16 @@ protected:
     float _last_notch_attenuation_dB;
 
     // support for updating harmonic filter at runtime
-    float _last_harmonic_notch_center_freq_hz;
-    float _last_harmonic_notch_bandwidth_hz;
-    float _last_harmonic_notch_attenuation_dB;
+    float _last_harmonic_notch_center_freq_hz[HAL_INS_NUM_HARMONIC_NOTCH_FILTERS];
+    float _last_harmonic_notch_bandwidth_hz[HAL_INS_NUM_HARMONIC_NOTCH_FILTERS];
+    float _last_harmonic_notch_attenuation_dB[HAL_INS_NUM_HARMONIC_NOTCH_FILTERS];
+
+    // enable state of the notches last loaded into the filter chain
+    bool _last_notch_enabled;
+    bool _last_harmonic_notch_enabled[HAL_INS_NUM_HARMONIC_NOTCH_FILTERS];
+
+    // design the fused filter chain coefficients and hand them to the sample path
+    void update_gyro_filter_chain(uint8_t instance);
 
     void set_gyro_orientation(uint8_t instance, enum Rotation rotation) {
         _imu._gyro_orientation[instance] = rotation;
@@ -330,4 +339,9 @@ private:
     void log_accel_raw(uint8_t instance, const uint64_t sample_us, const Vector3f &accel);
     void log_gyro_raw(uint8_t instance, const uint64_t sample_us, const Vector3f &gryo);
 
+    void _rotate_to_body(Vector3f &v) const;
+    void _block_transform(enum Rotation orientation, const Vector3f &offset, const Vector3f &axis_scale,
+                          float scale, Matrix3f &m, Vector3f &bias) const;
+    static void _apply_block_transform(const Matrix3f &m, const Vector3f &bias, Vector3f *v, uint16_t n);
+
 };
@@ -51,11 +51,21 @@ static const float GYRO_SCALE = (0.0174532f / 16.4f);
 #include "AP_InertialSensor_Invensensev2_registers.h"
 
 #define INV2_SAMPLE_SIZE 14
-#define INV2_FIFO_BUFFER_LEN 16
+/*
+  the most samples read from the FIFO in one go. The hardware FIFO holds
+  more, but with more than 32 samples queued the tail is corrupt, so
+  _read_fifo() reads at most 32, or 24 and then resets the FIFO. Every SPI read
+  is then a single transfer
+ */
+#define INV2_FIFO_BUFFER_LEN 32
 
 #define int16_val(v, idx) ((int16_t)(((uint16_t)v[2*idx] << 8) | v[2*idx+1]))
 #define uint16_val(v, idx)(((uint16_t)v[2*idx] << 8) | v[2*idx+1])
 
+// sensor frame axes of the big endian accel and gyro words in a FIFO sample
+const AP_InertialSensor_Invensensev2::FIFOAxisLayout AP_InertialSensor_Invensensev2::_fifo_accel_layout {{1, 0, 2}, {1, 1, -1}, true};
+const AP_InertialSensor_Invensensev2::FIFOAxisLayout AP_InertialSensor_Invensensev2::_fifo_gyro_layout {{4, 3, 5}, {1, 1, -1}, true};
+
 
 AP_InertialSensor_Invensensev2::AP_InertialSensor_Invensensev2(AP_InertialSensor &imu,
                                                            AP_HAL::OwnPtr<AP_HAL::Device> dev,
@@ -72,6 +82,8 @@ AP_InertialSensor_Invensensev2::~AP_InertialSensor_Invensensev2()
     if (_fifo_buffer != nullptr) {
         hal.util->free_type(_fifo_buffer, INV2_FIFO_BUFFER_LEN * INV2_SAMPLE_SIZE, AP_HAL::Util::MEM_DMA_SAFE);
     }
+    delete[] _block_accel;
+    delete[] _block_gyro;
     _dev->deregister_bankselect_callback();
     //delete _auxiliary_bus;
 }
@@ -234,6 +246,11 @@ void AP_InertialSensor_Invensensev2::start()
     if (_fifo_buffer == nullptr) {
         AP_HAL::panic("Invensense: Unable to allocate FIFO buffer");
     }
+    _block_accel = new Vector3f[INV2_FIFO_BUFFER_LEN];
+    _block_gyro = new Vector3f[INV2_FIFO_BUFFER_LEN];
+    if (_block_accel == nullptr || _block_gyro == nullptr) {
+        AP_HAL::panic("Invensense: Unable to allocate sample blocks");
+    }
 
     // start the timer process to read samples
     _dev->register_periodic_callback(1265625UL / _gyro_backend_rate_hz, FUNCTOR_BIND_MEMBER(&AP_InertialSensor_Invensensev2::_poll_data, void));
@@ -306,45 +323,57 @@ void AP_InertialSensor_Invensensev2::_poll_data()
     _read_fifo();
 }
 
-bool AP_InertialSensor_Invensensev2::_accumulate(uint8_t *samples, uint8_t n_samples)
+/*
+  find how many samples at the start of a FIFO block can be used. The
+  temperature is used to detect FIFO corruption
+ */
+uint8_t AP_InertialSensor_Invensensev2::_check_fifo_block(const uint8_t *samples, uint8_t n_samples, int32_t &tsum)
 {
+    tsum = 0;
     for (uint8_t i = 0; i < n_samples; i++) {
         const uint8_t *data = samples + INV2_SAMPLE_SIZE * i;
-        Vector3f accel, gyro;
-        bool fsync_set = false;
-
-#if INVENSENSE_EXT_SYNC_ENABLE
-        fsync_set = (int16_val(data, 2) & 1U) != 0;
-#endif
-        
-        accel = Vector3f(int16_val(data, 1),
-                         int16_val(data, 0),
-                         -int16_val(data, 2));
-        accel *= _accel_scale;
-
         int16_t t2 = int16_val(data, 6);
         if (!_check_raw_temp(t2)) {
             if (!hal.scheduler->in_expected_delay()) {
                 debug("temp reset IMU[%u] %d %d", _accel_instance, _raw_temp, t2);
             }
-            _fifo_reset();
-            return false;
+            return i;
         }
-        float temp = t2 * temp_sensitivity + temp_zero;
-        
-        gyro = Vector3f(int16_val(data, 4),
-                        int16_val(data, 3),
-                        -int16_val(data, 5));
-        gyro *= GYRO_SCALE;
+        tsum += t2;
+    }
+    return n_samples;
+}
+
+bool AP_InertialSensor_Invensensev2::_accumulate(uint8_t *samples, uint8_t n_samples)
+{
+    int32_t tsum;
+    const uint8_t n_good = _check_fifo_block(samples, n_samples, tsum);
 
-        _rotate_and_correct_accel(_accel_instance, accel);
-        _rotate_and_correct_gyro(_gyro_instance, gyro);
+    // convert, rotate and correct the whole block before publishing
+    _convert_fifo_block(samples, INV2_SAMPLE_SIZE, n_good, _fifo_accel_layout, _block_accel);
+    _convert_fifo_block(samples, INV2_SAMPLE_SIZE, n_good, _fifo_gyro_layout, _block_gyro);
+    _rotate_and_correct_accel_block(_accel_instance, _block_accel, n_good, _accel_scale);
+    _rotate_and_correct_gyro_block(_gyro_instance, _block_gyro, n_good, GYRO_SCALE);
 
-        _notify_new_accel_raw_sample(_accel_instance, accel, 0, fsync_set);
-        _notify_new_gyro_raw_sample(_gyro_instance, gyro);
+    for (uint8_t i = 0; i < n_good; i++) {
+        const uint8_t *data = samples + INV2_SAMPLE_SIZE * i;
+        bool fsync_set = false;
 
+#if INVENSENSE_EXT_SYNC_ENABLE
+        fsync_set = (int16_val(data, 2) & 1U) != 0;
+#endif
+
+        _notify_new_accel_raw_sample(_accel_instance, _block_accel[i], 0, fsync_set);
+        _notify_new_gyro_raw_sample(_gyro_instance, _block_gyro[i]);
+
+        float temp = int16_val(data, 6) * temp_sensitivity + temp_zero;
         _temp_filtered = _temp_filter.apply(temp);
     }
+
+    if (n_good < n_samples) {
+        _fifo_reset();
+        return false;
+    }
     return true;
 }
 
@@ -358,30 +387,21 @@ bool AP_InertialSensor_Invensensev2::_accumulate(uint8_t *samples, uint8_t n_sam
  */
 bool AP_InertialSensor_Invensensev2::_accumulate_sensor_rate_sampling(uint8_t *samples, uint8_t n_samples)
 {
-    int32_t tsum = 0;
+    int32_t tsum;
     int32_t unscaled_clip_limit = _clip_limit / _accel_scale;
     bool clipped = false;
-    bool ret = true;
 
-    for (uint8_t i = 0; i < n_samples; i++) {
-        const uint8_t *data = samples + INV2_SAMPLE_SIZE * i;
+    const uint8_t n_good = _check_fifo_block(samples, n_samples, tsum);
 
-        // use temperature to detect FIFO corruption
-        int16_t t2 = int16_val(data, 6);
-        if (!_check_raw_temp(t2)) {
-            if (!hal.scheduler->in_expected_delay()) {
-                debug("temp reset IMU[%u] %d %d", _accel_instance, _raw_temp, t2);
-            }
-            _fifo_reset();
-            ret = false;
-            break;
-        }
-        tsum += t2;
+    // the sensor rate samples stay in sensor frame, only the
+    // downsampled output is rotated and corrected
+    _convert_fifo_block(samples, INV2_SAMPLE_SIZE, n_good, _fifo_accel_layout, _block_accel);
+    _convert_fifo_block(samples, INV2_SAMPLE_SIZE, n_good, _fifo_gyro_layout, _block_gyro);
+
+    for (uint8_t i = 0; i < n_good; i++) {
         if (_accum.gyro_count % 2 == 0) {
             // accel data is at 4kHz or 1kHz
-            Vector3f a(int16_val(data, 1),
-                       int16_val(data, 0),
-                       -int16_val(data, 2));
+            const Vector3f &a = _block_accel[i];
             if (fabsf(a.x) > unscaled_clip_limit ||
                 fabsf(a.y) > unscaled_clip_limit ||
                 fabsf(a.z) > unscaled_clip_limit) {
@@ -407,9 +427,7 @@ bool AP_InertialSensor_Invensensev2::_accumulate_sensor_rate_sampling(uint8_t *s
 
         _accum.gyro_count++;
 
-        Vector3f g(int16_val(data, 4),
-                   int16_val(data, 3),
-                   -int16_val(data, 5));
+        const Vector3f &g = _block_gyro[i];
 
         Vector3f g2 = g * GYRO_SCALE;
         _notify_new_gyro_sensor_rate_sample(_gyro_instance, g2);
@@ -428,12 +446,15 @@ bool AP_InertialSensor_Invensensev2::_accumulate_sensor_rate_sampling(uint8_t *s
         increment_clip_count(_accel_instance);
     }
 
-    if (ret) {
-        float temp = (static_cast<float>(tsum)/n_samples)*temp_sensitivity + temp_zero;
-        _temp_filtered = _temp_filter.apply(temp);
+    if (n_good < n_samples) {
+        _fifo_reset();
+        return false;
     }
-    
-    return ret;
+
+    float temp = (static_cast<float>(tsum)/n_samples)*temp_sensitivity + temp_zero;
+    _temp_filtered = _temp_filter.apply(temp);
+
+    return true;
 }
 
 void AP_InertialSensor_Invensensev2::_read_fifo()
@@ -98,6 +98,7 @@ private:
 
     bool _accumulate(uint8_t *samples, uint8_t n_samples);
     bool _accumulate_sensor_rate_sampling(uint8_t *samples, uint8_t n_samples);
+    uint8_t _check_fifo_block(const uint8_t *samples, uint8_t n_samples, int32_t &tsum);
 
     bool _check_raw_temp(int16_t t2);
 
@@ -146,6 +147,12 @@ private:
     // buffer for fifo read
     uint8_t *_fifo_buffer;
 
+    // fifo samples converted to vectors, one block at a time
+    Vector3f *_block_accel;
+    Vector3f *_block_gyro;
+    static const FIFOAxisLayout _fifo_accel_layout;
+    static const FIFOAxisLayout _fifo_gyro_layout;
+
     uint8_t _current_bank = 0xFF;
     /*
       accumulators for sensor_rate sampling
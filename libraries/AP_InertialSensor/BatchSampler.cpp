@@ -6,7 +6,7 @@
 const AP_Param::GroupInfo AP_InertialSensor::BatchSampler::var_info[] = {
     // @Param: BAT_CNT
     // @DisplayName: sample count per batch
-    // @Description: Number of samples to take when logging streams of IMU sensor readings.  Will be rounded down to a multiple of 32. This option takes effect on the next reboot.
+    // @Description: Number of samples to take when logging streams of IMU sensor readings.  Will be rounded down to a multiple of 32. When streaming this is the number of samples buffered for each sensor and the number of samples between headers. This option takes effect on the next reboot.
     // @User: Advanced
     // @Increment: 32
     // @RebootRequired: True
@@ -24,13 +24,13 @@ const AP_Param::GroupInfo AP_InertialSensor::BatchSampler::var_info[] = {
     // @Param: BAT_OPT
     // @DisplayName: Batch Logging Options Mask
     // @Description: Options for the BatchSampler. Post-filter and sensor-rate logging cannot be used at the same time.
-    // @Bitmask: 0:Sensor-Rate Logging (sample at full sensor rate seen by AP), 1: Sample post-filtering
+    // @Bitmask: 0:Sensor-Rate Logging (sample at full sensor rate seen by AP), 1: Sample post-filtering, 2: Streaming (capture gyro and accel of all selected IMUs continuously, takes effect on the next reboot)
     // @User: Advanced
     AP_GROUPINFO("BAT_OPT",  3, AP_InertialSensor::BatchSampler, _batch_options_mask, 0),
 
     // @Param: BAT_LGIN
     // @DisplayName: logging interval
-    // @Description: Interval between pushing samples to the AP_Logger log
+    // @Description: Interval between pushing samples to the AP_Logger log. Not used when streaming, where all buffered samples are pushed each loop
     // @Units: ms
     // @Increment: 10
     AP_GROUPINFO("BAT_LGIN", 4, AP_InertialSensor::BatchSampler, push_interval_ms,   20),
@@ -57,6 +57,11 @@ void AP_InertialSensor::BatchSampler::init()
 
     _required_count -= _required_count % 32; // round down to nearest multiple of 32
 
+    if ((batch_opt_t)(_batch_options_mask.get()) & BATCH_OPT_STREAMING) {
+        init_streaming();
+        return;
+    }
+
     const uint32_t total_allocation = 3*_required_count*sizeof(uint16_t);
     gcs().send_text(MAV_SEVERITY_DEBUG, "INS: alloc %u bytes for ISB (free=%u)", (unsigned int)total_allocation, (unsigned int)hal.util->available_memory());
 
@@ -84,9 +89,75 @@ void AP_InertialSensor::BatchSampler::periodic()
     if (_sensor_mask == 0) {
         return;
     }
+    if (_streaming) {
+        push_streams_to_log();
+        return;
+    }
     push_data_to_log();
 }
 
+/*
+  streaming mode: every selected IMU's gyro and accel are captured
+  continuously into their own ring. Each ring has a single writer, the
+  backend thread of that sensor, and a single reader, the main thread
+ */
+void AP_InertialSensor::BatchSampler::init_streaming()
+{
+    const uint8_t count = MIN(_imu._accel_count, _imu._gyro_count);
+    const uint16_t blocks = _required_count / ARRAY_SIZE(isb_block::x);
+
+    uint32_t total_allocation = 0;
+    for (uint8_t i=0; i<count; i++) {
+        if (!(_sensor_mask & (1U<<i))) {
+            continue;
+        }
+        for (uint8_t t=0; t<2; t++) {
+            isb_stream *stream = new isb_stream;
+            if (stream == nullptr || !stream->ring.set_size(blocks) || stream->ring.get_size() < blocks) {
+                delete stream;
+                for (uint8_t j=0; j<INS_MAX_INSTANCES; j++) {
+                    delete streams[j][0];
+                    delete streams[j][1];
+                    streams[j][0] = streams[j][1] = nullptr;
+                }
+                gcs().send_text(MAV_SEVERITY_WARNING, "Failed to allocate %u bytes for IMU batch streaming", (unsigned int)(blocks * sizeof(isb_block)));
+                return;
+            }
+            stream->multiplier = (t == IMU_SENSOR_TYPE_GYRO) ? _imu._gyro_raw_sampling_multiplier[i] : _imu._accel_raw_sampling_multiplier[i];
+            streams[i][t] = stream;
+            total_allocation += sizeof(isb_stream) + blocks * sizeof(isb_block);
+        }
+    }
+    gcs().send_text(MAV_SEVERITY_DEBUG, "INS: alloc %u bytes for ISB streaming (free=%u)", (unsigned int)total_allocation, (unsigned int)hal.util->available_memory());
+
+    _streaming = true;
+    update_doing_sensor_rate_logging();
+    initialised = true;
+}
+
+/*
+  return true if the sensor is being logged from its sensor rate samples
+  rather than its raw samples
+ */
+bool AP_InertialSensor::BatchSampler::doing_sensor_rate_logging(uint8_t _instance, IMU_SENSOR_TYPE _type) const
+{
+    if (!_streaming) {
+        // only the sensor currently being batched is logged
+        return _doing_sensor_rate_logging;
+    }
+    if (!_doing_sensor_rate_logging) {
+        return false;
+    }
+    const uint8_t bit = (1<<_instance);
+    switch (_type) {
+    case IMU_SENSOR_TYPE_GYRO:
+        return _imu._gyro_sensor_rate_sampling_enabled & bit;
+    case IMU_SENSOR_TYPE_ACCEL:
+        return _imu._accel_sensor_rate_sampling_enabled & bit;
+    }
+    return false;
+}
+
 void AP_InertialSensor::BatchSampler::update_doing_sensor_rate_logging()
 {
     // We can't do post-filter sensor rate logging
@@ -100,6 +171,11 @@ void AP_InertialSensor::BatchSampler::update_doing_sensor_rate_logging()
         _doing_sensor_rate_logging = false;
         return;
     }
+    if (_streaming) {
+        // decided per sensor in doing_sensor_rate_logging()
+        _doing_sensor_rate_logging = true;
+        return;
+    }
     const uint8_t bit = (1<<instance);
     switch (type) {
     case IMU_SENSOR_TYPE_GYRO:
@@ -194,28 +270,13 @@ void AP_InertialSensor::BatchSampler::push_data_to_log()
 
     // possibly send isb header:
     if (!isbh_sent && data_read_offset == 0) {
-        float sample_rate = 0; // avoid warning about uninitialised values
-        switch(type) {
-        case IMU_SENSOR_TYPE_GYRO:
-            sample_rate = _imu._gyro_raw_sample_rates[instance];
-            if (_doing_sensor_rate_logging) {
-                sample_rate *= _imu._gyro_over_sampling[instance];
-            }
-            break;
-        case IMU_SENSOR_TYPE_ACCEL:
-            sample_rate = _imu._accel_raw_sample_rates[instance];
-            if (_doing_sensor_rate_logging) {
-                sample_rate *= _imu._accel_over_sampling[instance];
-            }
-            break;
-        }
         if (!logger->Write_ISBH(isb_seqnum,
                                        type,
                                        instance,
                                        multiplier,
                                        _required_count,
                                        measurement_started_us,
-                                       sample_rate)) {
+                                       sample_rate_hz(instance, type))) {
             // buffer full?
             return;
         }
@@ -243,6 +304,108 @@ void AP_InertialSensor::BatchSampler::push_data_to_log()
     }
 }
 
+/*
+  return the rate at which samples are captured for a sensor
+ */
+float AP_InertialSensor::BatchSampler::sample_rate_hz(uint8_t _instance, IMU_SENSOR_TYPE _type) const
+{
+    const bool sensor_rate = doing_sensor_rate_logging(_instance, _type);
+    switch (_type) {
+    case IMU_SENSOR_TYPE_GYRO:
+        return _imu._gyro_raw_sample_rates[_instance] * (sensor_rate ? _imu._gyro_over_sampling[_instance] : 1);
+    case IMU_SENSOR_TYPE_ACCEL:
+        return _imu._accel_raw_sample_rates[_instance] * (sensor_rate ? _imu._accel_over_sampling[_instance] : 1);
+    }
+    return 0;
+}
+
+// @LoggerMessage: ISBS
+// @Description: IMU batch streaming statistics
+// @Field: TimeUS: Time since system startup
+// @Field: I: IMU instance
+// @Field: type: sensor type, 0 accel, 1 gyro
+// @Field: N: number of samples captured
+// @Field: Drop: number of samples lost because the log could not keep up
+
+/*
+  push all complete blocks of every stream to the log. A new header is
+  written every _required_count samples, and after any lost samples so
+  that each batch is gapless
+ */
+void AP_InertialSensor::BatchSampler::push_streams_to_log()
+{
+    AP_Logger *logger = AP_Logger::get_singleton();
+    if (logger == nullptr) {
+        return;
+    }
+    const uint16_t blocks_per_batch = _required_count / ARRAY_SIZE(isb_block::x);
+    const uint8_t num_streams = INS_MAX_INSTANCES * 2;
+
+    // start from a different stream each time so that a logger which
+    // is short of space does not always starve the same streams
+    const uint8_t first_stream = next_stream;
+    next_stream = (next_stream + 1) % num_streams;
+
+    bool logger_full = false;
+    for (uint8_t n=0; n<num_streams && !logger_full; n++) {
+        const uint8_t i = ((first_stream + n) % num_streams) / 2;
+        const uint8_t t = ((first_stream + n) % num_streams) % 2;
+        isb_stream *stream = streams[i][t];
+        if (stream == nullptr) {
+            continue;
+        }
+        isb_block block;
+        while (stream->ring.peek(&block, 1) == 1) {
+            if (block.gap && stream->block_count != 0) {
+                // samples were lost, start a new batch
+                stream->header_sent = false;
+                stream->block_count = 0;
+            }
+            if (!stream->header_sent) {
+                if (!logger->Write_ISBH(isb_seqnum,
+                                        (IMU_SENSOR_TYPE)t,
+                                        i,
+                                        stream->multiplier,
+                                        _required_count,
+                                        block.sample_us,
+                                        sample_rate_hz(i, (IMU_SENSOR_TYPE)t))) {
+                    // logger buffer full, try again next loop
+                    logger_full = true;
+                    break;
+                }
+                stream->seqnum = isb_seqnum++;
+                stream->header_sent = true;
+            }
+            if (!logger->Write_ISBD(stream->seqnum, stream->block_count, block.x, block.y, block.z)) {
+                logger_full = true;
+                break;
+            }
+            stream->ring.pop();
+            if (++stream->block_count >= blocks_per_batch) {
+                stream->header_sent = false;
+                stream->block_count = 0;
+            }
+        }
+    }
+
+    // log sample loss so gaps can be seen without decoding every batch
+    const uint32_t now_ms = AP_HAL::millis();
+    if (now_ms - last_stream_stats_ms < 1000) {
+        return;
+    }
+    last_stream_stats_ms = now_ms;
+    for (uint8_t i=0; i<INS_MAX_INSTANCES; i++) {
+        for (uint8_t t=0; t<2; t++) {
+            const isb_stream *stream = streams[i][t];
+            if (stream == nullptr) {
+                continue;
+            }
+            logger->Write("ISBS", "TimeUS,I,type,N,Drop", "s#---", "F----", "QBBII",
+                          AP_HAL::micros64(), i, t, stream->sample_count, stream->dropped_count);
+        }
+    }
+}
+
 bool AP_InertialSensor::BatchSampler::should_log(uint8_t _instance, IMU_SENSOR_TYPE _type)
 {
     if (_sensor_mask == 0) {
@@ -273,6 +436,10 @@ bool AP_InertialSensor::BatchSampler::should_log(uint8_t _instance, IMU_SENSOR_T
 
 void AP_InertialSensor::BatchSampler::sample(uint8_t _instance, AP_InertialSensor::IMU_SENSOR_TYPE _type, uint64_t sample_us, const Vector3f &_sample)
 {
+    if (_streaming) {
+        sample_streaming(_instance, _type, sample_us, _sample);
+        return;
+    }
     if (!should_log(_instance, _type)) {
         return;
     }
@@ -286,3 +453,38 @@ void AP_InertialSensor::BatchSampler::sample(uint8_t _instance, AP_InertialSenso
 
     data_write_offset++; // may unblock the reading process
 }
+
+/*
+  add a sample to a stream, called from the backend thread of the
+  sensor. Completed blocks are pushed to the ring, if the ring is full
+  the block is dropped and counted
+ */
+void AP_InertialSensor::BatchSampler::sample_streaming(uint8_t _instance, IMU_SENSOR_TYPE _type, uint64_t sample_us, const Vector3f &_sample)
+{
+    if (_instance >= INS_MAX_INSTANCES) {
+        return;
+    }
+    isb_stream *stream = streams[_instance][_type];
+    if (stream == nullptr) {
+        return;
+    }
+
+    isb_block &block = stream->staging;
+    if (stream->staging_count == 0) {
+        block.sample_us = sample_us;
+        block.gap = stream->dropped_last;
+    }
+    block.x[stream->staging_count] = stream->multiplier*_sample.x;
+    block.y[stream->staging_count] = stream->multiplier*_sample.y;
+    block.z[stream->staging_count] = stream->multiplier*_sample.z;
+    stream->sample_count++;
+
+    if (++stream->staging_count < ARRAY_SIZE(block.x)) {
+        return;
+    }
+    stream->staging_count = 0;
+    stream->dropped_last = !stream->ring.push(block);
+    if (stream->dropped_last) {
+        stream->dropped_count += ARRAY_SIZE(block.x);
+    }
+}
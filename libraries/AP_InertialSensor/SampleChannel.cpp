@@ -0,0 +1,91 @@
+#include "AP_InertialSensor.h"
+
+/*
+  The accumulator is owned by the sample path and never reset by the
+  main loop, which instead works out what is new by comparing each
+  snapshot with the last one it took. To stop the accumulator growing
+  without bound the main loop sends back what it took, and the sample
+  path drops that and moves on a generation. It can only move on once
+  between two take() calls, as the main loop sends back a generation
+  only after seeing it, so the snapshot needs to carry just the most
+  recent amount dropped.
+
+  discard() moves on two generations, so the main loop can tell it
+  apart and starts again from the new accumulator.
+ */
+
+void AP_InertialSensor::SampleChannel::sync()
+{
+    if (!_taken.update()) {
+        return;
+    }
+    const taken &t = _taken.front();
+    if (t.generation != _generation) {
+        // already dropped, or from before a discard()
+        return;
+    }
+    _acc -= t.acc;
+    _acc_dt -= t.acc_dt;
+    _dropped = t.acc;
+    _dropped_dt = t.acc_dt;
+    _generation++;
+}
+
+void AP_InertialSensor::SampleChannel::discard()
+{
+    _acc.zero();
+    _acc_dt = 0;
+    _generation += 2;
+}
+
+void AP_InertialSensor::SampleChannel::publish(const Vector3f &delta, float dt, const Vector3f &filtered, const Vector3f &raw)
+{
+    _acc += delta;
+    _acc_dt += dt;
+
+    snapshot &s = _snapshot.back();
+    s.filtered = filtered;
+    s.raw = raw;
+    s.acc = _acc;
+    s.acc_dt = _acc_dt;
+    s.dropped = _dropped;
+    s.dropped_dt = _dropped_dt;
+    s.generation = _generation;
+    _snapshot.publish();
+}
+
+bool AP_InertialSensor::SampleChannel::take(Vector3f &filtered, Vector3f &raw, Vector3f &delta, float &delta_dt)
+{
+    if (!_snapshot.update()) {
+        return false;
+    }
+    const snapshot &s = _snapshot.front();
+
+    const uint8_t age = s.generation - _last_generation;
+    if (age == 0) {
+        delta = s.acc - _last_acc;
+        delta_dt = s.acc_dt - _last_acc_dt;
+    } else if (age == 1) {
+        // the sample path dropped what we took before, some of which
+        // we may have taken since
+        delta = s.acc - (_last_acc - s.dropped);
+        delta_dt = s.acc_dt - (_last_acc_dt - s.dropped_dt);
+    } else {
+        delta = s.acc;
+        delta_dt = s.acc_dt;
+    }
+    filtered = s.filtered;
+    raw = s.raw;
+
+    _last_acc = s.acc;
+    _last_acc_dt = s.acc_dt;
+    _last_generation = s.generation;
+
+    taken &t = _taken.back();
+    t.acc = s.acc;
+    t.acc_dt = s.acc_dt;
+    t.generation = s.generation;
+    _taken.publish();
+
+    return true;
+}
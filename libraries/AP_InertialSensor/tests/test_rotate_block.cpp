@@ -0,0 +1,121 @@
+#include <AP_gtest.h>
+
+#include <AP_InertialSensor/AP_InertialSensor.h>
+#include <AP_InertialSensor/AP_InertialSensor_Backend.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+// a full FIFO read of one of the block converting drivers
+#define BLOCK_LEN 32
+
+// raw samples are 16 bit, scaled as a 16g accel or 2000dps gyro
+#define ACCEL_SCALE (GRAVITY_MSS / 2048.0f)
+#define GYRO_SCALE (radians(2000.0f) / 32768.0f)
+
+static AP_InertialSensor ins;
+
+class AP_InertialSensor_Test : public AP_InertialSensor_Backend
+{
+public:
+    AP_InertialSensor_Test(AP_InertialSensor &imu) :
+        AP_InertialSensor_Backend(imu) {}
+
+    bool update() override { return true; }
+
+    // set up the sensor orientation, calibration and board orientation
+    // of instance 0
+    void setup(enum Rotation sensor_rotation, enum Rotation board_rotation,
+               const Vector3f &accel_offset, const Vector3f &accel_scale, const Vector3f &gyro_offset)
+    {
+        set_accel_orientation(0, sensor_rotation);
+        set_gyro_orientation(0, sensor_rotation);
+        _imu.set_board_orientation(board_rotation);
+        _imu._accel_offset[0].set(accel_offset);
+        _imu._accel_scale[0].set(accel_scale);
+        _imu._gyro_offset[0].set(gyro_offset);
+    }
+
+    // correct a block of raw samples, and each sample on its own, and
+    // check the two agree
+    void check_accel(const Vector3f *raw, uint16_t n)
+    {
+        Vector3f block[BLOCK_LEN];
+        memcpy(block, raw, n * sizeof(Vector3f));
+        _rotate_and_correct_accel_block(0, block, n, ACCEL_SCALE);
+        for (uint16_t i = 0; i < n; i++) {
+            Vector3f expected = raw[i] * ACCEL_SCALE;
+            _rotate_and_correct_accel(0, expected);
+            EXPECT_NEAR(expected.x, block[i].x, 1.0e-3f);
+            EXPECT_NEAR(expected.y, block[i].y, 1.0e-3f);
+            EXPECT_NEAR(expected.z, block[i].z, 1.0e-3f);
+        }
+    }
+
+    void check_gyro(const Vector3f *raw, uint16_t n)
+    {
+        Vector3f block[BLOCK_LEN];
+        memcpy(block, raw, n * sizeof(Vector3f));
+        _rotate_and_correct_gyro_block(0, block, n, GYRO_SCALE);
+        for (uint16_t i = 0; i < n; i++) {
+            Vector3f expected = raw[i] * GYRO_SCALE;
+            _rotate_and_correct_gyro(0, expected);
+            EXPECT_NEAR(expected.x, block[i].x, 1.0e-4f);
+            EXPECT_NEAR(expected.y, block[i].y, 1.0e-4f);
+            EXPECT_NEAR(expected.z, block[i].z, 1.0e-4f);
+        }
+    }
+};
+
+// repeatable pseudo random numbers in [-1, 1]
+static float random_float(uint32_t &seed)
+{
+    seed = seed * 1103515245U + 12345U;
+    return ((seed >> 8) & 0xFFFF) / 32767.5f - 1.0f;
+}
+
+// a block of random raw samples over the full 16 bit range
+static void random_block(uint32_t &seed, Vector3f *raw, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++) {
+        raw[i] = Vector3f(int16_t(32767 * random_float(seed)),
+                          int16_t(32767 * random_float(seed)),
+                          int16_t(32767 * random_float(seed)));
+    }
+}
+
+static const enum Rotation board_rotations[] {
+    ROTATION_NONE,
+    ROTATION_YAW_90,
+    ROTATION_ROLL_180_YAW_45,
+    ROTATION_PITCH_7,
+};
+
+/*
+  the block transform must give the same result as the per-sample
+  rotate and correct for every sensor orientation, for full blocks and
+  for the short blocks that are done one sample at a time
+ */
+TEST(AP_InertialSensor_Backend, rotate_and_correct_block)
+{
+    AP_InertialSensor_Test backend(ins);
+    uint32_t seed = 1;
+    Vector3f raw[BLOCK_LEN];
+
+    for (const enum Rotation board_rotation : board_rotations) {
+        for (uint8_t r = ROTATION_NONE; r < ROTATION_MAX; r++) {
+            const Vector3f accel_offset(random_float(seed), random_float(seed), random_float(seed));
+            const Vector3f accel_scale(1 + 0.1f * random_float(seed), 1 + 0.1f * random_float(seed), 1 + 0.1f * random_float(seed));
+            const Vector3f gyro_offset(0.05f * random_float(seed), 0.05f * random_float(seed), 0.05f * random_float(seed));
+            backend.setup((enum Rotation)r, board_rotation, accel_offset, accel_scale, gyro_offset);
+
+            for (const uint16_t n : { 1, 3, 4, 24, BLOCK_LEN }) {
+                random_block(seed, raw, n);
+                backend.check_accel(raw, n);
+                random_block(seed, raw, n);
+                backend.check_gyro(raw, n);
+            }
+        }
+    }
+}
+
+AP_GTEST_MAIN()
@@ -0,0 +1,119 @@
+#include <AP_gtest.h>
+
+#include <AP_InertialSensor/AP_InertialSensor.h>
+
+#include <atomic>
+#include <thread>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+class AP_InertialSensor_Test
+{
+public:
+    typedef AP_InertialSensor::SampleChannel SampleChannel;
+};
+
+typedef AP_InertialSensor_Test::SampleChannel SampleChannel;
+
+// whole numbers so the sums below are exact
+static const Vector3f sample_delta(1, 2, 3);
+
+// repeatable pseudo random numbers
+static uint32_t random_u32(uint32_t &seed)
+{
+    seed = seed * 1103515245U + 12345U;
+    return seed >> 8;
+}
+
+/*
+  the sample path and main loop interleaved in every order, with gaps
+  thrown away now and then. Each take() must return exactly what was
+  integrated since the last one, through many wraps of the generation
+ */
+TEST(SampleChannel, interleaved)
+{
+    SampleChannel channel {};
+    uint32_t seed = 1;
+    Vector3f pending;
+    float pending_dt = 0;
+    uint32_t takes = 0;
+
+    for (uint32_t i = 0; i < 200000; i++) {
+        const uint32_t op = random_u32(seed) % 16;
+        Vector3f filtered, raw, delta;
+        float delta_dt;
+        if (op < 8) {
+            // sample path: one new sample
+            channel.sync();
+            channel.publish(sample_delta, 1, sample_delta, sample_delta);
+            pending += sample_delta;
+            pending_dt += 1;
+        } else if (op < 15) {
+            // main loop: take everything new
+            const bool fresh = channel.available();
+            EXPECT_EQ(fresh, channel.take(filtered, raw, delta, delta_dt));
+            if (!fresh) {
+                EXPECT_TRUE(pending.is_zero());
+                continue;
+            }
+            EXPECT_EQ(pending, delta);
+            EXPECT_EQ(pending_dt, delta_dt);
+            EXPECT_EQ(sample_delta, filtered);
+            pending.zero();
+            pending_dt = 0;
+            takes++;
+        } else {
+            // sample path: a gap, only the sample after it is kept
+            channel.sync();
+            channel.discard();
+            channel.publish(sample_delta, 1, sample_delta, sample_delta);
+            pending = sample_delta;
+            pending_dt = 1;
+        }
+    }
+
+    // the generation is 8 bits, make sure it wrapped
+    EXPECT_GT(takes, 1000U);
+}
+
+/*
+  reads overlapping writes: the main loop takes while the sample path
+  publishes from another thread. Nothing may be lost or counted twice
+ */
+TEST(SampleChannel, concurrent)
+{
+    SampleChannel channel {};
+    const uint32_t num_samples = 1000000;
+
+    std::atomic<bool> finished {false};
+
+    std::thread sample_path([&channel, &finished, num_samples]() {
+        for (uint32_t i = 0; i < num_samples; i++) {
+            channel.sync();
+            channel.publish(sample_delta, 1, sample_delta, sample_delta);
+        }
+        finished = true;
+    });
+
+    Vector3f total;
+    double total_dt = 0;
+    while (true) {
+        // checked before the take so the last sample is always picked up
+        const bool was_finished = finished;
+        Vector3f filtered, raw, delta;
+        float delta_dt;
+        if (channel.take(filtered, raw, delta, delta_dt)) {
+            EXPECT_GE(delta_dt, 0);
+            total += delta;
+            total_dt += delta_dt;
+        } else if (was_finished) {
+            break;
+        }
+    }
+    sample_path.join();
+
+    EXPECT_EQ(num_samples, total_dt);
+    EXPECT_EQ(sample_delta * num_samples, total);
+}
+
+AP_GTEST_MAIN()
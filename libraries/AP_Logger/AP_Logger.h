@@ -523,6 +523,20 @@ private:
     // start page of log data
     uint32_t _log_data_page;
 
+    // log data read from the backend ahead of the client, so it sees a
+    // few large reads rather than one per LOG_DATA message
+    uint8_t *_log_data_buf;
+    uint32_t _log_data_buf_offset;
+    uint16_t _log_data_buf_len;
+
+    // further ranges of the log being sent which the client asked for
+    // while sending, typically to fill in gaps left by dropped packets
+    struct log_data_range {
+        uint32_t ofs;
+        uint32_t count;
+    } _log_data_pending[4];
+    uint8_t _log_data_num_pending;
+
     GCS_MAVLINK *_log_sending_link;
     HAL_Semaphore _log_send_sem;
 
@@ -539,6 +553,9 @@ private:
     void handle_log_send_listing(); // handle LISTING state
     void handle_log_sending(); // handle SENDING state
     bool handle_log_send_data(); // send data chunk to client
+    void start_log_data_range(uint32_t ofs, uint32_t count);
+    void queue_log_data_range(uint32_t ofs, uint32_t count);
+    int16_t get_log_data_buffered(uint32_t offset, uint16_t len, uint8_t *data);
 
     void get_log_info(uint16_t log_num, uint32_t &size, uint32_t &time_utc);
 
@@ -24,6 +24,15 @@
 
 extern const AP_HAL::HAL& hal;
 
+// number of LOG_DATA chunks read from the backend in one go
+#ifndef HAL_LOGGER_READ_AHEAD_CHUNKS
+#define HAL_LOGGER_READ_AHEAD_CHUNKS 16
+#endif
+
+// upper limit on LOG_DATA messages sent per call, to bound the time
+// spent in handle_log_sending() on very fast links
+#define LOG_DATA_MAX_SENDS 250U
+
 // We avoid doing log messages when timing is critical:
 bool AP_Logger::should_handle_log_message()
 {
@@ -107,20 +116,25 @@ void AP_Logger::handle_log_request_data(GCS_MAVLINK &link, const mavlink_message
 {
     WITH_SEMAPHORE(_log_send_sem);
 
+    mavlink_log_request_data_t packet;
+    mavlink_msg_log_request_data_decode(&msg, &packet);
+
     if (_log_sending_link != nullptr) {
-        // some GCS (e.g. MAVProxy) attempt to stream request_data
-        // messages when they're filling gaps in the downloaded logs.
-        // This channel check avoids complaining to them, at the cost
-        // of silently dropping any repeated attempts to start logging
         if (_log_sending_link->get_chan() != link.get_chan()) {
             link.send_text(MAV_SEVERITY_INFO, "Log download in progress");
+            return;
+        }
+        // some GCS (e.g. MAVProxy) stream request_data messages while
+        // a download is running to fill gaps left by dropped packets.
+        // Queue those ranges to follow the current one rather than
+        // restarting the transfer; any other request is dropped
+        if (transfer_activity == TransferActivity::SENDING &&
+            packet.id == _log_num_data) {
+            queue_log_data_range(packet.ofs, packet.count);
         }
         return;
     }
 
-    mavlink_log_request_data_t packet;
-    mavlink_msg_log_request_data_decode(&msg, &packet);
-
     // consider opening or switching logs:
     if (transfer_activity != TransferActivity::SENDING || _log_num_data != packet.id) {
 
@@ -133,27 +147,87 @@ void AP_Logger::handle_log_request_data(GCS_MAVLINK &link, const mavlink_message
 
         uint32_t time_utc, size;
         get_log_info(packet.id, size, time_utc);
+
+        uint32_t page, end;
+        get_log_boundaries(packet.id, page, end);
+
+        if (packet.id != _log_num_data || page != _log_data_page) {
+            // anything read ahead was from another log
+            _log_data_buf_len = 0;
+        }
         _log_num_data = packet.id;
         _log_data_size = size;
+        _log_data_page = page;
+    }
+
+    _log_data_num_pending = 0;
+    start_log_data_range(packet.ofs, packet.count);
+
+    transfer_activity = TransferActivity::SENDING;
+    _log_sending_link = &link;
+
+    handle_log_send();
+}
+
+/**
+   queue a range of the current log to be sent after the current
+   one. A range which overlaps or touches a queued one is merged into
+   it. When the queue is full the range is merged into the queued
+   range that grows least by taking it in, so the client may get some
+   data twice but never misses a range it asked for
+ */
+void AP_Logger::queue_log_data_range(uint32_t ofs, uint32_t count)
+{
+    if (count == 0) {
+        return;
+    }
+    const uint64_t end = uint64_t(ofs) + count;
+
+    uint8_t best = 0;
+    uint64_t best_growth = UINT64_MAX;
+    for (uint8_t i=0; i<_log_data_num_pending; i++) {
+        const log_data_range &r = _log_data_pending[i];
+        const uint64_t r_end = uint64_t(r.ofs) + r.count;
+        const uint64_t growth = (ofs < r.ofs ? r.ofs - ofs : 0) + (end > r_end ? end - r_end : 0);
+        if (ofs <= r_end && end >= r.ofs) {
+            // overlapping or adjacent, always merge
+            best = i;
+            best_growth = 0;
+            break;
+        }
+        if (growth < best_growth) {
+            best = i;
+            best_growth = growth;
+        }
+    }
 
-        uint32_t end;
-        get_log_boundaries(packet.id, _log_data_page, end);
+    if (best_growth != 0 && _log_data_num_pending < ARRAY_SIZE(_log_data_pending)) {
+        _log_data_pending[_log_data_num_pending].ofs = ofs;
+        _log_data_pending[_log_data_num_pending].count = count;
+        _log_data_num_pending++;
+        return;
     }
 
-    _log_data_offset = packet.ofs;
+    log_data_range &r = _log_data_pending[best];
+    const uint64_t r_end = MAX(uint64_t(r.ofs) + r.count, end);
+    r.ofs = MIN(r.ofs, ofs);
+    r.count = MIN(r_end - r.ofs, uint64_t(UINT32_MAX));
+}
+
+/**
+   set up to send count bytes of the current log starting at ofs
+ */
+void AP_Logger::start_log_data_range(uint32_t ofs, uint32_t count)
+{
+    _log_data_offset = ofs;
     if (_log_data_offset >= _log_data_size) {
         _log_data_remaining = 0;
     } else {
         _log_data_remaining = _log_data_size - _log_data_offset;
     }
-    if (_log_data_remaining > packet.count) {
-        _log_data_remaining = packet.count;
+    if (_log_data_remaining > count) {
+        _log_data_remaining = count;
     }
-
-    transfer_activity = TransferActivity::SENDING;
-    _log_sending_link = &link;
-
-    handle_log_send();
 }
 
 /**
@@ -164,6 +238,11 @@ void AP_Logger::handle_log_request_erase(GCS_MAVLINK &link, const mavlink_messag
     // mavlink_log_erase_t packet;
     // mavlink_msg_log_erase_decode(&msg, &packet);
 
+    {
+        WITH_SEMAPHORE(_log_send_sem);
+        _log_data_buf_len = 0;
+    }
+
     EraseAll();
 }
 
@@ -178,6 +257,12 @@ void AP_Logger::handle_log_request_end(GCS_MAVLINK &link, const mavlink_message_
 
     transfer_activity = TransferActivity::IDLE;
     _log_sending_link = nullptr;
+    _log_data_num_pending = 0;
+
+    // the download is over, give back the read ahead buffer
+    delete[] _log_data_buf;
+    _log_data_buf = nullptr;
+    _log_data_buf_len = 0;
 }
 
 /**
@@ -210,24 +295,20 @@ void AP_Logger::handle_log_sending()
 {
     WITH_SEMAPHORE(_log_send_sem);
 
-#if CONFIG_HAL_BOARD == HAL_BOARD_SITL
-    // assume USB speeds in SITL for the purposes of log download
-    const uint8_t num_sends = 40;
-#else
-    uint8_t num_sends = 1;
-    if (_log_sending_link->is_high_bandwidth() && hal.gpio->usb_connected()) {
-        // when on USB we can send a lot more data
-        num_sends = 250;
-    } else if (_log_sending_link->have_flow_control()) {
-    #if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
-        num_sends = 80;
-    #else
-        num_sends = 10;
-    #endif
-    }
+    // fill whatever space the link has in its TX buffer. Without flow
+    // control that space drains at the UART rate whatever the radio
+    // beyond it can carry, so only send one message per call
+    uint16_t num_sends = 1;
+#if CONFIG_HAL_BOARD != HAL_BOARD_SITL
+    if (_log_sending_link->have_flow_control() ||
+        (_log_sending_link->is_high_bandwidth() && hal.gpio->usb_connected()))
 #endif
+    {
+        const mavlink_channel_t chan = _log_sending_link->get_chan();
+        num_sends = MIN(comm_get_txspace(chan) / PAYLOAD_SIZE(chan, LOG_DATA), LOG_DATA_MAX_SENDS);
+    }
 
-    for (uint8_t i=0; i<num_sends; i++) {
+    for (uint16_t i=0; i<num_sends; i++) {
         if (transfer_activity != TransferActivity::SENDING) {
             // may have completed sending data
             break;
@@ -299,7 +380,7 @@ bool AP_Logger::handle_log_send_data()
         len = MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
     }
 
-    nbytes = get_log_data(_log_num_data, _log_data_page, _log_data_offset, len, packet.data);
+    nbytes = get_log_data_buffered(_log_data_offset, len, packet.data);
 
     if (nbytes < 0) {
         // report as EOF on error
@@ -322,8 +403,55 @@ bool AP_Logger::handle_log_send_data()
     _log_data_offset += nbytes;
     _log_data_remaining -= nbytes;
     if (nbytes < MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN || _log_data_remaining == 0) {
-        transfer_activity = TransferActivity::IDLE;
-        _log_sending_link = nullptr;
+        if (_log_data_num_pending > 0) {
+            // move on to the next range the client asked for
+            start_log_data_range(_log_data_pending[0].ofs, _log_data_pending[0].count);
+            _log_data_num_pending--;
+            memmove(&_log_data_pending[0], &_log_data_pending[1], _log_data_num_pending*sizeof(_log_data_pending[0]));
+        } else {
+            transfer_activity = TransferActivity::IDLE;
+            _log_sending_link = nullptr;
+        }
     }
     return true;
 }
+
+/**
+   get data from the current log, reading ahead of the client so that
+   the backend is asked for HAL_LOGGER_READ_AHEAD_CHUNKS chunks at a
+   time. Falls back to reading directly if there is no memory for the
+   buffer
+ */
+int16_t AP_Logger::get_log_data_buffered(uint32_t offset, uint16_t len, uint8_t *data)
+{
+    const uint16_t buf_size = HAL_LOGGER_READ_AHEAD_CHUNKS * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
+    if (_log_data_buf == nullptr) {
+        _log_data_buf = new uint8_t[buf_size];
+        _log_data_buf_len = 0;
+        if (_log_data_buf == nullptr) {
+            return get_log_data(_log_num_data, _log_data_page, offset, len, data);
+        }
+    }
+
+    if (offset < _log_data_buf_offset ||
+        offset + len > _log_data_buf_offset + _log_data_buf_len) {
+        // not all in the buffer, refill it starting at offset. Never
+        // read past the end of the log as block backends would carry
+        // on into whatever follows it
+        if (offset >= _log_data_size) {
+            return 0;
+        }
+        const uint16_t n = MIN(_log_data_size - offset, buf_size);
+        const int16_t ret = get_log_data(_log_num_data, _log_data_page, offset, n, _log_data_buf);
+        if (ret < 0) {
+            _log_data_buf_len = 0;
+            return ret;
+        }
+        _log_data_buf_offset = offset;
+        _log_data_buf_len = ret;
+    }
+
+    const uint16_t n = MIN(len, _log_data_buf_offset + _log_data_buf_len - offset);
+    memcpy(data, &_log_data_buf[offset - _log_data_buf_offset], n);
+    return n;
+}
@@ -0,0 +1,69 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Math/AP_Math.h>
+#include <AP_Math/tests/polygon_test.h>
+
+#define MAX_POINTS 255
+
+static void BM_PolygonOutside(benchmark::State& state)
+{
+    Vector2f V[MAX_POINTS];
+    const uint16_t n = state.range(0);
+    make_star(V, n);
+    Vector2f P(10.0f, 20.0f);
+
+    while (state.KeepRunning()) {
+        bool outside = Polygon_outside(P, V, n);
+        gbenchmark_escape(&outside);
+    }
+}
+
+static void BM_PolygonIndexOutside(benchmark::State& state)
+{
+    Vector2f V[MAX_POINTS];
+    const uint16_t n = state.range(0);
+    make_star(V, n);
+    AP_PolygonIndex index;
+    index.init(V, n);
+    Vector2f P(10.0f, 20.0f);
+
+    while (state.KeepRunning()) {
+        bool outside = index.outside(P);
+        gbenchmark_escape(&outside);
+    }
+}
+
+static void BM_PolygonIntersects(benchmark::State& state)
+{
+    Vector2f V[MAX_POINTS];
+    const uint16_t n = state.range(0);
+    make_star(V, n);
+    Vector2f p1(10.0f, 20.0f), p2(30.0f, 25.0f), intersection;
+
+    while (state.KeepRunning()) {
+        bool hit = Polygon_intersects(V, n, p1, p2, intersection);
+        gbenchmark_escape(&hit);
+    }
+}
+
+static void BM_PolygonIndexIntersects(benchmark::State& state)
+{
+    Vector2f V[MAX_POINTS];
+    const uint16_t n = state.range(0);
+    make_star(V, n);
+    AP_PolygonIndex index;
+    index.init(V, n);
+    Vector2f p1(10.0f, 20.0f), p2(30.0f, 25.0f), intersection;
+
+    while (state.KeepRunning()) {
+        bool hit = index.intersects(p1, p2, intersection);
+        gbenchmark_escape(&hit);
+    }
+}
+
+BENCHMARK(BM_PolygonOutside)->Arg(10)->Arg(64)->Arg(MAX_POINTS);
+BENCHMARK(BM_PolygonIndexOutside)->Arg(10)->Arg(64)->Arg(MAX_POINTS);
+BENCHMARK(BM_PolygonIntersects)->Arg(10)->Arg(64)->Arg(MAX_POINTS);
+BENCHMARK(BM_PolygonIndexIntersects)->Arg(10)->Arg(64)->Arg(MAX_POINTS);
+
+BENCHMARK_MAIN();
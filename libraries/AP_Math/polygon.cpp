@@ -26,6 +26,57 @@
  */
 
 
+/*
+ *  Polygon_edge_crossed(): one step of the point in polygon test
+ *     Input:   P = a point,
+ *              Vi, Vj = the ends of an edge of the polygon
+ *     Return:  true if a ray from P crosses the edge, each crossing
+ *              takes P from outside to inside or back
+ */
+template <typename T>
+static inline bool Polygon_edge_crossed(const Vector2<T> &P, const Vector2<T> &Vi, const Vector2<T> &Vj)
+{
+    if ((Vi.y > P.y) == (Vj.y > P.y)) {
+        return false;
+    }
+    const T dx1 = P.x - Vi.x;
+    const T dx2 = Vj.x - Vi.x;
+    const T dy1 = P.y - Vi.y;
+    const T dy2 = Vj.y - Vi.y;
+    const int8_t dx1s = (dx1 < 0) ? -1 : 1;
+    const int8_t dx2s = (dx2 < 0) ? -1 : 1;
+    const int8_t dy1s = (dy1 < 0) ? -1 : 1;
+    const int8_t dy2s = (dy2 < 0) ? -1 : 1;
+    const int8_t m1 = dx1s * dy2s;
+    const int8_t m2 = dx2s * dy1s;
+    // we avoid the 64 bit multiplies if we can based on sign checks.
+    if (dy2 < 0) {
+        if (m1 > m2) {
+            return true;
+        } else if (m1 < m2) {
+            return false;
+        } else {
+            if (std::is_floating_point<T>::value) {
+                return dx1 * dy2 > dx2 * dy1;
+            } else {
+                return dx1 * (int64_t)dy2 > dx2 * (int64_t)dy1;
+            }
+        }
+    } else {
+        if (m1 < m2) {
+            return true;
+        } else if (m1 > m2) {
+            return false;
+        } else {
+            if (std::is_floating_point<T>::value) {
+                return dx1 * dy2 < dx2 * dy1;
+            } else {
+                return dx1 * (int64_t)dy2 < dx2 * (int64_t)dy1;
+            }
+        }
+    }
+}
+
 /*
  *  Polygon_outside(): test for a point in a polygon
  *     Input:   P = a point,
@@ -54,52 +105,8 @@ bool Polygon_outside(const Vector2<T> &P, const Vector2<T> *V, unsigned n)
         if (j >= n) {
             j = 0;
         }
-        if ((V[i].y > P.y) == (V[j].y > P.y)) {
-            continue;
-        }
-        const T dx1 = P.x - V[i].x;
-        const T dx2 = V[j].x - V[i].x;
-        const T dy1 = P.y - V[i].y;
-        const T dy2 = V[j].y - V[i].y;
-        const int8_t dx1s = (dx1 < 0) ? -1 : 1;
-        const int8_t dx2s = (dx2 < 0) ? -1 : 1;
-        const int8_t dy1s = (dy1 < 0) ? -1 : 1;
-        const int8_t dy2s = (dy2 < 0) ? -1 : 1;
-        const int8_t m1 = dx1s * dy2s;
-        const int8_t m2 = dx2s * dy1s;
-        // we avoid the 64 bit multiplies if we can based on sign checks.
-        if (dy2 < 0) {
-            if (m1 > m2) {
-                outside = !outside;
-            } else if (m1 < m2) {
-                continue;
-            } else {
-                if (std::is_floating_point<T>::value) {
-                    if ( dx1 * dy2 > dx2 * dy1 ) {
-                        outside = !outside;
-                    }
-                } else {
-                    if ( dx1 * (int64_t)dy2 > dx2 * (int64_t)dy1 ) {
-                        outside = !outside;
-                    }
-                }
-            }
-        } else {
-            if (m1 < m2) {
-                outside = !outside;
-            } else if (m1 > m2) {
-                continue;
-            } else {
-                if (std::is_floating_point<T>::value) {
-                    if ( dx1 * dy2 < dx2 * dy1 ) {
-                        outside = !outside;
-                    }
-                } else {
-                    if ( dx1 * (int64_t)dy2 < dx2 * (int64_t)dy1 ) {
-                        outside = !outside;
-                    }
-                }
-            }
+        if (Polygon_edge_crossed(P, V[i], V[j])) {
+            outside = !outside;
         }
     }
     return outside;
@@ -125,6 +132,37 @@ template bool Polygon_outside<float>(const Vector2f &P, const Vector2f *V, unsig
 template bool Polygon_complete<float>(const Vector2f *V, unsigned n);
 
 
+/*
+  check if the edge from v1 to v2 is intersected by a line from p1 to
+  p2 closer to p1 than intersect_dist_sq, updating intersection and
+  intersect_dist_sq if it is
+ */
+static inline void Polygon_edge_intersects(const Vector2f &v1, const Vector2f &v2, const Vector2f &p1, const Vector2f &p2,
+                                           Vector2f &intersection, float &intersect_dist_sq)
+{
+    // optimisations for common cases
+    if (v1.x > p1.x && v2.x > p1.x && v1.x > p2.x && v2.x > p2.x) {
+        return;
+    }
+    if (v1.y > p1.y && v2.y > p1.y && v1.y > p2.y && v2.y > p2.y) {
+        return;
+    }
+    if (v1.x < p1.x && v2.x < p1.x && v1.x < p2.x && v2.x < p2.x) {
+        return;
+    }
+    if (v1.y < p1.y && v2.y < p1.y && v1.y < p2.y && v2.y < p2.y) {
+        return;
+    }
+    Vector2f intersect_tmp;
+    if (Vector2f::segment_intersection(v1,v2,p1,p2,intersect_tmp)) {
+        float dist_sq = sq(intersect_tmp.x - p1.x) + sq(intersect_tmp.y - p1.y);
+        if (dist_sq < intersect_dist_sq) {
+            intersect_dist_sq = dist_sq;
+            intersection = intersect_tmp;
+        }
+    }
+}
+
 /*
   determine if the polygon of N verticies defined by points V is
   intersected by a line from point p1 to point p2
@@ -140,34 +178,12 @@ bool Polygon_intersects(const Vector2f *V, unsigned N, const Vector2f &p1, const
     }
 
     float intersect_dist_sq = FLT_MAX;
-    for (uint8_t i=0; i<N; i++) {
-        uint8_t j = i+1;
+    for (unsigned i=0; i<N; i++) {
+        unsigned j = i+1;
         if (j >= N) {
             j = 0;
         }
-        const Vector2f &v1 = V[i];
-        const Vector2f &v2 = V[j];
-        // optimisations for common cases
-        if (v1.x > p1.x && v2.x > p1.x && v1.x > p2.x && v2.x > p2.x) {
-            continue;
-        }
-        if (v1.y > p1.y && v2.y > p1.y && v1.y > p2.y && v2.y > p2.y) {
-            continue;
-        }
-        if (v1.x < p1.x && v2.x < p1.x && v1.x < p2.x && v2.x < p2.x) {
-            continue;
-        }
-        if (v1.y < p1.y && v2.y < p1.y && v1.y < p2.y && v2.y < p2.y) {
-            continue;
-        }
-        Vector2f intersect_tmp;
-        if (Vector2f::segment_intersection(v1,v2,p1,p2,intersect_tmp)) {
-            float dist_sq = sq(intersect_tmp.x - p1.x) + sq(intersect_tmp.y - p1.y);
-            if (dist_sq < intersect_dist_sq) {
-                intersect_dist_sq = dist_sq;
-                intersection = intersect_tmp;
-            }
-        }
+        Polygon_edge_intersects(V[i], V[j], p1, p2, intersection, intersect_dist_sq);
     }
     return (intersect_dist_sq < FLT_MAX);
 }
@@ -184,7 +200,7 @@ float Polygon_closest_distance_line(const Vector2f *V, unsigned N, const Vector2
         return -sqrtf(sq(intersection.x - p2.x) + sq(intersection.y - p2.y));
     }
     float closest_sq = FLT_MAX;
-    for (uint8_t i=0; i<N-1; i++) {
+    for (unsigned i=0; i+1<N; i++) {
         const Vector2f &v1 = V[i];
         const Vector2f &v2 = V[i+1];
 
@@ -203,7 +219,7 @@ float Polygon_closest_distance_line(const Vector2f *V, unsigned N, const Vector2
 float Polygon_closest_distance_point(const Vector2f *V, unsigned N, const Vector2f &p)
 {
     float closest_sq = FLT_MAX;
-    for (uint8_t i=0; i<N-1; i++) {
+    for (unsigned i=0; i+1<N; i++) {
         const Vector2f &v1 = V[i];
         const Vector2f &v2 = V[i+1];
 
@@ -214,3 +230,174 @@ float Polygon_closest_distance_point(const Vector2f *V, unsigned N, const Vector
     }
     return sqrtf(closest_sq);
 }
+
+/*
+  index the polygon of n points V. The bands divide the height of the
+  polygon evenly, with about two for every edge up to a limit
+ */
+bool AP_PolygonIndex::init(const Vector2f *V, unsigned n)
+{
+    clear();
+
+    _points = V;
+    _num_points = n;
+    if (Polygon_complete(V, n)) {
+        n--;
+    }
+    if (n < 3 || n > UINT16_MAX) {
+        return false;
+    }
+    _num_edges = n;
+
+    _min = _max = V[0];
+    for (unsigned i=1; i<n; i++) {
+        _min.x = MIN(_min.x, V[i].x);
+        _min.y = MIN(_min.y, V[i].y);
+        _max.x = MAX(_max.x, V[i].x);
+        _max.y = MAX(_max.y, V[i].y);
+    }
+    _have_bounds = true;
+
+    _num_bands = constrain_int16(n / 2, 1, AP_POLYGON_INDEX_MAX_BANDS);
+    const float height = _max.y - _min.y;
+    _band_scale = is_positive(height) ? _num_bands / height : 0;
+
+    _band_start = new uint16_t[_num_bands+1];
+    if (_band_start == nullptr) {
+        return false;
+    }
+
+    // count the edges in each band, then turn the counts into the
+    // start of each band's list of edges
+    memset(_band_start, 0, (_num_bands+1) * sizeof(_band_start[0]));
+    uint32_t total = 0;
+    for (uint16_t i=0; i<n; i++) {
+        uint16_t b_lo, b_hi;
+        edge_bands(i, b_lo, b_hi);
+        for (uint16_t b=b_lo; b<=b_hi; b++) {
+            _band_start[b+1]++;
+        }
+        total += 1 + b_hi - b_lo;
+    }
+    if (total > UINT16_MAX) {
+        clear_bands();
+        return false;
+    }
+    for (uint16_t b=0; b<_num_bands; b++) {
+        _band_start[b+1] += _band_start[b];
+    }
+
+    _band_edges = new uint16_t[total];
+    if (_band_edges == nullptr) {
+        clear_bands();
+        return false;
+    }
+    uint16_t *fill = new uint16_t[_num_bands];
+    if (fill == nullptr) {
+        clear_bands();
+        return false;
+    }
+    memcpy(fill, _band_start, _num_bands * sizeof(fill[0]));
+    for (uint16_t i=0; i<n; i++) {
+        uint16_t b_lo, b_hi;
+        edge_bands(i, b_lo, b_hi);
+        for (uint16_t b=b_lo; b<=b_hi; b++) {
+            _band_edges[fill[b]++] = i;
+        }
+    }
+    delete[] fill;
+
+    return true;
+}
+
+void AP_PolygonIndex::clear_bands()
+{
+    delete[] _band_start;
+    _band_start = nullptr;
+    delete[] _band_edges;
+    _band_edges = nullptr;
+}
+
+void AP_PolygonIndex::clear()
+{
+    clear_bands();
+    _points = nullptr;
+    _num_points = 0;
+    _num_edges = 0;
+    _have_bounds = false;
+}
+
+// the band holding y, which must be the same calculation for edges
+// and queries so that an edge is always in the band of any y it covers
+uint16_t AP_PolygonIndex::band(float y) const
+{
+    const float b = (y - _min.y) * _band_scale;
+    if (!(b > 0)) {
+        return 0;
+    }
+    if (b >= _num_bands - 1) {
+        return _num_bands - 1;
+    }
+    return (uint16_t)b;
+}
+
+// the range of bands covered by the edge starting at point i
+void AP_PolygonIndex::edge_bands(uint16_t i, uint16_t &b_lo, uint16_t &b_hi) const
+{
+    const Vector2f &v1 = _points[i];
+    const Vector2f &v2 = _points[edge_end(i)];
+    b_lo = band(MIN(v1.y, v2.y));
+    b_hi = band(MAX(v1.y, v2.y));
+}
+
+bool AP_PolygonIndex::outside(const Vector2f &P) const
+{
+    if (_band_start == nullptr) {
+        return Polygon_outside(P, _points, _num_points);
+    }
+    // no edge can be crossed by a point above or below the polygon,
+    // and points either side cross them all or none of them
+    if (P.x < _min.x || P.x > _max.x || P.y < _min.y || P.y > _max.y) {
+        return true;
+    }
+    bool outside = true;
+    const uint16_t b = band(P.y);
+    for (uint16_t k=_band_start[b]; k<_band_start[b+1]; k++) {
+        const uint16_t i = _band_edges[k];
+        if (Polygon_edge_crossed(P, _points[i], _points[edge_end(i)])) {
+            outside = !outside;
+        }
+    }
+    return outside;
+}
+
+bool AP_PolygonIndex::intersects(const Vector2f &p1, const Vector2f &p2, Vector2f &intersection) const
+{
+    if (_have_bounds &&
+        ((p1.x < _min.x && p2.x < _min.x) || (p1.x > _max.x && p2.x > _max.x) ||
+         (p1.y < _min.y && p2.y < _min.y) || (p1.y > _max.y && p2.y > _max.y))) {
+        return false;
+    }
+    if (_band_start == nullptr) {
+        return Polygon_intersects(_points, _num_points, p1, p2, intersection);
+    }
+    const uint16_t b_lo = band(MIN(p1.y, p2.y));
+    const uint16_t b_hi = band(MAX(p1.y, p2.y));
+    if (2 * (b_hi - b_lo) >= _num_bands) {
+        // the line covers too much of the polygon for the bands to help
+        return Polygon_intersects(_points, _num_points, p1, p2, intersection);
+    }
+    float intersect_dist_sq = FLT_MAX;
+    for (uint16_t b=b_lo; b<=b_hi; b++) {
+        for (uint16_t k=_band_start[b]; k<_band_start[b+1]; k++) {
+            const uint16_t i = _band_edges[k];
+            const uint16_t j = edge_end(i);
+            // edges in several bands are only checked in the first of them
+            if (b != MAX(b_lo, band(MIN(_points[i].y, _points[j].y)))) {
+                continue;
+            }
+            Polygon_edge_intersects(_points[i], _points[j], p1, p2, intersection, intersect_dist_sq);
+        }
+    }
+    return (intersect_dist_sq < FLT_MAX);
+}
@@ -44,3 +44,57 @@ float Polygon_closest_distance_line(const Vector2f *V, unsigned N, const Vector2
   closed polygon V, defined by N points
  */
 float Polygon_closest_distance_point(const Vector2f *V, unsigned N, const Vector2f &p);
+
+#define AP_POLYGON_INDEX_MAX_BANDS 128
+
+/*
+  index of the edges of a polygon by the horizontal band of y values
+  they cover, so point in polygon and line intersection tests only
+  look at the edges near the point or line rather than every edge. The
+  results are the same as Polygon_outside() and Polygon_intersects().
+  The points are not copied and must stay valid while the index is used
+ */
+class AP_PolygonIndex {
+public:
+    AP_PolygonIndex() {}
+    ~AP_PolygonIndex() { clear(); }
+
+    /* Do not allow copies */
+    AP_PolygonIndex(const AP_PolygonIndex &other) = delete;
+    AP_PolygonIndex &operator=(const AP_PolygonIndex&) = delete;
+
+    // index the polygon of n points V. Returns false if the bands
+    // could not be allocated, queries then check every edge
+    bool init(const Vector2f *V, unsigned n);
+    void clear();
+
+    // true if P is outside the polygon
+    bool outside(const Vector2f &P) const WARN_IF_UNUSED;
+
+    // true if the line from p1 to p2 crosses the polygon, intersection
+    // is set to the crossing closest to p1
+    bool intersects(const Vector2f &p1, const Vector2f &p2, Vector2f &intersection) const WARN_IF_UNUSED;
+
+private:
+    uint16_t band(float y) const;
+    void edge_bands(uint16_t i, uint16_t &b_lo, uint16_t &b_hi) const;
+    uint16_t edge_end(uint16_t i) const { return (i+1 < _num_edges) ? i+1 : 0; }
+    void clear_bands();
+
+    const Vector2f *_points = nullptr;
+    unsigned _num_points = 0;
+    uint16_t _num_edges = 0;
+
+    // bounding box of the points
+    Vector2f _min;
+    Vector2f _max;
+    bool _have_bounds = false;
+
+    // the edges starting at the points listed in
+    // _band_edges[_band_start[b]] to _band_edges[_band_start[b+1]-1]
+    // cover some part of band b
+    float _band_scale = 0;
+    uint16_t _num_bands = 0;
+    uint16_t *_band_start = nullptr;
+    uint16_t *_band_edges = nullptr;
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <AP_Math/AP_Math.h>
+
+/*
+ * Polygons shared by the polygon tests and benchmarks.
+ */
+
+// a star shaped polygon of n points with radius varying between 50 and 100
+static inline void make_star(Vector2f *V, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++) {
+        const float angle = i * M_2PI / n;
+        const float r = (i % 2) ? 50.0f : 100.0f;
+        V[i] = Vector2f(r * cosf(angle), r * sinf(angle));
+    }
+}
@@ -3,6 +3,8 @@
 
 #include <AP_Math/AP_Math.h>
 
+#include "polygon_test.h"
+
 struct PB {
     Vector2f point;
     Vector2f boundary[3];
@@ -356,6 +358,41 @@ TEST(Polygon, simple)
     TEST_POLYGON_POINTS(SIMPLE_boundary, SIMPLE_test_points);
 }
 
+TEST(Polygon, index_matches_linear)
+{
+    static const uint16_t sizes[] { 3, 10, 64, 255, 400 };
+    for (uint16_t n : sizes) {
+        Vector2f V[400];
+        make_star(V, n);
+        AP_PolygonIndex index;
+        EXPECT_TRUE(index.init(V, n));
+        for (int16_t x = -110; x <= 110; x += 3) {
+            for (int16_t y = -110; y <= 110; y += 7) {
+                const Vector2f P(x + 0.5f, y + 0.25f);
+                EXPECT_EQ(Polygon_outside(P, V, n), index.outside(P));
+
+                // segments of a range of lengths through the polygon
+                const Vector2f P2(y * 0.5f, -x * 0.25f);
+                Vector2f i1, i2;
+                const bool hit = Polygon_intersects(V, n, P, P2, i1);
+                EXPECT_EQ(hit, index.intersects(P, P2, i2));
+                if (hit) {
+                    EXPECT_FLOAT_EQ(i1.x, i2.x);
+                    EXPECT_FLOAT_EQ(i1.y, i2.y);
+                }
+            }
+        }
+    }
+}
+
+TEST(Polygon, index_empty)
+{
+    AP_PolygonIndex index;
+    Vector2f intersection;
+    EXPECT_TRUE(index.outside(Vector2f(0, 0)));
+    EXPECT_FALSE(index.intersects(Vector2f(0, 0), Vector2f(1, 1), intersection));
+}
+
 AP_GTEST_MAIN()
 
 
@@ -31,6 +31,18 @@ const AP_Param::GroupInfo AP_Mission::var_info[] = {
     // @User: Advanced
     AP_GROUPINFO("OPTIONS",  2, AP_Mission, _options, AP_MISSION_OPTIONS_DEFAULT),
 
+#if AP_MISSION_FILE_ENABLED
+    // @Param: FILE_KB
+    // @DisplayName: Mission file size
+    // @Description: Size of a file on the SD card or filesystem to hold the mission instead of the mission storage area. This allows missions of many thousands of commands, about 68 per kilobyte. Zero uses the mission storage area. Missions are not copied between the two, so changing this to or from zero clears the mission. Changing the size keeps the mission if it still fits
+    // @Units: KB
+    // @Range: 0 480
+    // @Increment: 1
+    // @RebootRequired: True
+    // @User: Advanced
+    AP_GROUPINFO("FILE_KB",  3, AP_Mission, _file_kb, 0),
+#endif
+
     AP_GROUPEND
 };
 
@@ -41,6 +53,13 @@ StorageAccess AP_Mission::_storage(StorageManager::StorageMission);
 
 HAL_Semaphore AP_Mission::_rsem;
 
+#if AP_MISSION_CACHE_ENABLED
+AP_Mission::Mission_Command *AP_Mission::_cmd_cache;
+uint16_t AP_Mission::_cmd_cache_size;
+bool AP_Mission::_cmd_cache_failed;
+struct AP_Mission::cmd_index AP_Mission::_cmd_index;
+#endif
+
 ///
 /// public mission methods
 ///
@@ -48,6 +67,17 @@ HAL_Semaphore AP_Mission::_rsem;
 /// init - initialises this library including checks the version in eeprom matches this library
 void AP_Mission::init()
 {
+#if AP_MISSION_FILE_ENABLED
+    if (_file_kb > 0 && _file == nullptr) {
+        _file = new AP_Mission_FileStore();
+        if (_file == nullptr || !_file->init(AP_MISSION_FILE_NAME, _file_kb * 1024UL)) {
+            delete _file;
+            _file = nullptr;
+            gcs().send_text(MAV_SEVERITY_WARNING, "Mission file unavailable, using storage");
+        }
+    }
+#endif
+
     // check_eeprom_version - checks version of missions stored in eeprom matches this library
     // command list will be cleared if they do not match
     check_eeprom_version();
@@ -384,6 +414,14 @@ bool AP_Mission::get_next_nav_cmd(uint16_t start_index, Mission_Command& cmd)
 {
     // search until the end of the mission command list
     for (uint16_t cmd_index = start_index; cmd_index < (unsigned)_cmd_total; cmd_index++) {
+#if AP_MISSION_CACHE_ENABLED
+        // get_next_cmd() would return each do command before the next
+        // nav or jump command only for it to be passed over below
+        cmd_index = next_nav_or_jump(cmd_index);
+        if (cmd_index >= (unsigned)_cmd_total) {
+            break;
+        }
+#endif
         // get next command
         if (!get_next_cmd(cmd_index, cmd, false)) {
             // no more commands so return failure
@@ -633,22 +671,37 @@ bool AP_Mission::read_cmd_from_storage(uint16_t index, Mission_Command& cmd) con
         return false;
     }
 
+#if AP_MISSION_CACHE_ENABLED
+    if (_cmd_cache == nullptr && !_cmd_cache_failed) {
+        cache_allocate(num_commands_max());
+    }
+    if (index < _cmd_cache_size && _cmd_cache[index].index == index) {
+        cmd = _cmd_cache[index];
+        return true;
+    }
+#endif
+
     // Find out proper location in memory by using the start_byte position + the index
     // we can load a command, we don't process it yet
     // read WP position
-    const uint16_t pos_in_storage = 4 + (index * AP_MISSION_EEPROM_COMMAND_SIZE);
+    const uint32_t pos_in_storage = 4 + (index * AP_MISSION_EEPROM_COMMAND_SIZE);
+
+    uint8_t b[AP_MISSION_EEPROM_COMMAND_SIZE];
+    if (!read_from_storage(pos_in_storage, b, sizeof(b))) {
+        return false;
+    }
 
     PackedContent packed_content {};
 
-    const uint8_t b1 = _storage.read_byte(pos_in_storage);
+    const uint8_t b1 = b[0];
     if (b1 == 0) {
-        cmd.id = _storage.read_uint16(pos_in_storage+1);
-        cmd.p1 = _storage.read_uint16(pos_in_storage+3);
-        _storage.read_block(packed_content.bytes, pos_in_storage+5, 10);
+        memcpy(&cmd.id, &b[1], sizeof(cmd.id));
+        memcpy(&cmd.p1, &b[3], sizeof(cmd.p1));
+        memcpy(packed_content.bytes, &b[5], 10);
     } else {
         cmd.id = b1;
-        cmd.p1 = _storage.read_uint16(pos_in_storage+1);
-        _storage.read_block(packed_content.bytes, pos_in_storage+3, 12);
+        memcpy(&cmd.p1, &b[1], sizeof(cmd.p1));
+        memcpy(packed_content.bytes, &b[3], 12);
     }
 
     if (stored_in_location(cmd.id)) {
@@ -680,6 +733,12 @@ bool AP_Mission::read_cmd_from_storage(uint16_t index, Mission_Command& cmd) con
     // set command's index to it's position in eeprom
     cmd.index = index;
 
+#if AP_MISSION_CACHE_ENABLED
+    if (index < _cmd_cache_size) {
+        _cmd_cache[index] = cmd;
+    }
+#endif
+
     // return success
     return true;
 }
@@ -741,20 +800,33 @@ bool AP_Mission::write_cmd_to_storage(uint16_t index, const Mission_Command& cmd
     }
 
     // calculate where in storage the command should be placed
-    uint16_t pos_in_storage = 4 + (index * AP_MISSION_EEPROM_COMMAND_SIZE);
+    const uint32_t pos_in_storage = 4 + (index * AP_MISSION_EEPROM_COMMAND_SIZE);
 
+    uint8_t b[AP_MISSION_EEPROM_COMMAND_SIZE];
     if (cmd.id < 256) {
-        _storage.write_byte(pos_in_storage, cmd.id);
-        _storage.write_uint16(pos_in_storage+1, cmd.p1);
-        _storage.write_block(pos_in_storage+3, packed.bytes, 12);
+        b[0] = cmd.id;
+        memcpy(&b[1], &cmd.p1, sizeof(cmd.p1));
+        memcpy(&b[3], packed.bytes, 12);
     } else {
         // if the command ID is above 256 we store a 0 followed by the 16 bit command ID
-        _storage.write_byte(pos_in_storage, 0);
-        _storage.write_uint16(pos_in_storage+1, cmd.id);
-        _storage.write_uint16(pos_in_storage+3, cmd.p1);
-        _storage.write_block(pos_in_storage+5, packed.bytes, 10);
+        b[0] = 0;
+        memcpy(&b[1], &cmd.id, sizeof(cmd.id));
+        memcpy(&b[3], &cmd.p1, sizeof(cmd.p1));
+        memcpy(&b[5], packed.bytes, 10);
+    }
+    if (!write_to_storage(pos_in_storage, b, sizeof(b))) {
+        return false;
     }
 
+#if AP_MISSION_CACHE_ENABLED
+    // drop any cached copy so the next read decodes exactly what was
+    // stored, and rebuild the indexes before they are next used
+    if (index < _cmd_cache_size) {
+        _cmd_cache[index].index = AP_MISSION_CMD_INDEX_NONE;
+    }
+    _cmd_index.valid = false;
+#endif
+
     // remember when the mission last changed
     _last_change_time_ms = AP_HAL::millis();
 
@@ -1625,6 +1697,13 @@ bool AP_Mission::advance_current_nav_cmd(uint16_t starting_index)
 
     // search until we find next nav command or reach end of command list
     while (!_flags.nav_cmd_loaded) {
+#if AP_MISSION_CACHE_ENABLED
+        if (_flags.do_cmd_loaded) {
+            // further do commands before the next nav command are not
+            // started, so skip straight to it or the next jump
+            cmd_index = next_nav_or_jump(cmd_index);
+        }
+#endif
         // get next command
         Mission_Command cmd;
         if (!get_next_cmd(cmd_index, cmd, true)) {
@@ -1683,6 +1762,14 @@ bool AP_Mission::advance_current_nav_cmd(uint16_t starting_index)
         _flags.do_cmd_all_done = true;
     }
 
+#if AP_MISSION_FILE_ENABLED
+    if (_file != nullptr) {
+        // have the IO thread load the commands following this one,
+        // including the next nav command, before they are read
+        _file->prefetch(4 + (_nav_cmd.index + 1U) * AP_MISSION_EEPROM_COMMAND_SIZE);
+    }
+#endif
+
     // if we got this far we must have successfully advanced the nav command
     return true;
 }
@@ -1893,21 +1980,77 @@ void AP_Mission::increment_jump_times_run(Mission_Command& cmd, bool send_gcs_ms
 // command list will be cleared if they do not match
 void AP_Mission::check_eeprom_version()
 {
-    uint32_t eeprom_version = _storage.read_uint32(0);
+#if AP_MISSION_FILE_ENABLED
+    if (_file != nullptr) {
+        /*
+          the version in eeprom records which of the storage area and
+          the file holds the mission MIS_TOTAL counts, so the mission
+          is cleared when MIS_FILE_KB is changed to or from zero, or
+          becomes too small for it
+         */
+        uint32_t file_version = 0;
+        _file->read(0, &file_version, sizeof(file_version));
+        if (_storage.read_uint32(0) != AP_MISSION_FILE_VERSION ||
+            file_version != AP_MISSION_FILE_VERSION ||
+            (unsigned)_cmd_total > num_commands_max()) {
+            if (clear()) {
+                const uint32_t version = AP_MISSION_FILE_VERSION;
+                _file->write(0, &version, sizeof(version));
+                _storage.write_uint32(0, version);
+            }
+        }
+        return;
+    }
+#endif
+
+    uint32_t eeprom_version = 0;
+    read_from_storage(0, &eeprom_version, sizeof(eeprom_version));
 
     // if eeprom version does not match, clear the command list and update the eeprom version
     if (eeprom_version != AP_MISSION_EEPROM_VERSION) {
         if (clear()) {
-            _storage.write_uint32(0, AP_MISSION_EEPROM_VERSION);
+            const uint32_t version = AP_MISSION_EEPROM_VERSION;
+            write_to_storage(0, &version, sizeof(version));
         }
     }
 }
 
+/*
+  read and write the mission's storage, which is either the storage
+  area set aside for it or a file
+ */
+bool AP_Mission::read_from_storage(uint32_t ofs, void *data, uint16_t len) const
+{
+#if AP_MISSION_FILE_ENABLED
+    if (_file != nullptr) {
+        return _file->read(ofs, data, len);
+    }
+#endif
+    return ofs + len <= _storage.size() && _storage.read_block(data, ofs, len);
+}
+
+bool AP_Mission::write_to_storage(uint32_t ofs, const void *data, uint16_t len)
+{
+#if AP_MISSION_FILE_ENABLED
+    if (_file != nullptr) {
+        return _file->write(ofs, data, len);
+    }
+#endif
+    return ofs + len <= _storage.size() && _storage.write_block(ofs, data, len);
+}
+
 /*
   return total number of commands that can fit in storage space
  */
 uint16_t AP_Mission::num_commands_max(void) const
 {
+#if AP_MISSION_FILE_ENABLED
+    if (_file != nullptr) {
+        // limited by MIS_TOTAL, and AP_MISSION_CMD_INDEX_NONE
+        const uint32_t max_cmds = (_file->size() - 4) / AP_MISSION_EEPROM_COMMAND_SIZE;
+        return MIN(max_cmds, 32766U);
+    }
+#endif
     // -4 to remove space for eeprom version number
     return (_storage.size() - 4) / AP_MISSION_EEPROM_COMMAND_SIZE;
 }
@@ -1926,8 +2069,25 @@ uint16_t AP_Mission::get_landing_sequence_start()
     uint16_t landing_start_index = 0;
     float min_distance = -1;
 
+#if AP_MISSION_CACHE_ENABLED
+    // the cache can be written from another thread, so hold the lock
+    // while reading from it
+    WITH_SEMAPHORE(_rsem);
+    const bool use_index = update_cmd_index() && !_cmd_index.overflow;
+    for (uint8_t i = 0; use_index && i < _cmd_index.num_land_start; i++) {
+        const uint16_t idx = _cmd_index.land_start[i];
+        const float tmp_distance = _cmd_cache[idx].content.location.get_distance(current_loc);
+        if (min_distance < 0 || tmp_distance < min_distance) {
+            min_distance = tmp_distance;
+            landing_start_index = idx;
+        }
+    }
+#else
+    const bool use_index = false;
+#endif
+
     // Go through mission looking for nearest landing start command
-    for (uint16_t i = 1; i < num_commands(); i++) {
+    for (uint16_t i = 1; !use_index && i < num_commands(); i++) {
         Mission_Command tmp;
         if (!read_cmd_from_storage(i, tmp)) {
             continue;
@@ -1977,7 +2137,24 @@ bool AP_Mission::jump_to_abort_landing_sequence(void)
     if (AP::ahrs().get_position(current_loc)) {
         float min_distance = FLT_MAX;
 
-        for (uint16_t i = 1; i < num_commands(); i++) {
+#if AP_MISSION_CACHE_ENABLED
+        // the cache can be written from another thread, so hold the
+        // lock while reading from it
+        WITH_SEMAPHORE(_rsem);
+        const bool use_index = update_cmd_index() && !_cmd_index.overflow;
+        for (uint8_t i = 0; use_index && i < _cmd_index.num_go_around; i++) {
+            const uint16_t idx = _cmd_index.go_around[i];
+            const float tmp_distance = _cmd_cache[idx].content.location.get_distance(current_loc);
+            if (tmp_distance < min_distance) {
+                min_distance = tmp_distance;
+                abort_index = idx;
+            }
+        }
+#else
+        const bool use_index = false;
+#endif
+
+        for (uint16_t i = 1; !use_index && i < num_commands(); i++) {
             Mission_Command tmp;
             if (!read_cmd_from_storage(i, tmp)) {
                 continue;
@@ -2243,6 +2420,109 @@ const char *AP_Mission::Mission_Command::type() const
     }
 }
 
+#if AP_MISSION_CACHE_ENABLED
+/*
+  allocate the command cache and the storage for the nav and jump
+  index. Most of the free memory is left for everything else, if
+  there is not enough the mission is read straight from storage as
+  before
+ */
+bool AP_Mission::cache_allocate(uint16_t size)
+{
+    WITH_SEMAPHORE(_rsem);
+
+    const uint32_t bytes = size * (sizeof(Mission_Command) + sizeof(uint16_t));
+    if (bytes * 4 > hal.util->available_memory()) {
+        _cmd_cache_failed = true;
+        return false;
+    }
+    _cmd_cache = new Mission_Command[size];
+    _cmd_index.next_nav_or_jump = new uint16_t[size];
+    if (_cmd_cache == nullptr || _cmd_index.next_nav_or_jump == nullptr) {
+        delete[] _cmd_cache;
+        delete[] _cmd_index.next_nav_or_jump;
+        _cmd_cache = nullptr;
+        _cmd_index.next_nav_or_jump = nullptr;
+        _cmd_cache_failed = true;
+        return false;
+    }
+    for (uint16_t i = 0; i < size; i++) {
+        _cmd_cache[i].index = AP_MISSION_CMD_INDEX_NONE;
+    }
+    _cmd_cache_size = size;
+    return true;
+}
+
+/*
+  rebuild the command indexes after the mission has been changed. This
+  reads the whole mission once, leaving it all in the cache
+ */
+bool AP_Mission::update_cmd_index()
+{
+    WITH_SEMAPHORE(_rsem);
+
+    const uint16_t total = _cmd_total;
+    if (_cmd_index.valid && _cmd_index.total == total) {
+        return true;
+    }
+    if (_cmd_cache == nullptr && !_cmd_cache_failed) {
+        cache_allocate(num_commands_max());
+    }
+    if (total > _cmd_cache_size) {
+        return false;
+    }
+
+    _cmd_index.num_land_start = 0;
+    _cmd_index.num_go_around = 0;
+    _cmd_index.overflow = false;
+    for (uint16_t i = 1; i < total; i++) {
+        Mission_Command cmd;
+        if (!read_cmd_from_storage(i, cmd)) {
+            return false;
+        }
+        if (cmd.id == MAV_CMD_DO_LAND_START) {
+            if (_cmd_index.num_land_start < ARRAY_SIZE(_cmd_index.land_start)) {
+                _cmd_index.land_start[_cmd_index.num_land_start++] = i;
+            } else {
+                _cmd_index.overflow = true;
+            }
+        } else if (cmd.id == MAV_CMD_DO_GO_AROUND) {
+            if (_cmd_index.num_go_around < ARRAY_SIZE(_cmd_index.go_around)) {
+                _cmd_index.go_around[_cmd_index.num_go_around++] = i;
+            } else {
+                _cmd_index.overflow = true;
+            }
+        }
+    }
+
+    // command 0 is home, which is a nav command
+    uint16_t next = total;
+    for (uint16_t i = total; i-- > 0; ) {
+        if (i == 0 || is_nav_cmd(_cmd_cache[i]) || _cmd_cache[i].id == MAV_CMD_DO_JUMP) {
+            next = i;
+        }
+        _cmd_index.next_nav_or_jump[i] = next;
+    }
+
+    _cmd_index.total = total;
+    _cmd_index.valid = true;
+    return true;
+}
+
+// index of the first nav or DO_JUMP command at or after index, or the
+// number of commands if there is none. index is returned unchanged if
+// there is no cache
+uint16_t AP_Mission::next_nav_or_jump(uint16_t index)
+{
+    WITH_SEMAPHORE(_rsem);
+
+    if (!update_cmd_index() || index >= _cmd_index.total) {
+        return index;
+    }
+    return _cmd_index.next_nav_or_jump[index];
+}
+#endif // AP_MISSION_CACHE_ENABLED
+
 bool AP_Mission::contains_item(MAV_CMD command) const
 {
     for (int i = 1; i < num_commands(); i++) {
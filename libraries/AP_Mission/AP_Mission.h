@@ -19,9 +19,11 @@
 #include <AP_Common/Location.h>
 #include <AP_Param/AP_Param.h>
 #include <StorageManager/StorageManager.h>
+#include "AP_Mission_FileStore.h"
 
 // definitions
 #define AP_MISSION_EEPROM_VERSION           0x65AE  // version number stored in first four bytes of eeprom.  increment this by one when eeprom format is changed
+#define AP_MISSION_FILE_VERSION             (AP_MISSION_EEPROM_VERSION | 0x10000U)  // version number stored in the eeprom and file when the mission is held in a file
 #define AP_MISSION_EEPROM_COMMAND_SIZE      15      // size in bytes of all mission commands
 
 #define AP_MISSION_MAX_NUM_DO_JUMP_COMMANDS 15      // allow up to 15 do-jump commands
@@ -44,6 +46,18 @@
 #define AP_MISSION_MAX_WP_HISTORY           7       // The maximum number of previous wp commands that will be stored from the active missions history
 #define LAST_WP_PASSED (AP_MISSION_MAX_WP_HISTORY-2)
 
+/*
+  keep a decoded copy of the mission in RAM, along with indexes of the
+  nav, DO_JUMP, DO_LAND_START and DO_GO_AROUND commands in it, so that
+  advancing through a large mission does not keep unpacking commands
+  from storage
+ */
+#ifndef AP_MISSION_CACHE_ENABLED
+#define AP_MISSION_CACHE_ENABLED (BOARD_FLASH_SIZE > 1024)
+#endif
+
+#define AP_MISSION_MAX_INDEXED_LANDINGS     8       // DO_LAND_START and DO_GO_AROUND commands remembered by the index, the mission is searched if it has more
+
 /// @class    AP_Mission
 /// @brief    Object managing Mission
 class AP_Mission
@@ -639,6 +653,10 @@ private:
     /// command list will be cleared if they do not match
     void check_eeprom_version();
 
+    // read and write the mission storage area or file
+    bool read_from_storage(uint32_t ofs, void *data, uint16_t len) const;
+    bool write_to_storage(uint32_t ofs, const void *data, uint16_t len);
+
     // check if command is a landing type command.  Asside the obvious, MAV_CMD_DO_PARACHUTE is considered a type of landing
     bool is_landing_type_cmd(uint16_t id) const;
 
@@ -654,10 +672,28 @@ private:
     /// sanity checks that the masked fields are not NaN's or infinite
     static MAV_MISSION_RESULT sanity_check_params(const mavlink_mission_item_int_t& packet);
 
+#if AP_MISSION_CACHE_ENABLED
+    // allocate the command cache if there is memory to spare
+    static bool cache_allocate(uint16_t size);
+
+    // rebuild the command indexes if the mission has changed, returns
+    // false if there is no cache to build them from
+    bool update_cmd_index();
+
+    // index of the first nav or DO_JUMP command at or after index
+    uint16_t next_nav_or_jump(uint16_t index);
+#endif
+
     // parameters
     AP_Int16                _cmd_total;  // total number of commands in the mission
     AP_Int8                 _restart;   // controls mission starting point when entering Auto mode (either restart from beginning of mission or resume from last command run)
     AP_Int16                _options;    // bitmask options for missions, currently for mission clearing on reboot but can be expanded as required
+#if AP_MISSION_FILE_ENABLED
+    AP_Int16                _file_kb;    // size of the file holding the mission, zero to use the mission storage area
+
+    // file holding the mission in place of the storage area, if enabled
+    AP_Mission_FileStore    *_file = nullptr;
+#endif
 
     // pointer to main program functions
     mission_cmd_fn_t        _cmd_start_fn;  // pointer to function which will be called when a new command is started
@@ -690,6 +726,28 @@ private:
     // const functions
     static HAL_Semaphore _rsem;
 
+#if AP_MISSION_CACHE_ENABLED
+    // decoded commands, indexed by their position in storage. Entries
+    // not yet read from storage have an index of
+    // AP_MISSION_CMD_INDEX_NONE. Static for use from const functions
+    static Mission_Command *_cmd_cache;
+    static uint16_t _cmd_cache_size;
+    static bool _cmd_cache_failed;
+
+    // indexes built from the cache, valid for a mission of
+    // _cmd_index.total commands unless a command has been written since
+    static struct cmd_index {
+        uint16_t *next_nav_or_jump;
+        uint16_t land_start[AP_MISSION_MAX_INDEXED_LANDINGS];
+        uint16_t go_around[AP_MISSION_MAX_INDEXED_LANDINGS];
+        uint8_t num_land_start;
+        uint8_t num_go_around;
+        bool overflow;
+        bool valid;
+        uint16_t total;
+    } _cmd_index;
+#endif
+
     // mission items common to all vehicles:
     bool start_command_do_gripper(const AP_Mission::Mission_Command& cmd);
     bool start_command_do_servorelayevents(const AP_Mission::Mission_Command& cmd);
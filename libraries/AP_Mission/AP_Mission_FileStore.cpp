@@ -0,0 +1,260 @@
+#include "AP_Mission_FileStore.h"
+
+#if AP_MISSION_FILE_ENABLED
+
+#include <AP_Filesystem/AP_Filesystem.h>
+#include <AP_Math/AP_Math.h>
+
+extern const AP_HAL::HAL& hal;
+
+bool AP_Mission_FileStore::init(const char *filename, uint32_t size)
+{
+    _pages = new page[AP_MISSION_FILE_NUM_PAGES];
+    if (_pages == nullptr) {
+        return false;
+    }
+    for (uint8_t i=0; i<AP_MISSION_FILE_NUM_PAGES; i++) {
+        _pages[i].ofs = UINT32_MAX;
+        _pages[i].last_use = 0;
+        _pages[i].dirty = false;
+    }
+
+    _fd = AP::FS().open(filename, O_RDWR|O_CREAT);
+    if (_fd == -1) {
+        delete[] _pages;
+        _pages = nullptr;
+        return false;
+    }
+    _size = size;
+
+    hal.scheduler->register_io_process(FUNCTOR_BIND_MEMBER(&AP_Mission_FileStore::io_timer, void));
+    return true;
+}
+
+AP_Mission_FileStore::page *AP_Mission_FileStore::find_page(uint32_t page_ofs)
+{
+    for (uint8_t i=0; i<AP_MISSION_FILE_NUM_PAGES; i++) {
+        if (_pages[i].ofs == page_ofs) {
+            return &_pages[i];
+        }
+    }
+    return nullptr;
+}
+
+/*
+  find the page holding ofs, reading it into the least recently used
+  clean page if it is not already loaded. Dirty pages are left for the
+  IO thread to write back. If every page is dirty, or the IO thread is
+  using the file, the miss fails rather than waiting and the IO thread
+  loads the page instead. prefetch() avoids misses for the commands the
+  mission is about to run
+ */
+AP_Mission_FileStore::page *AP_Mission_FileStore::get_page(uint32_t ofs)
+{
+    const uint32_t page_ofs = ofs - (ofs % AP_MISSION_FILE_PAGE_SIZE);
+    page *found = find_page(page_ofs);
+    if (found != nullptr) {
+        found->last_use = ++_use_count;
+        return found;
+    }
+
+    page *oldest = nullptr;
+    for (uint8_t i=0; i<AP_MISSION_FILE_NUM_PAGES; i++) {
+        page &p = _pages[i];
+        if (!p.dirty && p.last_use <= _op_start_use &&
+            (oldest == nullptr || p.last_use < oldest->last_use)) {
+            oldest = &p;
+        }
+    }
+
+    if (oldest == nullptr || !_file_sem.take_nonblocking()) {
+        _prefetch_ofs = page_ofs;
+        _prefetch_count = 1;
+        return nullptr;
+    }
+
+    page &p = *oldest;
+    p.ofs = UINT32_MAX;
+    const bool ok = read_file(page_ofs, p.data);
+    _file_sem.give();
+    if (!ok) {
+        return nullptr;
+    }
+    p.ofs = page_ofs;
+    p.last_use = ++_use_count;
+    return &p;
+}
+
+bool AP_Mission_FileStore::read_file(uint32_t page_ofs, uint8_t *data)
+{
+    if (AP::FS().lseek(_fd, page_ofs, SEEK_SET) != (int32_t)page_ofs) {
+        return false;
+    }
+    // the file may end part way through, or before, the page
+    const int32_t ret = AP::FS().read(_fd, data, AP_MISSION_FILE_PAGE_SIZE);
+    if (ret < 0) {
+        return false;
+    }
+    memset(&data[ret], 0, AP_MISSION_FILE_PAGE_SIZE - ret);
+    return true;
+}
+
+bool AP_Mission_FileStore::write_file(uint32_t page_ofs, const uint8_t *data)
+{
+    return AP::FS().lseek(_fd, page_ofs, SEEK_SET) == (int32_t)page_ofs &&
+           AP::FS().write(_fd, data, AP_MISSION_FILE_PAGE_SIZE) == AP_MISSION_FILE_PAGE_SIZE;
+}
+
+bool AP_Mission_FileStore::read(uint32_t ofs, void *data, uint16_t len)
+{
+    WITH_SEMAPHORE(_sem);
+
+    if (ofs + len > _size) {
+        return false;
+    }
+    _op_start_use = _use_count;
+    uint8_t *b = (uint8_t *)data;
+    while (len > 0) {
+        const page *p = get_page(ofs);
+        if (p == nullptr) {
+            return false;
+        }
+        const uint16_t pofs = ofs - p->ofs;
+        const uint16_t n = MIN(len, AP_MISSION_FILE_PAGE_SIZE - pofs);
+        memcpy(b, &p->data[pofs], n);
+        b += n;
+        ofs += n;
+        len -= n;
+    }
+    return true;
+}
+
+bool AP_Mission_FileStore::write(uint32_t ofs, const void *data, uint16_t len)
+{
+    WITH_SEMAPHORE(_sem);
+
+    if (ofs + len > _size) {
+        return false;
+    }
+    // load every page first, so a write that fails changes nothing
+    _op_start_use = _use_count;
+    for (uint32_t page_ofs = ofs - (ofs % AP_MISSION_FILE_PAGE_SIZE);
+         page_ofs < ofs + len;
+         page_ofs += AP_MISSION_FILE_PAGE_SIZE) {
+        if (get_page(page_ofs) == nullptr) {
+            return false;
+        }
+    }
+    const uint8_t *b = (const uint8_t *)data;
+    while (len > 0) {
+        page *p = get_page(ofs);
+        if (p == nullptr) {
+            return false;
+        }
+        const uint16_t pofs = ofs - p->ofs;
+        const uint16_t n = MIN(len, AP_MISSION_FILE_PAGE_SIZE - pofs);
+        if (memcmp(&p->data[pofs], b, n) != 0) {
+            memcpy(&p->data[pofs], b, n);
+            p->dirty = true;
+        }
+        b += n;
+        ofs += n;
+        len -= n;
+    }
+    return true;
+}
+
+void AP_Mission_FileStore::prefetch(uint32_t ofs)
+{
+    WITH_SEMAPHORE(_sem);
+
+    _prefetch_ofs = ofs - (ofs % AP_MISSION_FILE_PAGE_SIZE);
+    _prefetch_count = 2;
+}
+
+/*
+  write back one changed page, or load one page asked for by
+  prefetch() or a failed miss, per call. _sem is only held while a page
+  is copied and _file_sem only while the file is read or written, so
+  the main thread never waits for the file system
+ */
+void AP_Mission_FileStore::io_timer(void)
+{
+    if (!_sem.take_nonblocking()) {
+        return;
+    }
+    uint32_t ofs = UINT32_MAX;
+    bool dirty = false;
+    for (uint8_t i=0; i<AP_MISSION_FILE_NUM_PAGES; i++) {
+        const page &p = _pages[i];
+        if (p.dirty) {
+            ofs = p.ofs;
+            memcpy(_io_data, p.data, sizeof(_io_data));
+            dirty = true;
+            break;
+        }
+    }
+    while (!dirty && _prefetch_count > 0 && _prefetch_ofs < _size) {
+        const uint32_t page_ofs = _prefetch_ofs;
+        _prefetch_ofs += AP_MISSION_FILE_PAGE_SIZE;
+        _prefetch_count--;
+        if (find_page(page_ofs) == nullptr) {
+            ofs = page_ofs;
+            break;
+        }
+    }
+    _sem.give();
+
+    if (ofs == UINT32_MAX) {
+        return;
+    }
+
+    if (dirty) {
+        bool ok;
+        {
+            WITH_SEMAPHORE(_file_sem);
+            ok = write_file(ofs, _io_data);
+        }
+        if (!ok) {
+            return;
+        }
+        // the page stays dirty if it was changed again meanwhile
+        if (_sem.take_nonblocking()) {
+            page *p = find_page(ofs);
+            if (p != nullptr && memcmp(p->data, _io_data, sizeof(_io_data)) == 0) {
+                p->dirty = false;
+            }
+            _sem.give();
+        }
+        // with no lock held, so a miss can read the file meanwhile
+        AP::FS().fsync(_fd);
+        return;
+    }
+
+    bool ok;
+    {
+        WITH_SEMAPHORE(_file_sem);
+        ok = read_file(ofs, _io_data);
+    }
+    if (!ok || !_sem.take_nonblocking()) {
+        return;
+    }
+    if (find_page(ofs) == nullptr) {
+        // replace the least recently used page that needs no writing back
+        page *oldest = nullptr;
+        for (uint8_t i=0; i<AP_MISSION_FILE_NUM_PAGES; i++) {
+            page &p = _pages[i];
+            if (!p.dirty && (oldest == nullptr || p.last_use < oldest->last_use)) {
+                oldest = &p;
+            }
+        }
+        if (oldest != nullptr) {
+            memcpy(oldest->data, _io_data, sizeof(_io_data));
+            oldest->ofs = ofs;
+            oldest->last_use = ++_use_count;
+        }
+    }
+    _sem.give();
+}
+
+#endif // AP_MISSION_FILE_ENABLED
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Filesystem/AP_Filesystem_Available.h>
+
+#ifndef AP_MISSION_FILE_ENABLED
+#if HAVE_FILESYSTEM_SUPPORT && defined(HAL_BOARD_STORAGE_DIRECTORY)
+#define AP_MISSION_FILE_ENABLED 1
+#else
+#define AP_MISSION_FILE_ENABLED 0
+#endif
+#endif
+
+#if AP_MISSION_FILE_ENABLED
+
+#define AP_MISSION_FILE_NAME        HAL_BOARD_STORAGE_DIRECTORY "/mission.stg"
+#define AP_MISSION_FILE_PAGE_SIZE   512     // bytes read from or written to the file at once
+#define AP_MISSION_FILE_NUM_PAGES   8       // pages of the file held in memory
+
+/*
+  mission storage in a file, for missions too large for the storage
+  area set aside for them. The file has the same layout as that area
+  and is accessed through a few cached pages, so memory use does not
+  depend on the size of the mission. Changed pages are only written
+  back by the IO thread, so the caller never waits on a file write
+ */
+class AP_Mission_FileStore
+{
+    friend class AP_Mission_FileStore_Test;
+
+public:
+    // open the file, creating it if needed, to hold size bytes
+    bool init(const char *filename, uint32_t size);
+
+    uint32_t size(void) const { return _size; }
+
+    // read and write the store, anything never written reads as
+    // zero. These fail rather than wait when the page needed can't be
+    // loaded straight away, with the IO thread asked to load it
+    bool read(uint32_t ofs, void *data, uint16_t len);
+    bool write(uint32_t ofs, const void *data, uint16_t len);
+
+    // have the IO thread load the page holding ofs and the one after
+    // it, so reading them does not wait on the file system
+    void prefetch(uint32_t ofs);
+
+private:
+    struct page {
+        uint32_t ofs;       // file offset, UINT32_MAX when unused
+        uint32_t last_use;
+        bool dirty;
+        uint8_t data[AP_MISSION_FILE_PAGE_SIZE];
+    };
+
+    // the page holding ofs, loaded from the file if needed
+    page *get_page(uint32_t ofs);
+    page *find_page(uint32_t page_ofs);
+    bool read_file(uint32_t page_ofs, uint8_t *data);
+    bool write_file(uint32_t page_ofs, const uint8_t *data);
+    void io_timer(void);
+
+    page *_pages;
+    uint32_t _use_count;
+    // pages used since this point in the current read or write are
+    // not reused for another part of the file
+    uint32_t _op_start_use;
+    uint32_t _size;
+    int _fd = -1;
+
+    // pages for the IO thread to load, starting at _prefetch_ofs
+    uint32_t _prefetch_ofs;
+    uint8_t _prefetch_count;
+
+    // copy of a page being written or loaded by the IO thread
+    uint8_t _io_data[AP_MISSION_FILE_PAGE_SIZE];
+
+    HAL_Semaphore _sem;         // protects the pages
+    HAL_Semaphore _file_sem;    // protects the file position, only
+                                // taken without blocking with _sem held
+};
+
+#endif // AP_MISSION_FILE_ENABLED
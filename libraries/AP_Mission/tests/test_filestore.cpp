@@ -0,0 +1,180 @@
+#include <AP_gtest.h>
+
+#include <AP_Mission/AP_Mission_FileStore.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#if AP_MISSION_FILE_ENABLED
+
+#include <AP_Filesystem/AP_Filesystem.h>
+
+#define TEST_FILE_NAME "test_mission.stg"
+#define TEST_FILE_SIZE (4 * AP_MISSION_FILE_NUM_PAGES * AP_MISSION_FILE_PAGE_SIZE)
+
+class AP_Mission_FileStore_Test
+{
+public:
+    AP_Mission_FileStore_Test()
+    {
+        AP::FS().unlink(TEST_FILE_NAME);
+    }
+
+    ~AP_Mission_FileStore_Test()
+    {
+        AP::FS().close(store._fd);
+        AP::FS().unlink(TEST_FILE_NAME);
+        delete[] store._pages;
+    }
+
+    AP_Mission_FileStore store;
+
+    void io_timer() { store.io_timer(); }
+
+    // run the IO thread until every page is written back
+    void flush()
+    {
+        for (uint16_t i=0; i<AP_MISSION_FILE_NUM_PAGES; i++) {
+            io_timer();
+        }
+        EXPECT_EQ(0U, num_dirty());
+    }
+
+    uint8_t num_dirty() const
+    {
+        uint8_t n = 0;
+        for (uint8_t i=0; i<AP_MISSION_FILE_NUM_PAGES; i++) {
+            if (store._pages[i].dirty) {
+                n++;
+            }
+        }
+        return n;
+    }
+
+    bool loaded(uint32_t ofs)
+    {
+        return store.find_page(ofs - (ofs % AP_MISSION_FILE_PAGE_SIZE)) != nullptr;
+    }
+
+    // read the file itself, bypassing the pages
+    void read_file(uint32_t ofs, uint8_t *data, uint16_t len)
+    {
+        ASSERT_EQ((int32_t)ofs, AP::FS().lseek(store._fd, ofs, SEEK_SET));
+        ASSERT_EQ((int32_t)len, AP::FS().read(store._fd, data, len));
+    }
+};
+
+// repeatable pseudo random numbers
+static uint32_t random_u32(uint32_t &seed)
+{
+    seed = seed * 1103515245U + 12345U;
+    return seed >> 8;
+}
+
+/*
+  random reads and writes over a file many times the size of the
+  pages, with the IO thread running now and then, must always read
+  back what was written, and the file must end up holding it all
+ */
+TEST(AP_Mission_FileStore, paging)
+{
+    AP_Mission_FileStore_Test t;
+    ASSERT_TRUE(t.store.init(TEST_FILE_NAME, TEST_FILE_SIZE));
+
+    static uint8_t expected[TEST_FILE_SIZE];
+    uint32_t seed = 1;
+    for (uint32_t i=0; i<20000; i++) {
+        // 15 bytes is the size of a mission command
+        uint8_t data[15];
+        const uint32_t ofs = random_u32(seed) % (TEST_FILE_SIZE - sizeof(data));
+        const uint32_t op = random_u32(seed) % 8;
+        if (op < 3) {
+            for (uint8_t &b : data) {
+                b = random_u32(seed);
+            }
+            if (t.store.write(ofs, data, sizeof(data))) {
+                memcpy(&expected[ofs], data, sizeof(data));
+            }
+        } else if (op < 6) {
+            if (t.store.read(ofs, data, sizeof(data))) {
+                EXPECT_EQ(0, memcmp(&expected[ofs], data, sizeof(data)));
+            }
+        } else if (op < 7) {
+            t.store.prefetch(ofs);
+        } else {
+            t.io_timer();
+        }
+    }
+    t.flush();
+
+    static uint8_t file[TEST_FILE_SIZE];
+    t.read_file(0, file, sizeof(file));
+    EXPECT_EQ(0, memcmp(expected, file, sizeof(file)));
+}
+
+/*
+  changed pages are only written by the IO thread. A miss with every
+  page dirty fails rather than writing one back, and succeeds once the
+  IO thread has caught up
+ */
+TEST(AP_Mission_FileStore, dirty_write_back)
+{
+    AP_Mission_FileStore_Test t;
+    ASSERT_TRUE(t.store.init(TEST_FILE_NAME, TEST_FILE_SIZE));
+
+    const uint8_t value = 0x5A;
+    for (uint8_t i=0; i<AP_MISSION_FILE_NUM_PAGES; i++) {
+        ASSERT_TRUE(t.store.write(i * AP_MISSION_FILE_PAGE_SIZE, &value, 1));
+    }
+    EXPECT_EQ(AP_MISSION_FILE_NUM_PAGES, t.num_dirty());
+
+    const uint32_t miss_ofs = AP_MISSION_FILE_NUM_PAGES * AP_MISSION_FILE_PAGE_SIZE;
+    uint8_t b;
+    EXPECT_FALSE(t.store.read(miss_ofs, &b, 1));
+    EXPECT_EQ(AP_MISSION_FILE_NUM_PAGES, t.num_dirty());
+
+    // one page is written back per call
+    t.io_timer();
+    EXPECT_EQ(AP_MISSION_FILE_NUM_PAGES - 1, t.num_dirty());
+    uint8_t file_value = 0;
+    t.read_file(0, &file_value, 1);
+    EXPECT_EQ(value, file_value);
+
+    EXPECT_TRUE(t.store.read(miss_ofs, &b, 1));
+    EXPECT_EQ(0, b);
+
+    t.flush();
+    for (uint8_t i=0; i<AP_MISSION_FILE_NUM_PAGES; i++) {
+        t.read_file(i * AP_MISSION_FILE_PAGE_SIZE, &file_value, 1);
+        EXPECT_EQ(value, file_value);
+    }
+}
+
+/*
+  prefetch() has the IO thread load the page holding an offset and the
+  one after it
+ */
+TEST(AP_Mission_FileStore, prefetch)
+{
+    AP_Mission_FileStore_Test t;
+    ASSERT_TRUE(t.store.init(TEST_FILE_NAME, TEST_FILE_SIZE));
+
+    const uint32_t ofs = 5 * AP_MISSION_FILE_PAGE_SIZE + 100;
+    const uint32_t next_ofs = ofs + AP_MISSION_FILE_PAGE_SIZE;
+    EXPECT_FALSE(t.loaded(ofs));
+    EXPECT_FALSE(t.loaded(next_ofs));
+
+    t.store.prefetch(ofs);
+    t.io_timer();
+    EXPECT_TRUE(t.loaded(ofs));
+    EXPECT_FALSE(t.loaded(next_ofs));
+    t.io_timer();
+    EXPECT_TRUE(t.loaded(next_ofs));
+
+    // nothing more to do
+    t.io_timer();
+    EXPECT_FALSE(t.loaded(next_ofs + AP_MISSION_FILE_PAGE_SIZE));
+}
+
+#endif // AP_MISSION_FILE_ENABLED
+
+AP_GTEST_MAIN()
@@ -37,3 +37,90 @@ void NavEKF_core_common::fill_scratch_variables(void)
     fill_nanf(&Kfusion[0], sizeof(Kfusion)/sizeof(float));
 #endif
 }
+
+/*
+  covariance update for the fusion of a scalar measurement. K*H*P is the
+  outer product of K with the row vector H*P, so only H*P needs a sum,
+  and that only over the states H observes
+ */
+bool NavEKF_core_common::fuse_covariance(Matrix24 &P, const Vector28 &K, const ftype *H,
+                                         const uint8_t *H_states, uint8_t num_states,
+                                         uint8_t last_state, bool check_variances)
+{
+    ftype HP[24];
+    for (uint8_t j = 0; j <= last_state; j++) {
+        ftype res = 0;
+        for (uint8_t k = 0; k < num_states; k++) {
+            const uint8_t state = H_states[k];
+            res += H[state] * P[state][j];
+        }
+        HP[j] = res;
+    }
+    return update_covariance(P, K, HP, last_state, check_variances);
+}
+
+/*
+  covariance update for a direct measurement of one state, where H*P is
+  just that state's row of P
+ */
+bool NavEKF_core_common::fuse_covariance_direct(Matrix24 &P, const Vector28 &K, uint8_t state,
+                                                uint8_t last_state, bool check_variances)
+{
+    ftype HP[24];
+    for (uint8_t j = 0; j <= last_state; j++) {
+        HP[j] = P[state][j];
+    }
+    return update_covariance(P, K, HP, last_state, check_variances);
+}
+
+/*
+  P = P - K*HP, giving the same result as subtracting the full K*H*P and
+  then forcing symmetry, but computing only the upper triangle
+ */
+bool NavEKF_core_common::update_covariance(Matrix24 &P, const Vector28 &K, const ftype *HP,
+                                           uint8_t last_state, bool check_variances)
+{
+    if (check_variances) {
+        // check that we are not going to drive any variances negative
+        for (uint8_t i = 0; i <= last_state; i++) {
+            if (K[i] * HP[i] > P[i][i]) {
+                return false;
+            }
+        }
+    }
+
+    for (uint8_t i = 0; i <= last_state; i++) {
+        P[i][i] -= K[i] * HP[i];
+        for (uint8_t j = i+1; j <= last_state; j++) {
+            const ftype temp = 0.5f * ((P[i][j] - K[i] * HP[j]) + (P[j][i] - K[j] * HP[i]));
+            P[i][j] = temp;
+            P[j][i] = temp;
+        }
+    }
+    return true;
+}
+
+/*
+  copy the predicted covariances, which are only calculated for the
+  upper triangle
+ */
+void NavEKF_core_common::copy_covariance(Matrix24 &P, const Matrix24 &nextP, uint8_t last_state)
+{
+    for (uint8_t row = 0; row <= last_state; row++) {
+        P[row][row] = nextP[row][row];
+        for (uint8_t column = row+1; column <= last_state; column++) {
+            P[row][column] = P[column][row] = nextP[row][column];
+        }
+    }
+}
+
+void NavEKF_core_common::force_symmetry(Matrix24 &P, uint8_t last_state)
+{
+    for (uint8_t i = 1; i <= last_state; i++) {
+        for (uint8_t j = 0; j < i; j++) {
+            const ftype temp = 0.5f * (P[i][j] + P[j][i]);
+            P[i][j] = temp;
+            P[j][i] = temp;
+        }
+    }
+}
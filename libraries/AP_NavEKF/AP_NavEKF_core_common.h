@@ -49,4 +49,33 @@ protected:
 
     // fill all the common scratch variables with NaN on SITL
     void fill_scratch_variables(void);
+
+    /*
+      covariance kernels shared by EKF2 and EKF3. They work on the
+      states up to and including last_state, and rely on the covariance
+      matrix being symmetric, so only one triangle is computed and the
+      result is written to both
+     */
+
+    // covariance update P = P - K*H*P for a scalar measurement whose
+    // observation Jacobian H is non-zero only in the num_states states
+    // listed in H_states. If check_variances is set the update is
+    // skipped, returning false, if it would make any variance negative
+    static bool fuse_covariance(Matrix24 &P, const Vector28 &K, const ftype *H,
+                                const uint8_t *H_states, uint8_t num_states,
+                                uint8_t last_state, bool check_variances);
+
+    // as fuse_covariance() for a measurement of a single state
+    static bool fuse_covariance_direct(Matrix24 &P, const Vector28 &K, uint8_t state,
+                                       uint8_t last_state, bool check_variances);
+
+    // set P from the upper triangle of the predicted covariance
+    static void copy_covariance(Matrix24 &P, const Matrix24 &nextP, uint8_t last_state);
+
+    // make P symmetric by averaging each pair of off diagonal terms
+    static void force_symmetry(Matrix24 &P, uint8_t last_state);
+
+private:
+    static bool update_covariance(Matrix24 &P, const Vector28 &K, const ftype *HP,
+                                  uint8_t last_state, bool check_variances);
 };
@@ -0,0 +1,180 @@
+/*
+ * This file is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <AP_gtest.h>
+
+#include <AP_NavEKF/AP_NavEKF_core_common.h>
+
+const AP_HAL::HAL &hal = AP_HAL::get_HAL();
+
+class NavEKF_core_common_Test : public NavEKF_core_common
+{
+public:
+    using NavEKF_core_common::fuse_covariance;
+    using NavEKF_core_common::fuse_covariance_direct;
+    using NavEKF_core_common::copy_covariance;
+    using NavEKF_core_common::force_symmetry;
+};
+
+typedef NavEKF_core_common::ftype ftype;
+typedef NavEKF_core_common::Matrix24 Matrix24;
+typedef NavEKF_core_common::Vector28 Vector28;
+
+static const uint8_t last_state = 23;
+
+// a symmetric positive definite matrix with some correlation between states
+static void fill_covariance(Matrix24 &P)
+{
+    for (uint8_t i = 0; i <= last_state; i++) {
+        for (uint8_t j = 0; j <= last_state; j++) {
+            P[i][j] = 0.01f * (1 + (i * 7 + j * 7 + i * j) % 11);
+        }
+        P[i][i] = 2.0f + 0.1f * i;
+    }
+}
+
+// the full covariance update the fusion code used to do
+static void naive_fuse(Matrix24 &P, const Vector28 &K, const ftype *H)
+{
+    static Matrix24 KHP;
+    for (uint8_t i = 0; i <= last_state; i++) {
+        for (uint8_t j = 0; j <= last_state; j++) {
+            ftype res = 0;
+            for (uint8_t k = 0; k <= last_state; k++) {
+                res += K[i] * H[k] * P[k][j];
+            }
+            KHP[i][j] = res;
+        }
+    }
+    for (uint8_t i = 0; i <= last_state; i++) {
+        for (uint8_t j = 0; j <= last_state; j++) {
+            P[i][j] -= KHP[i][j];
+        }
+    }
+    NavEKF_core_common_Test::force_symmetry(P, last_state);
+}
+
+// Kalman gain for a scalar measurement with observation noise R
+static void calc_gain(const Matrix24 &P, const ftype *H, ftype R, Vector28 &K)
+{
+    ftype PH[24];
+    ftype var = R;
+    for (uint8_t i = 0; i <= last_state; i++) {
+        PH[i] = 0;
+        for (uint8_t j = 0; j <= last_state; j++) {
+            PH[i] += P[i][j] * H[j];
+        }
+        var += H[i] * PH[i];
+    }
+    for (uint8_t i = 0; i <= last_state; i++) {
+        K[i] = PH[i] / var;
+    }
+}
+
+static void expect_near(const Matrix24 &A, const Matrix24 &B)
+{
+    for (uint8_t i = 0; i <= last_state; i++) {
+        for (uint8_t j = 0; j <= last_state; j++) {
+            EXPECT_NEAR(A[i][j], B[i][j], 1.0e-5f) << "i=" << (int)i << " j=" << (int)j;
+        }
+    }
+}
+
+TEST(NavEKFCovarianceTest, FuseSparse)
+{
+    static Matrix24 P, P_ref;
+    static Vector28 K;
+    ftype H[24] {};
+    static const uint8_t H_states[] = {0, 1, 2, 16, 17, 18, 19, 20, 21};
+    for (uint8_t k = 0; k < ARRAY_SIZE(H_states); k++) {
+        H[H_states[k]] = 0.3f - 0.07f * k;
+    }
+
+    fill_covariance(P);
+    fill_covariance(P_ref);
+    calc_gain(P, H, 0.5f, K);
+
+    EXPECT_TRUE(NavEKF_core_common_Test::fuse_covariance(P, K, H, H_states, ARRAY_SIZE(H_states), last_state, true));
+    naive_fuse(P_ref, K, H);
+    expect_near(P, P_ref);
+}
+
+TEST(NavEKFCovarianceTest, FuseDirect)
+{
+    static Matrix24 P, P_ref;
+    static Vector28 K;
+    ftype H[24] {};
+    const uint8_t state = 7;
+    H[state] = 1.0f;
+
+    fill_covariance(P);
+    fill_covariance(P_ref);
+    calc_gain(P, H, 0.5f, K);
+
+    EXPECT_TRUE(NavEKF_core_common_Test::fuse_covariance_direct(P, K, state, last_state, true));
+    naive_fuse(P_ref, K, H);
+    expect_near(P, P_ref);
+}
+
+TEST(NavEKFCovarianceTest, RejectNegativeVariance)
+{
+    static Matrix24 P, P_ref;
+    static Vector28 K;
+    ftype H[24] {};
+    static const uint8_t H_states[] = {3, 4};
+    H[3] = 1.0f;
+    H[4] = 1.0f;
+
+    fill_covariance(P);
+    // a gain much too large for the covariance it is applied to
+    calc_gain(P, H, 0.5f, K);
+    for (uint8_t i = 0; i <= last_state; i++) {
+        K[i] *= 10.0f;
+    }
+    memcpy(&P_ref, &P, sizeof(P));
+
+    EXPECT_FALSE(NavEKF_core_common_Test::fuse_covariance(P, K, H, H_states, ARRAY_SIZE(H_states), last_state, true));
+    expect_near(P, P_ref);
+
+    // without the check the update goes ahead regardless
+    EXPECT_TRUE(NavEKF_core_common_Test::fuse_covariance(P, K, H, H_states, ARRAY_SIZE(H_states), last_state, false));
+    EXPECT_LT(P[3][3], 0.0f);
+}
+
+TEST(NavEKFCovarianceTest, CopyUpperTriangle)
+{
+    static Matrix24 P, nextP;
+    const uint8_t limit = 21;
+    for (uint8_t i = 0; i <= last_state; i++) {
+        for (uint8_t j = 0; j <= last_state; j++) {
+            // only the upper triangle of nextP is meaningful
+            nextP[i][j] = (j >= i) ? (i + 0.01f * j) : -1.0f;
+            P[i][j] = 99.0f;
+        }
+    }
+
+    NavEKF_core_common_Test::copy_covariance(P, nextP, limit);
+    for (uint8_t i = 0; i <= last_state; i++) {
+        for (uint8_t j = 0; j <= last_state; j++) {
+            if (i > limit || j > limit) {
+                EXPECT_EQ(P[i][j], 99.0f);
+            } else {
+                const uint8_t r = MIN(i, j), c = MAX(i, j);
+                EXPECT_EQ(P[i][j], nextP[r][c]);
+            }
+        }
+    }
+}
+
+AP_GTEST_MAIN()
@@ -1406,15 +1406,6 @@ void NavEKF2_core::CovariancePrediction()
         }
     }
 
-    // Copy upper diagonal to lower diagonal taking advantage of symmetry
-    for (uint8_t colIndex=0; colIndex<=stateIndexLim; colIndex++)
-    {
-        for (uint8_t rowIndex=0; rowIndex<colIndex; rowIndex++)
-        {
-            nextP[colIndex][rowIndex] = nextP[rowIndex][colIndex];
-        }
-    }
-
     // add the general state process noise variances
     for (uint8_t i=0; i<=stateIndexLim; i++)
     {
@@ -1437,7 +1428,7 @@ void NavEKF2_core::CovariancePrediction()
         }
     }
 
-    // copy covariances to output
+    // copy covariances to output, filling in the lower diagonal from the upper
     CopyCovariances();
 
     // constrain diagonals to prevent ill-conditioning
@@ -1514,27 +1505,14 @@ void NavEKF2_core::quat2Tbn(Matrix3f &Tbn, const Quaternion &quat) const
 // force symmetry on the covariance matrix to prevent ill-conditioning
 void NavEKF2_core::ForceSymmetry()
 {
-    for (uint8_t i=1; i<=stateIndexLim; i++)
-    {
-        for (uint8_t j=0; j<=i-1; j++)
-        {
-            float temp = 0.5f*(P[i][j] + P[j][i]);
-            P[i][j] = temp;
-            P[j][i] = temp;
-        }
-    }
+    force_symmetry(P, stateIndexLim);
 }
 
 // copy covariances across from covariance prediction calculation
 void NavEKF2_core::CopyCovariances()
 {
-    // copy predicted covariances
-    for (uint8_t i=0; i<=stateIndexLim; i++) {
-        for (uint8_t j=0; j<=stateIndexLim; j++)
-        {
-            P[i][j] = nextP[i][j];
-        }
-    }
+    // copy predicted covariances, which are only calculated for the upper diagonal
+    copy_covariance(P, nextP, stateIndexLim);
 }
 
 // constrain variances (diagonal terms) in the state covariance matrix to  prevent ill-conditioning
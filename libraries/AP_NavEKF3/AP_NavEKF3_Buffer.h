@@ -1,113 +1,119 @@
 // EKF Buffer models
 
-// this buffer model is to be used for observation buffers,
-// the data is pushed into buffer like any standard ring buffer
-// return is based on the sample time provided
-template <typename element_type>
-class obs_ring_buffer_t
+/*
+  one allocation holding the storage for all of a core's buffers. The
+  buffers are laid out twice: the first pass, before allocate(), only
+  adds up the space they need, and the second hands each its share
+ */
+class EKF3_buffer_arena
 {
 public:
-    struct element_t{
-        element_type element;
-    } *buffer;
+    // start the sizing pass, during which take() hands out nothing
+    void begin()
+    {
+        _sizing = true;
+        _used = 0;
+    }
 
-    // initialise buffer, returns false when allocation has failed
-    bool init(uint32_t size)
+    // space for count elements of type T, or nullptr when sizing
+    template <typename T>
+    T *take(uint8_t count)
     {
-        buffer = new element_t[size];
-        if(buffer == nullptr)
-        {
+        _used = (_used + alignof(T) - 1) & ~(uint32_t)(alignof(T) - 1);
+        T *ret = _sizing ? nullptr : (T *)&_storage[_used];
+        _used += count * sizeof(T);
+        return ret;
+    }
+
+    // replace any previous storage with enough for everything taken
+    // while sizing and start handing it out, returns false when
+    // allocation has failed
+    bool allocate()
+    {
+        delete[] _storage;
+        _size = _used;
+        _storage = new uint8_t[_size];
+        if (_storage == nullptr) {
+            _size = 0;
             return false;
         }
-        memset((void *)buffer,0,size*sizeof(element_t));
-        _size = size;
-        _head = 0;
-        _tail = 0;
-        _new_data = false;
+        memset(_storage, 0, _size);
+        _sizing = false;
+        _used = 0;
         return true;
     }
 
+    // total bytes of buffer storage
+    uint32_t size() const { return _size; }
+
+private:
+    uint8_t *_storage = nullptr;
+    uint32_t _size = 0;
+    uint32_t _used = 0;
+    bool _sizing = true;
+};
+
+// this buffer model is to be used for observation buffers,
+// the data is pushed into buffer like any standard ring buffer
+// and must arrive in time order, so that recall() can work forward
+// from the oldest data and never needs to look at anything twice
+template <typename element_type>
+class EKF3_obs_ring_buffer_t
+{
+public:
+    // take storage for size elements from the arena
+    void init(EKF3_buffer_arena &arena, uint8_t size)
+    {
+        buffer = arena.take<element_type>(size);
+        _size = size;
+        _oldest = 0;
+        _count = 0;
+    }
+
     /*
-     * Searches through a ring buffer and return the newest data that is older than the
-     * time specified by sample_time_ms
-     * Zeros old data so it cannot not be used again
+     * Return the newest data that is older than the time specified by
+     * sample_time_ms, discarding it and everything older so it cannot
+     * be used again
      * Returns false if no data can be found that is less than 100msec old
     */
-
-    bool recall(element_type &element,uint32_t sample_time)
+    bool recall(element_type &element, uint32_t sample_time)
     {
-        if(!_new_data) {
-            return false;
+        const element_type *best = nullptr;
+        while (_count != 0 && buffer[_oldest].time_ms <= sample_time) {
+            best = &buffer[_oldest];
+            _oldest = (_oldest+1)%_size;
+            _count--;
         }
-        bool success = false;
-        uint8_t tail = _tail, bestIndex;
-
-        if(_head == tail) {
-            if (buffer[tail].element.time_ms != 0 && buffer[tail].element.time_ms <= sample_time) {
-                // if head is equal to tail just check if the data is unused and within time horizon window
-                if (((sample_time - buffer[tail].element.time_ms) < 100)) {
-                    bestIndex = tail;
-                    success = true;
-                    _new_data = false;
-                }
-            }
-        } else {
-            while(_head != tail) {
-                // find a measurement older than the fusion time horizon that we haven't checked before
-                if (buffer[tail].element.time_ms != 0 && buffer[tail].element.time_ms <= sample_time) {
-                    // Find the most recent non-stale measurement that meets the time horizon criteria
-                    if (((sample_time - buffer[tail].element.time_ms) < 100)) {
-                        bestIndex = tail;
-                        success = true;
-                    }
-                } else if(buffer[tail].element.time_ms > sample_time){
-                    break;
-                }
-                tail = (tail+1)%_size;
-            }
-        }
-
-        if (success) {
-            element = buffer[bestIndex].element;
-            _tail = (bestIndex+1)%_size;
-            //make time zero to stop using it again,
-            //resolves corner case of reusing the element when head == tail
-            buffer[bestIndex].element.time_ms = 0;
-            return true;
-        } else {
+        if (best == nullptr || (sample_time - best->time_ms) >= 100) {
             return false;
         }
+        element = *best;
+        return true;
     }
 
     /*
-     * Writes data and timestamp to a Ring buffer and advances indices that
-     * define the location of the newest and oldest data
+     * Writes data to the newest position in the buffer, dropping the
+     * oldest data if it is full
     */
-    inline void push(element_type element)
+    inline void push(const element_type &element)
     {
-        // Advance head to next available index
-        _head = (_head+1)%_size;
-        // New data is written at the head
-        buffer[_head].element = element;
-        _new_data = true;
-    }
-    // writes the same data to all elements in the ring buffer
-    inline void reset_history(element_type element, uint32_t sample_time) {
-        for (uint8_t index=0; index<_size; index++) {
-            buffer[index].element = element;
+        if (_count == _size) {
+            _oldest = (_oldest+1)%_size;
+            _count--;
         }
+        buffer[(_oldest+_count)%_size] = element;
+        _count++;
     }
 
-    // zeroes all data in the ring buffer
+    // empties the buffer
     inline void reset() {
-        _head = 0;
-        _tail = 0;
-        _new_data = false;
-        memset((void *)buffer,0,_size*sizeof(element_t));
+        _oldest = 0;
+        _count = 0;
     }
 
 private:
-    uint8_t _size,_head,_tail,_new_data;
+    element_type *buffer;
+    uint8_t _size,_oldest,_count;
 };
 
 
@@ -115,36 +121,27 @@ private:
 // it achieves a distance of sample size
 // between youngest and oldest
 template <typename element_type>
-class imu_ring_buffer_t
+class EKF3_imu_ring_buffer_t
 {
 public:
-    struct element_t{
-        element_type element;
-    } *buffer;
-
-    // initialise buffer, returns false when allocation has failed
-    bool init(uint32_t size)
+    // take storage for size elements from the arena
+    void init(EKF3_buffer_arena &arena, uint8_t size)
     {
-        buffer = new element_t[size];
-        if(buffer == nullptr)
-        {
-            return false;
-        }
-        memset((void *)buffer,0,size*sizeof(element_t));
+        buffer = arena.take<element_type>(size);
         _size = size;
         _youngest = 0;
         _oldest = 0;
-        return true;
+        _filled = false;
     }
     /*
      * Writes data to a Ring buffer and advances indices that
      * define the location of the newest and oldest data
     */
-    inline void push_youngest_element(element_type element)
+    inline void push_youngest_element(const element_type &element)
     {
         // push youngest to the buffer
         _youngest = (_youngest+1)%_size;
-        buffer[_youngest].element = element;
+        buffer[_youngest] = element;
         // set oldest data index
         _oldest = (_youngest+1)%_size;
         if (_oldest == 0) {
@@ -156,17 +153,16 @@ public:
     inline bool is_filled(void) const {
         return _filled;
     }
-    
+
     // retrieve the oldest data from the ring buffer tail
-    inline element_type pop_oldest_element() {
-        element_type ret = buffer[_oldest].element;
-        return ret;
+    inline const element_type &pop_oldest_element() const {
+        return buffer[_oldest];
     }
 
     // writes the same data to all elements in the ring buffer
-    inline void reset_history(element_type element) {
+    inline void reset_history(const element_type &element) {
         for (uint8_t index=0; index<_size; index++) {
-            buffer[index].element = element;
+            buffer[index] = element;
         }
     }
 
@@ -174,12 +170,12 @@ public:
     inline void reset() {
         _youngest = 0;
         _oldest = 0;
-        memset((void *)buffer,0,_size*sizeof(element_t));
+        memset((void *)buffer,0,_size*sizeof(element_type));
     }
 
     // retrieves data from the ring buffer at a specified index
     inline element_type& operator[](uint32_t index) {
-        return buffer[index].element;
+        return buffer[index];
     }
 
     // returns the index for the ring buffer oldest data
@@ -192,6 +188,7 @@ public:
         return _youngest;
     }
 private:
+    element_type *buffer;
     uint8_t _size,_oldest,_youngest;
     bool _filled;
 };
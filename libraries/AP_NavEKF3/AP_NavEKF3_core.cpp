@@ -122,49 +122,30 @@ bool NavEKF3_core::setup_core(uint8_t _imu_index, uint8_t _core_index)
     // buffer size for external yaw
     const uint8_t yaw_angle_buffer_length = MAX(obs_buffer_length, extnav_buffer_length);
 
-    if(!storedGPS.init(obs_buffer_length)) {
-        return false;
-    }
-    if(!storedMag.init(obs_buffer_length)) {
-        return false;
-    }
-    if(!storedBaro.init(obs_buffer_length)) {
-        return false;
-    }
-    if(!storedTAS.init(obs_buffer_length)) {
-        return false;
-    }
-    if (!storedOF.init(flow_buffer_length)) {
-        return false;
-    }
-    if(!storedBodyOdm.init(obs_buffer_length)) {
-        return false;
-    }
-    if(!storedWheelOdm.init(imu_buffer_length)) { // initialise to same length of IMU to allow for multiple wheel sensors
-        return false;
-    }
-    if(!storedYawAng.init(yaw_angle_buffer_length)) {
-        return false;
-    }
-    // Note: the use of dual range finders potentially doubles the amount of data to be stored
-    if(!storedRange.init(MIN(2*obs_buffer_length , imu_buffer_length))) {
-        return false;
-    }
-    // Note: range beacon data is read one beacon at a time and can arrive at a high rate
-    if(!storedRangeBeacon.init(imu_buffer_length+1)) {
-        return false;
-    }
-    if (!storedExtNav.init(extnav_buffer_length)) {
-        return false;
-    }
-    if (!storedExtNavVel.init(extnav_buffer_length)) {
-        return false;
-    }
-    if(!storedIMU.init(imu_buffer_length)) {
-        return false;
-    }
-    if(!storedOutput.init(imu_buffer_length)) {
-        return false;
+    // lay the buffers out twice, first to size the storage they share and
+    // then to give each its part of it
+    bufferArena.begin();
+    for (uint8_t pass = 0; pass < 2; pass++) {
+        storedGPS.init(bufferArena, obs_buffer_length);
+        storedMag.init(bufferArena, obs_buffer_length);
+        storedBaro.init(bufferArena, obs_buffer_length);
+        storedTAS.init(bufferArena, obs_buffer_length);
+        storedOF.init(bufferArena, flow_buffer_length);
+        storedBodyOdm.init(bufferArena, obs_buffer_length);
+        // initialise to same length of IMU to allow for multiple wheel sensors
+        storedWheelOdm.init(bufferArena, imu_buffer_length);
+        storedYawAng.init(bufferArena, yaw_angle_buffer_length);
+        // Note: the use of dual range finders potentially doubles the amount of data to be stored
+        storedRange.init(bufferArena, MIN(2*obs_buffer_length , imu_buffer_length));
+        // Note: range beacon data is read one beacon at a time and can arrive at a high rate
+        storedRangeBeacon.init(bufferArena, imu_buffer_length+1);
+        storedExtNav.init(bufferArena, extnav_buffer_length);
+        storedExtNavVel.init(bufferArena, extnav_buffer_length);
+        storedIMU.init(bufferArena, imu_buffer_length);
+        storedOutput.init(bufferArena, imu_buffer_length);
+        if (pass == 0 && !bufferArena.allocate()) {
+            return false;
+        }
     }
     gcs().send_text(MAV_SEVERITY_INFO, "EKF3 IMU%u buffs IMU=%u OBS=%u OF=%u EN:%u, dt=%.4f",
                     (unsigned)imu_index,
@@ -1471,16 +1452,9 @@ void NavEKF3_core::CovariancePrediction()
         }
     }
 
-    // covariance matrix is symmetrical, so copy diagonals and copy lower half in nextP
+    // covariance matrix is symmetrical, so copy diagonals and copy upper half in nextP
     // to lower and upper half in P
-    for (uint8_t row = 0; row <= stateIndexLim; row++) {
-        // copy diagonals
-        P[row][row] = nextP[row][row];
-        // copy off diagonals
-        for (uint8_t column = 0 ; column < row; column++) {
-            P[row][column] = P[column][row] = nextP[column][row];
-        }
-    }
+    copy_covariance(P, nextP, stateIndexLim);
 
     // constrain values to prevent ill-conditioning
     ConstrainVariances();
@@ -1556,15 +1530,7 @@ void NavEKF3_core::quat2Tbn(Matrix3f &Tbn, const Quaternion &quat) const
 // force symmetry on the covariance matrix to prevent ill-conditioning
 void NavEKF3_core::ForceSymmetry()
 {
-    for (uint8_t i=1; i<=stateIndexLim; i++)
-    {
-        for (uint8_t j=0; j<=i-1; j++)
-        {
-            float temp = 0.5f*(P[i][j] + P[j][i]);
-            P[i][j] = temp;
-            P[j][i] = temp;
-        }
-    }
+    force_symmetry(P, stateIndexLim);
 }
 
 // constrain variances (diagonal terms) in the state covariance matrix to  prevent ill-conditioning
@@ -0,0 +1,164 @@
+#include <AP_gtest.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_NavEKF3/AP_NavEKF3_Buffer.h>
+
+const AP_HAL::HAL &hal = AP_HAL::get_HAL();
+
+struct test_element {
+    uint32_t time_ms;
+    uint32_t value;
+};
+
+#define BUFFER_SIZE 5
+
+/*
+  recall() returns the newest data no newer than the time asked for and
+  throws it away along with everything older
+ */
+TEST(EKF3_obs_ring_buffer_t, recall_order)
+{
+    EKF3_buffer_arena arena;
+    EKF3_obs_ring_buffer_t<test_element> buffer;
+    arena.begin();
+    buffer.init(arena, BUFFER_SIZE);
+    ASSERT_TRUE(arena.allocate());
+    buffer.init(arena, BUFFER_SIZE);
+
+    test_element e {};
+    EXPECT_FALSE(buffer.recall(e, 1000));
+
+    for (uint32_t i = 0; i < 4; i++) {
+        buffer.push(test_element{1000 + 10 * i, i});
+    }
+
+    // nothing is old enough yet
+    EXPECT_FALSE(buffer.recall(e, 999));
+
+    // the newest of the first three
+    EXPECT_TRUE(buffer.recall(e, 1025));
+    EXPECT_EQ(1020U, e.time_ms);
+    EXPECT_EQ(2U, e.value);
+
+    // those are gone, leaving only the last
+    EXPECT_FALSE(buffer.recall(e, 1025));
+    EXPECT_TRUE(buffer.recall(e, 1030));
+    EXPECT_EQ(3U, e.value);
+    EXPECT_FALSE(buffer.recall(e, 2000));
+}
+
+/*
+  data that is 100ms or more older than the time asked for is stale. It
+  is not returned but is still thrown away
+ */
+TEST(EKF3_obs_ring_buffer_t, stale_data)
+{
+    EKF3_buffer_arena arena;
+    EKF3_obs_ring_buffer_t<test_element> buffer;
+    arena.begin();
+    buffer.init(arena, BUFFER_SIZE);
+    ASSERT_TRUE(arena.allocate());
+    buffer.init(arena, BUFFER_SIZE);
+
+    test_element e {};
+    buffer.push(test_element{1000, 0});
+    buffer.push(test_element{1050, 1});
+    EXPECT_FALSE(buffer.recall(e, 1150));
+    buffer.push(test_element{1200, 2});
+    EXPECT_TRUE(buffer.recall(e, 1299));
+    EXPECT_EQ(2U, e.value);
+
+    // a reset empties the buffer
+    buffer.push(test_element{1300, 3});
+    buffer.reset();
+    EXPECT_FALSE(buffer.recall(e, 1300));
+}
+
+/*
+  a full buffer drops its oldest data to make room
+ */
+TEST(EKF3_obs_ring_buffer_t, overflow)
+{
+    EKF3_buffer_arena arena;
+    EKF3_obs_ring_buffer_t<test_element> buffer;
+    arena.begin();
+    buffer.init(arena, BUFFER_SIZE);
+    ASSERT_TRUE(arena.allocate());
+    buffer.init(arena, BUFFER_SIZE);
+
+    for (uint32_t i = 0; i < 3 * BUFFER_SIZE + 2; i++) {
+        buffer.push(test_element{1000 + i, i});
+    }
+
+    // only the newest BUFFER_SIZE are left, recalled oldest first
+    test_element e {};
+    EXPECT_FALSE(buffer.recall(e, 1000 + 2 * BUFFER_SIZE + 1));
+    for (uint32_t i = 2 * BUFFER_SIZE + 2; i < 3 * BUFFER_SIZE + 2; i++) {
+        EXPECT_TRUE(buffer.recall(e, 1000 + i));
+        EXPECT_EQ(i, e.value);
+    }
+    EXPECT_FALSE(buffer.recall(e, 2000));
+}
+
+/*
+  the IMU buffer keeps a fixed delay between the newest and oldest data
+ */
+TEST(EKF3_imu_ring_buffer_t, push_order)
+{
+    EKF3_buffer_arena arena;
+    EKF3_imu_ring_buffer_t<test_element> buffer;
+    arena.begin();
+    buffer.init(arena, BUFFER_SIZE);
+    ASSERT_TRUE(arena.allocate());
+    buffer.init(arena, BUFFER_SIZE);
+
+    buffer.reset_history(test_element{0, 100});
+    EXPECT_EQ(100U, buffer.pop_oldest_element().value);
+
+    for (uint32_t i = 0; i < 4 * BUFFER_SIZE; i++) {
+        buffer.push_youngest_element(test_element{i, i});
+        EXPECT_EQ(i, buffer[buffer.get_youngest_index()].value);
+        if (i + 1 < BUFFER_SIZE) {
+            // the history set above until the buffer has wrapped
+            EXPECT_EQ(100U, buffer.pop_oldest_element().value);
+        } else {
+            EXPECT_EQ(i + 1 - BUFFER_SIZE, buffer.pop_oldest_element().value);
+        }
+        EXPECT_EQ(i + 1 >= BUFFER_SIZE - 1, buffer.is_filled());
+    }
+}
+
+/*
+  the buffers of a core share one allocation without overlapping
+ */
+TEST(EKF3_buffer_arena, layout)
+{
+    EKF3_buffer_arena arena;
+    EKF3_obs_ring_buffer_t<test_element> obs;
+    EKF3_imu_ring_buffer_t<uint8_t> small;
+    EKF3_imu_ring_buffer_t<test_element> imu;
+
+    arena.begin();
+    obs.init(arena, BUFFER_SIZE);
+    small.init(arena, 3);
+    imu.init(arena, BUFFER_SIZE);
+    ASSERT_TRUE(arena.allocate());
+    obs.init(arena, BUFFER_SIZE);
+    small.init(arena, 3);
+    imu.init(arena, BUFFER_SIZE);
+    EXPECT_EQ(2 * BUFFER_SIZE * sizeof(test_element) + 4, arena.size());
+
+    // filling one buffer leaves the others untouched
+    small.reset_history(0xFF);
+    imu.reset_history(test_element{1, 2});
+    for (uint32_t i = 0; i < BUFFER_SIZE; i++) {
+        obs.push(test_element{i, 0xFFFFFFFF});
+    }
+    EXPECT_EQ(0xFF, small[0]);
+    EXPECT_EQ(0xFF, small[2]);
+    for (uint8_t i = 0; i < BUFFER_SIZE; i++) {
+        EXPECT_EQ(2U, imu[i].value);
+    }
+}
+
+AP_GTEST_MAIN()
@@ -24,6 +24,7 @@
 #include "AP_Param.h"
 
 #include <cmath>
+#include <ctype.h>
 #include <string.h>
 
 #include <AP_Common/AP_Common.h>
@@ -76,6 +77,31 @@ uint16_t AP_Param::_parameter_count;
 uint16_t AP_Param::_count_marker;
 uint16_t AP_Param::_count_marker_done;
 HAL_Semaphore AP_Param::_count_sem;
+#if AP_PARAM_TOKEN_TABLE_ENABLED
+AP_Param::ParamToken *AP_Param::_token_table;
+uint16_t AP_Param::_token_table_size;
+#endif
+
+// index of parameter offsets in storage
+#if AP_PARAM_STORAGE_INDEX_ENABLED
+uint16_t *AP_Param::_storage_index;
+uint16_t AP_Param::_storage_index_size;
+uint16_t AP_Param::_storage_index_count;
+bool AP_Param::_storage_index_failed;
+HAL_Semaphore AP_Param::_storage_index_sem;
+#endif
+AP_HAL::Util::perf_counter_t AP_Param::_perf_index;
+
+#if AP_PARAM_NAME_INDEX_ENABLED
+// index of parameter tokens by name
+AP_Param::ParamToken *AP_Param::_name_index;
+uint16_t AP_Param::_name_index_size;
+uint16_t AP_Param::_name_index_marker;
+HAL_Semaphore AP_Param::_name_index_sem;
+uint16_t *AP_Param::_name_index_enable;
+AP_Param::NameIndexEnable *AP_Param::_name_index_enables;
+uint16_t AP_Param::_name_index_enables_size;
+#endif
 
 // storage and naming information about all types that can be saved
 const AP_Param::Info *AP_Param::_var_info;
@@ -84,7 +110,7 @@ struct AP_Param::param_override *AP_Param::param_overrides = nullptr;
 uint16_t AP_Param::num_param_overrides = 0;
 uint16_t AP_Param::num_read_only = 0;
 
-ObjectBuffer_TS<AP_Param::param_save> AP_Param::save_queue{30};
+ObjectBuffer_TS<AP_Param::param_save> AP_Param::save_queue{save_queue_size};
 bool AP_Param::registered_save_handler;
 
 // we need a dummy object for the parameter save callback
@@ -144,6 +170,15 @@ void AP_Param::erase_all(void)
 
     // add a sentinal directly after the header
     write_sentinal(sizeof(struct EEPROM_header));
+
+#if AP_PARAM_STORAGE_INDEX_ENABLED
+    // nothing is stored any more
+    WITH_SEMAPHORE(_storage_index_sem);
+    if (_storage_index != nullptr) {
+        memset(_storage_index, 0, _storage_index_size*sizeof(_storage_index[0]));
+        _storage_index_count = 0;
+    }
+#endif
 }
 
 /* the 'group_id' of a element of a group is the 18 bit identifier
@@ -699,6 +734,24 @@ bool AP_Param::is_sentinal(const Param_header &phdr)
 // if the sentinal isn't found either, the offset is set to 0xFFFF
 bool AP_Param::scan(const AP_Param::Param_header *target, uint16_t *pofs)
 {
+#if AP_PARAM_STORAGE_INDEX_ENABLED
+    {
+        WITH_SEMAPHORE(_storage_index_sem);
+        if (_storage_index == nullptr && !_storage_index_failed && !index_storage(0)) {
+            _storage_index_failed = true;
+        }
+        if (_storage_index != nullptr) {
+            uint16_t slot;
+            if (index_find(*target, *pofs, slot)) {
+                return true;
+            }
+            *pofs = sentinal_offset;
+            return false;
+        }
+    }
+#endif
+
+    // no index, so walk the storage
     struct Param_header phdr;
     uint16_t ofs = sizeof(AP_Param::EEPROM_header);
     while (ofs < _storage.size()) {
@@ -723,6 +776,116 @@ bool AP_Param::scan(const AP_Param::Param_header *target, uint16_t *pofs)
     return false;
 }
 
+#if AP_PARAM_STORAGE_INDEX_ENABLED
+/*
+  build the storage index, with room for at least min_entries
+  parameters. Returns false, leaving scan() to walk the storage, if
+  there is no sentinal or not enough memory
+*/
+bool AP_Param::index_storage(uint16_t min_entries)
+{
+    // count what is stored, finding the sentinal
+    struct Param_header phdr;
+    uint16_t ofs = sizeof(AP_Param::EEPROM_header);
+    uint16_t count = 0;
+    while (true) {
+        if (ofs >= _storage.size()) {
+            return false;
+        }
+        _storage.read_block(&phdr, ofs, sizeof(phdr));
+        if (is_sentinal(phdr)) {
+            break;
+        }
+        count++;
+        ofs += type_size((enum ap_var_type)phdr.type) + sizeof(phdr);
+    }
+    sentinal_offset = ofs;
+
+    // keep the table at most 3/4 full, with room to save some more
+    // parameters before it has to grow
+    const uint16_t entries = MAX(count, min_entries) + 32;
+    uint16_t size = 64;
+    while (size < entries + entries/3) {
+        size *= 2;
+    }
+    uint16_t *index = new uint16_t[size];
+    if (index == nullptr) {
+        return false;
+    }
+    memset(index, 0, size*sizeof(index[0]));
+
+    delete[] _storage_index;
+    _storage_index = index;
+    _storage_index_size = size;
+    _storage_index_count = 0;
+
+    for (ofs = sizeof(AP_Param::EEPROM_header); ofs != sentinal_offset; ) {
+        _storage.read_block(&phdr, ofs, sizeof(phdr));
+        uint16_t existing, slot;
+        if (!index_find(phdr, existing, slot)) {
+            // only the first copy of a parameter is ever used
+            _storage_index[slot] = ofs;
+            _storage_index_count++;
+        }
+        ofs += type_size((enum ap_var_type)phdr.type) + sizeof(phdr);
+    }
+    return true;
+}
+
+/*
+  find a parameter in the storage index, returning its offset. If it
+  isn't there slot is set to the empty slot it would go into
+*/
+bool AP_Param::index_find(const Param_header &phdr, uint16_t &ofs, uint16_t &slot)
+{
+    // Fibonacci hash of the whole header, which is exactly the type,
+    // key and group_element
+    uint32_t v;
+    memcpy(&v, &phdr, sizeof(v));
+    const uint16_t mask = _storage_index_size - 1;
+    slot = (v * 2654435761U) >> 16;
+    while (true) {
+        slot &= mask;
+        ofs = _storage_index[slot];
+        if (ofs == 0) {
+            return false;
+        }
+        uint32_t stored;
+        _storage.read_block(&stored, ofs, sizeof(stored));
+        if (stored == v) {
+            return true;
+        }
+        slot++;
+    }
+}
+
+/*
+  add a newly saved parameter to the storage index
+*/
+void AP_Param::index_add(const Param_header &phdr, uint16_t ofs)
+{
+    WITH_SEMAPHORE(_storage_index_sem);
+    if (_storage_index == nullptr) {
+        return;
+    }
+    if ((_storage_index_count+1)*4 > _storage_index_size*3) {
+        // the new parameter is already in storage, so rebuilding
+        // picks it up
+        if (!index_storage(_storage_index_count*2)) {
+            delete[] _storage_index;
+            _storage_index = nullptr;
+            _storage_index_failed = true;
+        }
+        return;
+    }
+    uint16_t existing, slot;
+    if (!index_find(phdr, existing, slot)) {
+        _storage_index[slot] = ofs;
+        _storage_index_count++;
+    }
+}
+#endif // AP_PARAM_STORAGE_INDEX_ENABLED
+
 /**
  * add a _X, _Y, _Z suffix to the name of a Vector3f element
  * @param buffer
@@ -854,6 +1017,25 @@ AP_Param::find_group(const char *name, uint16_t vindex, ptrdiff_t group_offset,
 AP_Param *
 AP_Param::find(const char *name, enum ap_var_type *ptype, uint16_t *flags)
 {
+#if AP_PARAM_NAME_INDEX_ENABLED
+    ParamToken token;
+    bool hidden;
+    AP_Param *ip = find_by_name_index(name, false, ptype, token, hidden);
+    if (ip != nullptr) {
+        if (flags != nullptr) {
+            uint32_t group_element = 0;
+            const struct GroupInfo *ginfo;
+            struct GroupNesting group_nesting {};
+            uint8_t idx;
+            ip->find_var_info_token(token, &group_element, ginfo, group_nesting, &idx);
+            if (ginfo != nullptr) {
+                *flags = ginfo->flags;
+            }
+        }
+        return ip;
+    }
+    // not indexed, or named in a different case to its declaration
+#endif
     for (uint16_t i=0; i<_num_vars; i++) {
         uint8_t type = _var_info[i].type;
         if (type == AP_PARAM_GROUP) {
@@ -894,11 +1076,26 @@ AP_Param::find(const char *name, enum ap_var_type *ptype, uint16_t *flags)
     return nullptr;
 }
 
-// Find a variable by index. Note that this is quite slow.
+// Find a variable by index. Note that this is quite slow without the
+// token table.
 //
 AP_Param *
-AP_Param::find_by_index(uint16_t idx, enum ap_var_type *ptype, ParamToken *token)
-{
+AP_Param::find_by_index(uint16_t idx, enum ap_var_type *ptype, ParamToken *token,
+                        char *name, size_t name_size)
+{
+#if AP_PARAM_TOKEN_TABLE_ENABLED
+    {
+        WITH_SEMAPHORE(_count_sem);
+        const uint16_t count = count_parameters();
+        if (count <= _token_table_size) {
+            if (idx >= count) {
+                return nullptr;
+            }
+            *token = _token_table[idx];
+            return find_by_token(*token, ptype, name, name_size);
+        }
+    }
+#endif
     AP_Param *ap;
     uint16_t count=0;
     for (ap=AP_Param::first(token, ptype);
@@ -906,6 +1103,9 @@ AP_Param::find_by_index(uint16_t idx, enum ap_var_type *ptype, ParamToken *token
          ap=AP_Param::next_scalar(token, ptype)) {
         count++;
     }
+    if (ap != nullptr && name != nullptr) {
+        ap->copy_name_token(*token, name, name_size, true);
+    }
     return ap;    
 }
 
@@ -913,6 +1113,15 @@ AP_Param::find_by_index(uint16_t idx, enum ap_var_type *ptype, ParamToken *token
 AP_Param* AP_Param::find_by_name(const char* name, enum ap_var_type *ptype, ParamToken *token)
 {
     AP_Param *ap;
+#if AP_PARAM_NAME_INDEX_ENABLED
+    bool hidden;
+    ap = find_by_name_index(name, true, ptype, *token, hidden);
+    if (ap != nullptr && *ptype <= AP_PARAM_FLOAT && !hidden) {
+        return ap;
+    }
+    // a vector is named after its first element here, and the index
+    // holds variables next_scalar() skips, so look for those
+#endif
     uint16_t count = 0;
     for (ap = AP_Param::first(token, ptype);
          ap && *ptype != AP_PARAM_GROUP && *ptype != AP_PARAM_NONE;
@@ -930,6 +1139,359 @@ AP_Param* AP_Param::find_by_name(const char* name, enum ap_var_type *ptype, Para
     return ap;
 }
 
+/*
+  find a variable in a group by the group element and index of its
+  token. If name is not nullptr the names of the groups walked through
+  are appended to it, giving the name of the variable
+*/
+AP_Param *AP_Param::find_by_token_group(const ParamToken &token,
+                                        const struct GroupInfo *group_info,
+                                        uint32_t group_base,
+                                        uint8_t group_shift,
+                                        ptrdiff_t group_offset,
+                                        enum ap_var_type *ptype,
+                                        char *name, size_t name_size)
+{
+    const size_t name_len = name != nullptr ? strnlen(name, name_size) : 0;
+    enum ap_var_type type;
+    for (uint8_t i=0;
+         (type=(enum ap_var_type)group_info[i].type) != AP_PARAM_NONE;
+         i++) {
+        if (type == AP_PARAM_GROUP) {
+            const struct GroupInfo *ginfo = get_group_info(group_info[i]);
+            if (ginfo == nullptr) {
+                continue;
+            }
+            ptrdiff_t new_offset = group_offset;
+            if (!adjust_group_offset(token.key, group_info[i], new_offset)) {
+                continue;
+            }
+            if (name != nullptr && name_len < name_size) {
+                strncpy(&name[name_len], group_info[i].name, name_size-name_len);
+            }
+            AP_Param *ap = find_by_token_group(token, ginfo, group_id(group_info, group_base, i, group_shift),
+                                               group_shift + _group_level_shift, new_offset, ptype,
+                                               name, name_size);
+            if (ap != nullptr) {
+                return ap;
+            }
+            if (name != nullptr && name_len < name_size) {
+                name[name_len] = 0;
+            }
+        } else if (group_id(group_info, group_base, i, group_shift) == token.group_element) {
+            ptrdiff_t base;
+            if (!get_base(_var_info[token.key], base)) {
+                return nullptr;
+            }
+            ptrdiff_t ofs = base + group_info[i].offset + group_offset;
+            if (token.idx != 0) {
+                if (type != AP_PARAM_VECTOR3F || token.idx > 3) {
+                    return nullptr;
+                }
+                // an element of the vector as a float
+                ofs += sizeof(float)*(token.idx - 1u);
+                type = AP_PARAM_FLOAT;
+            }
+            AP_Param *ap = (AP_Param *)ofs;
+            if (name != nullptr) {
+                if (name_len < name_size) {
+                    strncpy(&name[name_len], group_info[i].name, name_size-name_len);
+                }
+                if (token.idx != 0) {
+                    ap->add_vector3f_suffix(name, name_size, token.idx - 1);
+                }
+            }
+            *ptype = type;
+            return ap;
+        }
+    }
+    return nullptr;
+}
+
+/*
+  find a variable by token, the reverse of next()
+*/
+AP_Param *AP_Param::find_by_token(const ParamToken &token, enum ap_var_type *ptype,
+                                  char *name, size_t name_size)
+{
+    if (token.key >= _num_vars) {
+        return nullptr;
+    }
+    const struct Info &info = _var_info[token.key];
+    enum ap_var_type type = (enum ap_var_type)info.type;
+    if (name != nullptr) {
+        strncpy(name, info.name, name_size);
+    }
+    if (type == AP_PARAM_GROUP) {
+        const struct GroupInfo *group_info = get_group_info(info);
+        if (group_info == nullptr) {
+            return nullptr;
+        }
+        return find_by_token_group(token, group_info, 0, 0, 0, ptype, name, name_size);
+    }
+    ptrdiff_t base;
+    if (token.group_element != 0 || !get_base(info, base)) {
+        return nullptr;
+    }
+    if (token.idx != 0) {
+        if (type != AP_PARAM_VECTOR3F || token.idx > 3) {
+            return nullptr;
+        }
+        base += sizeof(float)*(token.idx - 1u);
+        type = AP_PARAM_FLOAT;
+    }
+    AP_Param *ap = (AP_Param *)base;
+    if (name != nullptr && token.idx != 0) {
+        ap->add_vector3f_suffix(name, name_size, token.idx - 1);
+    }
+    *ptype = type;
+    return ap;
+}
+
+#if AP_PARAM_NAME_INDEX_ENABLED
+// an all ones token marks an empty slot in the name index
+static bool name_index_empty(const AP_Param::ParamToken &token)
+{
+    return token.key == 0x1FF && token.idx == 0x1F;
+}
+
+/*
+  FNV-1a hash of a parameter name, folding case so that
+  find_by_name() can use the index
+*/
+uint16_t AP_Param::name_hash(const char *name)
+{
+    uint32_t h = 2166136261U;
+    for (uint8_t i=0; i<AP_MAX_NAME_SIZE && name[i] != 0; i++) {
+        h = (h ^ (uint8_t)toupper(name[i])) * 16777619U;
+    }
+    return h ^ (h >> 16);
+}
+
+/*
+  return true if the INT8 at token is an enable parameter, setting
+  nested if it is below the top level of its group
+*/
+bool AP_Param::is_enable_param(AP_Param *ap, const ParamToken &token, bool &nested)
+{
+    uint32_t group_element;
+    const struct GroupInfo *ginfo;
+    struct GroupNesting group_nesting {};
+    uint8_t idx;
+    const struct AP_Param::Info *info = ap->find_var_info_token(token, &group_element,
+                                                                ginfo, group_nesting, &idx);
+    if (info == nullptr || ginfo == nullptr || !(ginfo->flags & AP_PARAM_FLAG_ENABLE)) {
+        return false;
+    }
+    nested = group_nesting.level != 0;
+    return true;
+}
+
+/*
+  (re)build the name index from every parameter next() can see,
+  keeping the first of any duplicate names as find() does. Must be
+  called with _name_index_sem held
+*/
+bool AP_Param::index_names(void)
+{
+    if (_num_vars == 0) {
+        return false;
+    }
+    const uint16_t marker = _count_marker;
+    ParamToken token;
+    enum ap_var_type type;
+    AP_Param *ap;
+    uint32_t count = 0;
+    uint16_t num_enables = 0;
+    for (ap = first(&token, &type); ap != nullptr; ap = next(&token, &type)) {
+        count++;
+        bool nested;
+        if (type == AP_PARAM_INT8 && is_enable_param(ap, token, nested)) {
+            num_enables++;
+        }
+    }
+
+    // keep the table no more than 3/4 full so probes stay short
+    uint32_t size = 16;
+    while (size*3 < count*4) {
+        size *= 2;
+    }
+    if (size > UINT16_MAX) {
+        return false;
+    }
+    bool allocated = false;
+    if (size > _name_index_size) {
+        ParamToken *index = new ParamToken[size];
+        uint16_t *enable = new uint16_t[size];
+        if (index == nullptr || enable == nullptr) {
+            delete[] index;
+            delete[] enable;
+            return false;
+        }
+        delete[] _name_index;
+        delete[] _name_index_enable;
+        _name_index = index;
+        _name_index_enable = enable;
+        _name_index_size = size;
+        allocated = true;
+    }
+    if (num_enables > _name_index_enables_size) {
+        NameIndexEnable *enables = new NameIndexEnable[num_enables];
+        if (enables == nullptr) {
+            delete[] _name_index;
+            _name_index = nullptr;
+            _name_index_size = 0;
+            return false;
+        }
+        delete[] _name_index_enables;
+        _name_index_enables = enables;
+        _name_index_enables_size = num_enables;
+        allocated = true;
+    }
+    memset(_name_index, 0xFF, _name_index_size*sizeof(_name_index[0]));
+
+    /*
+      next_scalar() skips what follows a disabled enable parameter in
+      its key, or in its top level subgroup if it is nested. Those
+      ranges nest, so a stack of the enable parameters whose range the
+      walk is in gives the innermost one for each variable
+    */
+    struct {
+        uint16_t enable;
+        uint16_t key;
+        uint8_t subgroup;
+        bool nested;
+    } stack[8];
+    uint8_t depth = 0;
+    uint16_t enables = 0;
+
+    const uint16_t mask = _name_index_size - 1;
+    for (ap = first(&token, &type); ap != nullptr; ap = next(&token, &type)) {
+        while (depth > 0 &&
+               (stack[depth-1].key != token.key ||
+                (stack[depth-1].nested && stack[depth-1].subgroup != (token.group_element & 0x3F)))) {
+            depth--;
+        }
+        const uint16_t enable = depth > 0 ? stack[depth-1].enable : _name_index_no_enable;
+        bool nested;
+        if (type == AP_PARAM_INT8 && enables < num_enables && is_enable_param(ap, token, nested)) {
+            _name_index_enables[enables].param = ap;
+            _name_index_enables[enables].parent = enable;
+            if (depth < ARRAY_SIZE(stack)) {
+                stack[depth].enable = enables;
+                stack[depth].key = token.key;
+                stack[depth].subgroup = token.group_element & 0x3F;
+                stack[depth].nested = nested;
+                depth++;
+            }
+            enables++;
+        }
+
+        char name[AP_MAX_NAME_SIZE+1];
+        ap->copy_name_token(token, name, sizeof(name), token.idx != 0);
+        name[AP_MAX_NAME_SIZE] = 0;
+        uint16_t slot = name_hash(name) & mask;
+        bool duplicate = false;
+        while (!name_index_empty(_name_index[slot])) {
+            const ParamToken &t = _name_index[slot];
+            enum ap_var_type type2;
+            AP_Param *ap2 = find_by_token(t, &type2);
+            if (ap2 != nullptr) {
+                char name2[AP_MAX_NAME_SIZE+1];
+                ap2->copy_name_token(t, name2, sizeof(name2), t.idx != 0);
+                name2[AP_MAX_NAME_SIZE] = 0;
+                if (strcmp(name, name2) == 0) {
+                    duplicate = true;
+                    break;
+                }
+            }
+            slot = (slot+1) & mask;
+        }
+        if (!duplicate) {
+            _name_index[slot] = token;
+            _name_index_enable[slot] = enable;
+        }
+    }
+    _name_index_marker = marker;
+
+#ifndef HAL_NO_GCS
+    if (allocated) {
+        gcs().send_text(MAV_SEVERITY_DEBUG, "Param: %u names indexed in %u bytes",
+                        (unsigned)count,
+                        (unsigned)(_name_index_size*(sizeof(_name_index[0])+sizeof(_name_index_enable[0])) +
+                                   _name_index_enables_size*sizeof(_name_index_enables[0])));
+    }
+#endif
+    return true;
+}
+
+/*
+  find a variable using the name index, rebuilding it first if
+  parameters may have been added since it was built. Every hit is
+  checked against the name of the variable it resolves to, so a
+  nullptr return means the caller needs to search the var_info
+  tables itself
+*/
+AP_Param *AP_Param::find_by_name_index(const char *name, bool ignore_case,
+                                       enum ap_var_type *ptype, ParamToken &token,
+                                       bool &hidden)
+{
+    WITH_SEMAPHORE(_name_index_sem);
+    if (_name_index == nullptr || _name_index_marker != _count_marker) {
+        index_names();
+    }
+    if (_name_index == nullptr) {
+        return nullptr;
+    }
+    const uint16_t mask = _name_index_size - 1;
+    uint16_t slot = name_hash(name) & mask;
+    for (uint16_t n=0; n<_name_index_size; n++, slot = (slot+1) & mask) {
+        const ParamToken &t = _name_index[slot];
+        if (name_index_empty(t)) {
+            break;
+        }
+        enum ap_var_type type;
+        AP_Param *ap = find_by_token(t, &type);
+        if (ap == nullptr) {
+            continue;
+        }
+        char buf[AP_MAX_NAME_SIZE+1];
+        ap->copy_name_token(t, buf, sizeof(buf), t.idx != 0);
+        buf[AP_MAX_NAME_SIZE] = 0;
+        if (ignore_case ? strncasecmp(name, buf, AP_MAX_NAME_SIZE) == 0 : strcmp(name, buf) == 0) {
+            token = t;
+            *ptype = type;
+            hidden = hidden_by_disabled_group(t, _name_index_enable[slot]);
+            return ap;
+        }
+    }
+    return nullptr;
+}
+
+/*
+  return true if next_scalar() skips the variable at token, given the
+  innermost enable parameter it is below. Must be called with
+  _name_index_sem held
+*/
+bool AP_Param::hidden_by_disabled_group(const ParamToken &token, uint16_t enable)
+{
+    if (!_hide_disabled_groups) {
+        return false;
+    }
+    if (token.key >= _num_vars || !check_frame_type(_var_info[token.key].flags)) {
+        return true;
+    }
+    while (enable != _name_index_no_enable) {
+        const NameIndexEnable &e = _name_index_enables[enable];
+        if (((const AP_Int8 *)e.param)->get() == 0) {
+            return true;
+        }
+        enable = e.parent;
+    }
+    return false;
+}
+#endif // AP_PARAM_NAME_INDEX_ENABLED
+
 /*
   Find a variable by pointer, returning key. This is used for loading pointer variables
 */
@@ -1148,6 +1710,9 @@ void AP_Param::save_sync(bool force_save)
     write_sentinal(ofs + sizeof(phdr) + type_size((enum ap_var_type)phdr.type));
     eeprom_write_check(ap, ofs+sizeof(phdr), type_size((enum ap_var_type)phdr.type));
     eeprom_write_check(&phdr, ofs, sizeof(phdr));
+#if AP_PARAM_STORAGE_INDEX_ENABLED
+    index_add(phdr, ofs);
+#endif
 
     send_parameter(name, (enum ap_var_type)phdr.type, idx);
 }
@@ -1183,10 +1748,30 @@ void AP_Param::save_io_handler(void)
 {
     struct param_save p;
     while (save_queue.pop(p)) {
-        p.param->save_sync(p.force_save);
+        if (!save_queued_again(p)) {
+            p.param->save_sync(p.force_save);
+        }
     }
 }
 
+/*
+  return true if a parameter is queued to be saved again, at least as
+  forcefully. Saving it now would only be overwritten, so bursts of
+  sets of one parameter cost one save
+*/
+bool AP_Param::save_queued_again(const struct param_save &p)
+{
+    struct param_save queued[save_queue_size];
+    const uint32_t n = save_queue.peek(queued, ARRAY_SIZE(queued));
+    for (uint32_t i=0; i<n; i++) {
+        if (queued[i].param == p.param &&
+            (queued[i].force_save || !p.force_save)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 /*
   wait for all parameters to save
 */
@@ -1439,6 +2024,25 @@ bool AP_Param::load_all()
         if (is_sentinal(phdr)) {
             // we've reached the sentinal
             sentinal_offset = ofs;
+
+            // index the storage for the lookups that follow at boot
+            if (_perf_index == nullptr) {
+                _perf_index = hal.util->perf_alloc(AP_HAL::Util::PC_ELAPSED, "param_index");
+            }
+            hal.util->perf_begin(_perf_index);
+#if AP_PARAM_STORAGE_INDEX_ENABLED
+            {
+                WITH_SEMAPHORE(_storage_index_sem);
+                _storage_index_failed = !index_storage(0);
+            }
+#endif
+#if AP_PARAM_NAME_INDEX_ENABLED
+            {
+                WITH_SEMAPHORE(_name_index_sem);
+                index_names();
+            }
+#endif
+            hal.util->perf_end(_perf_index);
             return true;
         }
 
@@ -1692,6 +2296,49 @@ AP_Param *AP_Param::next(ParamToken *token, enum ap_var_type *ptype)
     return nullptr;
 }
 
+/*
+  if the INT8 at token is a disabled enable parameter, move token on
+  to the last variable below it so the following next() call carries
+  on after the disabled parameter tree
+*/
+void AP_Param::skip_disabled_group(AP_Param *ap, ParamToken *token)
+{
+    /* 
+       check if this is an enable variable. To do that we need to
+       find the info structures for the variable
+     */
+    uint32_t group_element;
+    const struct GroupInfo *ginfo;
+    struct GroupNesting group_nesting {};
+    uint8_t idx;
+    const struct AP_Param::Info *info = ap->find_var_info_token(*token, &group_element,
+                                                                ginfo, group_nesting, &idx);
+    if (info && ginfo &&
+        (ginfo->flags & AP_PARAM_FLAG_ENABLE) &&
+        ((AP_Int8 *)ap)->get() == 0 &&
+        _hide_disabled_groups) {
+        /*
+          this is a disabled parameter tree, include this
+          parameter but not others below it. We need to keep
+          looking until we go past the parameters in this object
+        */
+        ParamToken token2 = *token;
+        enum ap_var_type type2;
+        AP_Param *ap2;
+        while ((ap2 = next(&token2, &type2)) != nullptr) {
+            if (token2.key != token->key) {
+                break;
+            }
+            if (group_nesting.level != 0 && (token->group_element & 0x3F) != (token2.group_element & 0x3F)) {
+                break;
+            }
+            // update the returned token so the next() call goes from this point
+            *token = token2;
+        }
+        
+    }
+}
+
 /// Returns the next scalar in _var_info, recursing into groups
 /// as needed
 AP_Param *AP_Param::next_scalar(ParamToken *token, enum ap_var_type *ptype)
@@ -1701,40 +2348,7 @@ AP_Param *AP_Param::next_scalar(ParamToken *token, enum ap_var_type *ptype)
     while ((ap = next(token, &type)) != nullptr && type > AP_PARAM_FLOAT) ;
 
     if (ap != nullptr && type == AP_PARAM_INT8) {
-        /* 
-           check if this is an enable variable. To do that we need to
-           find the info structures for the variable
-         */
-        uint32_t group_element;
-        const struct GroupInfo *ginfo;
-        struct GroupNesting group_nesting {};
-        uint8_t idx;
-        const struct AP_Param::Info *info = ap->find_var_info_token(*token, &group_element,
-                                                                    ginfo, group_nesting, &idx);
-        if (info && ginfo &&
-            (ginfo->flags & AP_PARAM_FLAG_ENABLE) &&
-            ((AP_Int8 *)ap)->get() == 0 &&
-            _hide_disabled_groups) {
-            /*
-              this is a disabled parameter tree, include this
-              parameter but not others below it. We need to keep
-              looking until we go past the parameters in this object
-            */
-            ParamToken token2 = *token;
-            enum ap_var_type type2;
-            AP_Param *ap2;
-            while ((ap2 = next(&token2, &type2)) != nullptr) {
-                if (token2.key != token->key) {
-                    break;
-                }
-                if (group_nesting.level != 0 && (token->group_element & 0x3F) != (token2.group_element & 0x3F)) {
-                    break;
-                }
-                // update the returned token so the next() call goes from this point
-                *token = token2;
-            }
-            
-        }
+        skip_disabled_group(ap, token);
     }
 
     if (ap != nullptr && ptype != nullptr) {
@@ -2358,6 +2972,7 @@ uint16_t AP_Param::count_parameters(void)
       counting
      */
     uint8_t limit = 4;
+    bool grown = false;
     while ((_parameter_count == 0 ||
             _count_marker != _count_marker_done) &&
            limit--) {
@@ -2369,14 +2984,48 @@ uint16_t AP_Param::count_parameters(void)
         for (vp = AP_Param::first(&token, nullptr);
              vp != nullptr;
              vp = AP_Param::next_scalar(&token, nullptr)) {
+#if AP_PARAM_TOKEN_TABLE_ENABLED
+            if (count < _token_table_size) {
+                _token_table[count] = token;
+            }
+#endif
             count++;
         }
+#if AP_PARAM_TOKEN_TABLE_ENABLED
+        if (count > _token_table_size && !grown) {
+            // grow the table, leaving room for parameters that appear
+            // when groups are enabled, and fill it on the next pass. The
+            // extra pass doesn't count against the retries for changes
+            // from other threads
+            grown = true;
+            ParamToken *table = new ParamToken[count+16];
+            if (table != nullptr) {
+                delete[] _token_table;
+                _token_table = table;
+                _token_table_size = count+16;
+                limit++;
+                continue;
+            }
+        }
+#endif
         _parameter_count = count;
         _count_marker_done = marker;
     }
     return _parameter_count;
 }
 
+#if AP_PARAM_TOKEN_TABLE_ENABLED
+/*
+  return true if the token table holds every parameter, so
+  find_by_index() doesn't need to walk the parameter tree
+ */
+bool AP_Param::token_table_valid(void)
+{
+    WITH_SEMAPHORE(_count_sem);
+    return count_parameters() <= _token_table_size;
+}
+#endif
+
 /*
   invalidate parameter count cache
  */
@@ -46,6 +46,35 @@
 #endif
 #endif
 
+/*
+  keep a hash index of the storage offsets of the saved parameters so
+  that loading and saving a parameter doesn't need to walk the storage.
+  It costs 2 bytes of RAM per slot, with a quarter of the slots left
+  empty
+ */
+#ifndef AP_PARAM_STORAGE_INDEX_ENABLED
+#define AP_PARAM_STORAGE_INDEX_ENABLED 1
+#endif
+
+/*
+  keep a hash index of parameter names so find() and find_by_name()
+  don't need to walk every var_info table. It costs 6 bytes of RAM
+  per slot, with a third of the slots left empty, and 8 bytes per
+  enable parameter
+ */
+#ifndef AP_PARAM_NAME_INDEX_ENABLED
+#define AP_PARAM_NAME_INDEX_ENABLED (BOARD_FLASH_SIZE > 1024)
+#endif
+
+/*
+  keep the tokens of the scalar parameters in index order so that
+  find_by_index() doesn't need to walk the parameter tree. It costs 4
+  bytes of RAM per parameter
+ */
+#ifndef AP_PARAM_TOKEN_TABLE_ENABLED
+#define AP_PARAM_TOKEN_TABLE_ENABLED (BOARD_FLASH_SIZE > 1024)
+#endif
+
 /*
   flags for variables in var_info and group tables
  */
@@ -305,14 +334,18 @@ public:
     // name helper for scripting
     static bool set_and_save(const char *name, float value) { return set_and_save_by_name(name, value); };
 
-    /// Find a variable by index.
+    /// Find a variable by index, in the order of next_scalar().
     ///
     ///
     /// @param  idx             The index of the variable
+    /// @param  name            If not nullptr, filled in with the name of
+    ///                         the variable as copy_name_token() would
+    ///                         with force_scalar set
     /// @return                 A pointer to the variable, or nullptr if
     ///                         it does not exist.
     ///
-    static AP_Param * find_by_index(uint16_t idx, enum ap_var_type *ptype, ParamToken *token);
+    static AP_Param * find_by_index(uint16_t idx, enum ap_var_type *ptype, ParamToken *token,
+                                    char *name = nullptr, size_t name_size = 0);
 
     // by-name equivalent of find_by_index()
     static AP_Param* find_by_name(const char* name, enum ap_var_type *ptype, ParamToken *token);
@@ -484,6 +517,11 @@ public:
     // count of parameters in tree
     static uint16_t count_parameters(void);
 
+#if AP_PARAM_TOKEN_TABLE_ENABLED
+    // true if find_by_index() can use the token table
+    static bool token_table_valid(void);
+#endif
+
     // invalidate parameter count
     static void invalidate_count(void);
 
@@ -640,6 +678,31 @@ private:
     static bool                 scan(
                                     const struct Param_header *phdr,
                                     uint16_t *pofs);
+#if AP_PARAM_STORAGE_INDEX_ENABLED
+    static bool                 index_storage(uint16_t min_entries);
+    static bool                 index_find(const Param_header &phdr, uint16_t &ofs, uint16_t &slot);
+    static void                 index_add(const Param_header &phdr, uint16_t ofs);
+#endif
+    static AP_Param *           find_by_token(const ParamToken &token, enum ap_var_type *ptype,
+                                    char *name = nullptr, size_t name_size = 0);
+    static AP_Param *           find_by_token_group(
+                                    const ParamToken &token,
+                                    const struct GroupInfo *group_info,
+                                    uint32_t group_base,
+                                    uint8_t group_shift,
+                                    ptrdiff_t group_offset,
+                                    enum ap_var_type *ptype,
+                                    char *name, size_t name_size);
+#if AP_PARAM_NAME_INDEX_ENABLED
+    static uint16_t             name_hash(const char *name);
+    static bool                 is_enable_param(AP_Param *ap, const ParamToken &token, bool &nested);
+    static bool                 index_names(void);
+    static AP_Param *           find_by_name_index(const char *name, bool ignore_case,
+                                    enum ap_var_type *ptype, ParamToken &token,
+                                    bool &hidden);
+    static bool                 hidden_by_disabled_group(const ParamToken &token, uint16_t enable);
+#endif
+    static void                 skip_disabled_group(AP_Param *ap, ParamToken *token);
     static void                 eeprom_write_check(
                                     const void *ptr,
                                     uint16_t ofs,
@@ -683,8 +746,63 @@ private:
     static uint16_t             _count_marker;
     static uint16_t             _count_marker_done;
     static HAL_Semaphore        _count_sem;
+#if AP_PARAM_TOKEN_TABLE_ENABLED
+    // tokens of the scalar parameters in index order, filled in by
+    // count_parameters() and holding _parameter_count entries while
+    // that fits in _token_table_size
+    static ParamToken *         _token_table;
+    static uint16_t             _token_table_size;
+#endif
     static const struct Info *  _var_info;
 
+#if AP_PARAM_STORAGE_INDEX_ENABLED
+    /*
+      open addressed hash table of the storage offsets of the
+      parameters in _storage, keyed on their Param_header, so that
+      scan() doesn't need to walk the storage from the start. Zero
+      marks an empty slot, as no parameter is stored at offset 0
+    */
+    static uint16_t *           _storage_index;
+    static uint16_t             _storage_index_size;
+    static uint16_t             _storage_index_count;
+    // set when building the index failed, so scan() doesn't keep
+    // trying. Cleared when load_all() builds it again
+    static bool                 _storage_index_failed;
+    static HAL_Semaphore        _storage_index_sem;
+#endif
+
+    // time taken to build the indexes in load_all()
+    static AP_HAL::Util::perf_counter_t _perf_index;
+
+#if AP_PARAM_NAME_INDEX_ENABLED
+    /*
+      open addressed hash table of the tokens of all parameters,
+      keyed on their names with case folded. It is rebuilt whenever
+      the parameter count is invalidated, as that is when new
+      parameters may appear
+    */
+    static ParamToken *         _name_index;
+    static uint16_t             _name_index_size;
+    static uint16_t             _name_index_marker;
+    static HAL_Semaphore        _name_index_sem;
+
+    /*
+      the enable parameters next_scalar() looks at, found while
+      building the name index. Each slot of the index records the
+      innermost enable parameter its variable is below, and each
+      enable parameter the one it is below, so find_by_name() can tell
+      if a hit is hidden without walking the parameter tree
+    */
+    struct NameIndexEnable {
+        const AP_Param *param; // an AP_Int8
+        uint16_t parent;
+    };
+    static const uint16_t       _name_index_no_enable = 0xFFFF;
+    static uint16_t *           _name_index_enable;
+    static NameIndexEnable *    _name_index_enables;
+    static uint16_t             _name_index_enables_size;
+#endif
+
     /*
       list of overridden values from load_defaults_file()
     */
@@ -710,11 +828,13 @@ private:
         AP_Param *param;
         bool force_save;
     };
+    static const uint8_t save_queue_size = 30;
     static ObjectBuffer_TS<struct param_save> save_queue;
     static bool registered_save_handler;
 
     // background function for saving parameters
     void save_io_handler(void);
+    static bool save_queued_again(const struct param_save &p);
 };
 
 namespace AP {
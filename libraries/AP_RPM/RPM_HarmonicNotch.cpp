@@ -31,9 +31,10 @@ AP_RPM_HarmonicNotch::AP_RPM_HarmonicNotch(AP_RPM &_ap_rpm, uint8_t _instance, A
 
 void AP_RPM_HarmonicNotch::update(void)
 {
-    AP_InertialSensor& ins = AP::ins();
-    if (ins.get_gyro_harmonic_notch_tracking_mode() != HarmonicNotchDynamicMode::Fixed) {
-        state.rate_rpm = ins.get_gyro_dynamic_notch_center_freq_hz() * 60.0f;
+    // report the first harmonic notch
+    const AP_InertialSensor::HarmonicNotch &notch = AP::ins().harmonic_notches[0];
+    if (notch.params().tracking_mode() != HarmonicNotchDynamicMode::Fixed) {
+        state.rate_rpm = notch.calculated_freq_hz() * 60.0f;
         state.rate_rpm *= ap_rpm._scaling[state.instance];
         state.signal_quality = 0.5f;
         state.last_reading_ms = AP_HAL::millis();
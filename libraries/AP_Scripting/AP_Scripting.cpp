@@ -101,6 +101,39 @@ const AP_Param::GroupInfo AP_Scripting::var_info[] = {
     // @User: Standard
     AP_GROUPINFO("USER4", 8, AP_Scripting, _user[3], 0.0),
 
+    // @Param: ISO_HEAP
+    // @DisplayName: Scripting Isolated Heap Size
+    // @Description: If non-zero each script is run in its own Lua state with a private heap of this size, so a misbehaving script can't exhaust the memory available to the other scripts. If zero all scripts share a single state using the HEAP_SIZE heap.
+    // @Range: 0 1048576
+    // @Increment: 1024
+    // @Units: B
+    // @User: Advanced
+    // @RebootRequired: True
+    AP_GROUPINFO("ISO_HEAP", 9, AP_Scripting, _script_iso_heap_size, 0),
+
+    // @Param: RUN_BUDGET
+    // @DisplayName: Scripting Run Time Budget
+    // @Description: The maximum time a script may run for each time it is scheduled before it is considered to have taken an excessive amount of time and is stopped. 0 disables the check, leaving only the VM_I_COUNT limit. A script can set its own budget with a RUN_BUDGET_US global.
+    // @Range: 0 1000000
+    // @Units: us
+    // @User: Advanced
+    AP_GROUPINFO("RUN_BUDGET", 10, AP_Scripting, _script_run_budget_us, 0),
+
+    // @Param: DEBUG_OPTS
+    // @DisplayName: Scripting Debug Options
+    // @Description: Debugging options for scripting
+    // @Bitmask: 0:Log runtime
+    // @User: Advanced
+    AP_GROUPINFO("DEBUG_OPTS", 11, AP_Scripting, _debug_options, 0),
+
+    // @Param: CACHE
+    // @DisplayName: Scripting Bytecode Cache
+    // @Description: When enabled scripts are compiled once and the bytecode is cached in the scripts cache directory. Later loads of an unchanged script use the cached bytecode instead of compiling the source, which reduces the time and memory taken to start scripts. Lua bytecode is not checked for safety when it is loaded, so only enable this when nothing untrusted can write to the scripts cache directory, for example over MAVLink FTP.
+    // @Values: 0:Disabled,1:Enabled
+    // @User: Advanced
+    // @RebootRequired: True
+    AP_GROUPINFO("CACHE", 12, AP_Scripting, _bytecode_cache, 0),
+
     AP_GROUPEND
 };
 
@@ -128,6 +161,12 @@ void AP_Scripting::init(void) {
         }
     }
 
+    if (_bytecode_cache && AP::FS().mkdir(SCRIPTING_CACHE_DIRECTORY)) {
+        if (errno != EEXIST) {
+            gcs().send_text(MAV_SEVERITY_INFO, "Lua: failed to create (%s)", SCRIPTING_CACHE_DIRECTORY);
+        }
+    }
+
     if (!hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&AP_Scripting::thread, void),
                                       "Scripting", SCRIPTING_STACK_SIZE, AP_HAL::Scheduler::PRIORITY_SCRIPTING, 0)) {
         gcs().send_text(MAV_SEVERITY_CRITICAL, "Could not create scripting stack (%d)", SCRIPTING_STACK_SIZE);
@@ -186,19 +225,37 @@ void AP_Scripting::repl_stop(void) {
 }
 
 void AP_Scripting::thread(void) {
-    lua_scripts *lua = new lua_scripts(_script_vm_exec_count, _script_heap_size, _debug_level, terminal);
+    lua_scripts *lua = new lua_scripts(_script_vm_exec_count, _script_heap_size, _debug_level,
+                                       _script_iso_heap_size, _script_run_budget_us, _debug_options,
+                                       _bytecode_cache, terminal);
     if (lua == nullptr || !lua->heap_allocated()) {
         gcs().send_text(MAV_SEVERITY_CRITICAL, "Unable to allocate scripting memory");
         delete lua;
         _init_failed = true;
         return;
     }
+    {
+        WITH_SEMAPHORE(_lua_sem);
+        _lua = lua;
+    }
     lua->run();
+    {
+        WITH_SEMAPHORE(_lua_sem);
+        _lua = nullptr;
+    }
 
     // only reachable if the lua backend has died for any reason
     gcs().send_text(MAV_SEVERITY_CRITICAL, "Scripting has stopped");
 }
 
+size_t AP_Scripting::script_stats(char *buf, size_t bufsize) {
+    WITH_SEMAPHORE(_lua_sem);
+    if (_lua == nullptr) {
+        return 0;
+    }
+    return _lua->script_stats(buf, bufsize);
+}
+
 AP_Scripting *AP_Scripting::_singleton = nullptr;
 
 namespace AP {
@@ -21,6 +21,8 @@
 #include <GCS_MAVLink/GCS.h>
 #include <AP_Filesystem/AP_Filesystem.h>
 
+class lua_scripts;
+
 class AP_Scripting
 {
 public:
@@ -41,6 +43,9 @@ public:
 
     MAV_RESULT handle_command_int_packet(const mavlink_command_int_t &packet);
 
+    // fill buf with the per script statistics, for @SYS/scripts.txt
+    size_t script_stats(char *buf, size_t bufsize);
+
    // User parameters for inputs into scripts 
    AP_Float _user[4]; 
 
@@ -63,6 +68,13 @@ private:
     AP_Int32 _script_vm_exec_count;
     AP_Int32 _script_heap_size;
     AP_Int8 _debug_level;
+    AP_Int32 _script_iso_heap_size;
+    AP_Int32 _script_run_budget_us;
+    AP_Int8 _debug_options;
+    AP_Int8 _bytecode_cache;
+
+    lua_scripts *_lua; // running scripts, only valid while the scripting thread is running them
+    HAL_Semaphore _lua_sem; // protects _lua, which is read from the filesystem thread
 
     bool _init_failed;  // true if memory allocation failed
 
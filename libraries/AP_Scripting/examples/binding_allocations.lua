@@ -0,0 +1,44 @@
+-- This script benchmarks the math bindings, comparing calls that allocate a new userdata for
+-- each result with calls that write the result into an existing object passed as the last argument.
+-- Each run alternates between the two styles and reports the time, allocations and bytes
+-- allocated per call. The allocations are counted by the scripting allocator, so they are not
+-- affected by when the garbage collector runs
+
+local calls = 200 -- number of calls of each binding per run
+
+local gyro = Vector3f()
+local accel = Vector3f()
+local cross = Vector3f()
+local position = Location()
+local reuse = false
+
+function update()
+  local start = micros()
+  local start_allocs, start_bytes = allocations()
+  if reuse then
+    for i = 1, calls do
+      ahrs:get_gyro(gyro)
+      ahrs:get_accel(accel)
+      gyro:cross(accel, cross)
+      ahrs:get_position(position)
+    end
+  else
+    for i = 1, calls do
+      local new_gyro = ahrs:get_gyro()
+      local new_accel = ahrs:get_accel()
+      local new_cross = new_gyro:cross(new_accel)
+      local new_position = ahrs:get_position()
+    end
+  end
+  local end_allocs, end_bytes = allocations()
+  local elapsed = (micros() - start):tofloat()
+
+  local n = calls * 4
+  gcs:send_text(6, string.format("%s: %.2f us %.2f allocs %.1f bytes per call", reuse and "reuse" or "allocate",
+                                 elapsed / n, (end_allocs - start_allocs) / n, (end_bytes - start_bytes) / n))
+
+  reuse = not reuse
+  return update, 1000
+end
+
+return update, 1000
@@ -1329,13 +1329,36 @@ void emit_userdata_method(const struct userdata *data, const struct method *meth
 
   // sanity check number of args called with
   arg_count = 1;
+  int nullable_count = 0;
+  int nullable_userdata_count = 0; // number of nullable results up to and including the last userdata
   while (arg != NULL) {
     if (!(arg->type.flags & TYPE_FLAGS_NULLABLE) && !(arg->type.type == TYPE_LITERAL)) {
       arg_count++;
     }
+    if (arg->type.flags & TYPE_FLAGS_NULLABLE) {
+      nullable_count++;
+      if (arg->type.type == TYPE_USERDATA) {
+        nullable_userdata_count = nullable_count;
+      }
+    }
     arg = arg->next;
   }
-  fprintf(source, "    binding_argcheck(L, %d);\n", arg_count);
+  const int expected_arg_count = arg_count;
+
+  // userdata results can optionally be written into an existing object passed as a trailing
+  // argument, rather then allocating a new one. For nullable methods each trailing argument
+  // matches the result in the same position, and is ignored for non userdata results.
+  int destination_count = 0;
+  if (method->return_type.type == TYPE_USERDATA) {
+    destination_count = 1;
+  } else if ((method->return_type.type == TYPE_BOOLEAN) && (method->flags & TYPE_FLAGS_NULLABLE)) {
+    destination_count = nullable_userdata_count;
+  }
+  if (destination_count > 0) {
+    fprintf(source, "    binding_argcheck_range(L, %d, %d);\n", arg_count, arg_count + destination_count);
+  } else {
+    fprintf(source, "    binding_argcheck(L, %d);\n", arg_count);
+  }
 
   switch (data->ud_type) {
     case UD_USERDATA:
@@ -1371,6 +1394,29 @@ void emit_userdata_method(const struct userdata *data, const struct method *meth
     arg = arg->next;
   }
 
+  // fetch any destinations before taking semaphores, as a type error will not return here
+  if (method->return_type.type == TYPE_USERDATA) {
+    fprintf(source, "    %s * dest = lua_isnoneornil(L, %d) ? nullptr : check_%s(L, %d);\n",
+            method->return_type.data.ud.name, expected_arg_count + 1,
+            method->return_type.data.ud.sanatized_name, expected_arg_count + 1);
+  } else if (destination_count > 0) {
+    arg = method->arguments;
+    int arg_index = NULLABLE_ARG_COUNT_BASE + 2;
+    int destination_index = expected_arg_count + 1;
+    while (arg != NULL) {
+      if (arg->type.flags & TYPE_FLAGS_NULLABLE) {
+        if (arg->type.type == TYPE_USERDATA) {
+          fprintf(source, "    %s * dest_%d = lua_isnoneornil(L, %d) ? nullptr : check_%s(L, %d);\n",
+                  arg->type.data.ud.name, arg_index, destination_index,
+                  arg->type.data.ud.sanatized_name, destination_index);
+        }
+        destination_index++;
+      }
+      arg_index++;
+      arg = arg->next;
+    }
+  }
+
   if (data->flags & UD_FLAG_SEMAPHORE) {
     fprintf(source, "    ud->get_semaphore().take_blocking();\n");
   }
@@ -1515,6 +1561,7 @@ void emit_userdata_method(const struct userdata *data, const struct method *meth
         return_count = 0;
         arg = method->arguments;
         int arg_index = NULLABLE_ARG_COUNT_BASE + 2;
+        int destination_index = expected_arg_count + 1;
         while (arg != NULL) {
           if (arg->type.flags & TYPE_FLAGS_NULLABLE) {
             return_count++;
@@ -1541,9 +1588,15 @@ void emit_userdata_method(const struct userdata *data, const struct method *meth
                 fprintf(source, "        lua_pushstring(L, data_%d);\n", arg_index);
                 break;
               case TYPE_USERDATA:
-                // userdatas must allocate a new container to return
-                fprintf(source, "        new_%s(L);\n", arg->type.data.ud.sanatized_name);
-                fprintf(source, "        *check_%s(L, -1) = data_%d;\n", arg->type.data.ud.sanatized_name, arg_index);
+                // userdatas are copied into the destination if one was provided, otherwise
+                // a new container must be allocated to return
+                fprintf(source, "        if (dest_%d != nullptr) {\n", arg_index);
+                fprintf(source, "            *dest_%d = data_%d;\n", arg_index, arg_index);
+                fprintf(source, "            lua_pushvalue(L, %d);\n", destination_index);
+                fprintf(source, "        } else {\n");
+                fprintf(source, "            new_%s(L);\n", arg->type.data.ud.sanatized_name);
+                fprintf(source, "            *check_%s(L, -1) = data_%d;\n", arg->type.data.ud.sanatized_name, arg_index);
+                fprintf(source, "        }\n");
                 break;
               case TYPE_NONE:
                 error(ERROR_INTERNAL, "Attempted to emit a nullable argument of type none");
@@ -1555,6 +1608,7 @@ void emit_userdata_method(const struct userdata *data, const struct method *meth
                 error(ERROR_INTERNAL, "Attempted to make a nullable ap_object");
                 break;
             }
+            destination_index++;
           }
 
           arg_index++;
@@ -1587,9 +1641,15 @@ void emit_userdata_method(const struct userdata *data, const struct method *meth
       fprintf(source, "    lua_pushstring(L, data);\n");
       break;
     case TYPE_USERDATA:
-      // userdatas must allocate a new container to return
-      fprintf(source, "    new_%s(L);\n", method->return_type.data.ud.sanatized_name);
-      fprintf(source, "    *check_%s(L, -1) = data;\n", method->return_type.data.ud.sanatized_name);
+      // userdatas are copied into the destination if one was provided, otherwise
+      // a new container must be allocated to return
+      fprintf(source, "    if (dest != nullptr) {\n");
+      fprintf(source, "        *dest = data;\n");
+      fprintf(source, "        lua_pushvalue(L, %d);\n", expected_arg_count + 1);
+      fprintf(source, "    } else {\n");
+      fprintf(source, "        new_%s(L);\n", method->return_type.data.ud.sanatized_name);
+      fprintf(source, "        *check_%s(L, -1) = data;\n", method->return_type.data.ud.sanatized_name);
+      fprintf(source, "    }\n");
       break;
     case TYPE_AP_OBJECT:
       fprintf(source, "    if (data == NULL) {\n");
@@ -1904,6 +1964,16 @@ void emit_argcheck_helper(void) {
   fprintf(source, "    }\n");
   fprintf(source, "    return 0;\n");
   fprintf(source, "}\n\n");
+
+  fprintf(source, "static int binding_argcheck_range(lua_State *L, int min_arg_count, int max_arg_count) {\n");
+  fprintf(source, "    const int args = lua_gettop(L);\n");
+  fprintf(source, "    if (args > max_arg_count) {\n");
+  fprintf(source, "        return luaL_argerror(L, args, \"too many arguments\");\n");
+  fprintf(source, "    } else if (args < min_arg_count) {\n");
+  fprintf(source, "        return luaL_argerror(L, args, \"too few arguments\");\n");
+  fprintf(source, "    }\n");
+  fprintf(source, "    return 0;\n");
+  fprintf(source, "}\n\n");
 }
 
 
@@ -6,6 +6,7 @@
 #include "lua_bindings.h"
 
 #include "lua_boxed_numerics.h"
+#include "lua_scripts.h"
 #include <AP_Scripting/lua_generated_bindings.h>
 
 extern const AP_HAL::HAL& hal;
@@ -45,10 +46,23 @@ static int lua_micros(lua_State *L) {
     return 1;
 }
 
+// allocations, returns the number of allocations and bytes allocated by the current run of the script
+static int lua_allocations(lua_State *L) {
+    check_arguments(L, 0, "allocations");
+
+    uint32_t count, bytes;
+    lua_scripts::run_allocations(count, bytes);
+    lua_pushinteger(L, count);
+    lua_pushinteger(L, bytes);
+
+    return 2;
+}
+
 static const luaL_Reg global_functions[] =
 {
     {"millis", lua_millis},
     {"micros", lua_micros},
+    {"allocations", lua_allocations},
     {NULL, NULL}
 };
 
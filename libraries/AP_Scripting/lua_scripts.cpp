@@ -17,22 +17,43 @@
 #include <AP_HAL/AP_HAL.h>
 #include <GCS_MAVLink/GCS.h>
 #include "AP_Scripting.h"
+#include <AP_Logger/AP_Logger.h>
+#include <AP_Math/crc.h>
 
 #include <AP_Scripting/lua_generated_bindings.h>
 
 extern const AP_HAL::HAL& hal;
 
+static_assert(SCRIPTING_MAX_ISOLATED_STATES <= 32, "Isolated heaps are tracked in a 32 bit mask");
+
 bool lua_scripts::overtime;
 jmp_buf lua_scripts::panic_jmp;
+lua_scripts::script_info *lua_scripts::running_script;
 
-lua_scripts::lua_scripts(const AP_Int32 &vm_steps, const AP_Int32 &heap_size, const AP_Int8 &debug_level, struct AP_Scripting::terminal_s &_terminal)
+lua_scripts::lua_scripts(const AP_Int32 &vm_steps, const AP_Int32 &heap_size, const AP_Int8 &debug_level,
+                         const AP_Int32 &iso_heap_size, const AP_Int32 &run_budget_us, const AP_Int8 &debug_options,
+                         const AP_Int8 &bytecode_cache, struct AP_Scripting::terminal_s &_terminal)
     : _vm_steps(vm_steps),
       _debug_level(debug_level),
+      _iso_heap_size(iso_heap_size),
+      _run_budget_us(run_budget_us),
+      _debug_options(debug_options),
+      _bytecode_cache(bytecode_cache),
      terminal(_terminal) {
     _heap = hal.util->allocate_heap_memory(heap_size);
 }
 
 void lua_scripts::hook(lua_State *L, lua_Debug *ar) {
+    script_info *script = running_script;
+    if (script != nullptr && script->budget_us != 0) {
+        // the hook is called more often than the instruction limit so
+        // the elapsed time can be checked as well
+        script->steps_remaining -= SCRIPTING_BUDGET_CHECK_STEPS;
+        if ((script->steps_remaining > 0) && ((AP_HAL::micros() - script->run_start_us) < script->budget_us)) {
+            return;
+        }
+    }
+
     lua_scripts::overtime = true;
 
     // we need to aggressively bail out as we are over time
@@ -50,8 +71,132 @@ int lua_scripts::atpanic(lua_State *L) {
     return 0;
 }
 
+// compute the CRC and size of a script source file
+bool lua_scripts::source_crc(const char *filename, uint32_t &crc, uint32_t &size) const {
+    const int fd = AP::FS().open(filename, O_RDONLY);
+    if (fd == -1) {
+        return false;
+    }
+    crc = 0;
+    size = 0;
+    uint8_t buf[128];
+    int32_t n;
+    while ((n = AP::FS().read(fd, buf, sizeof(buf))) > 0) {
+        crc = crc_crc32(crc, buf, n);
+        size += n;
+    }
+    AP::FS().close(fd);
+    return n == 0;
+}
+
+// cached bytecode is named after the CRC of the full path of the source, so
+// scripts of the same name in different directories don't share a cache entry
+void lua_scripts::cache_filename(const char *filename, char *buf, size_t bufsize) const {
+    const uint32_t path_crc = crc_crc32(0, (const uint8_t *)filename, strlen(filename));
+    hal.util->snprintf(buf, bufsize, SCRIPTING_CACHE_DIRECTORY "/%08X.lbc", (unsigned)path_crc);
+}
+
+struct cache_reader_state {
+    int fd;
+    char buf[128];
+};
+
+const char *lua_scripts::cache_reader(lua_State *L, void *ud, size_t *size) {
+    (void)L;  /* not used */
+    cache_reader_state *state = (cache_reader_state *)ud;
+    const int32_t n = AP::FS().read(state->fd, state->buf, sizeof(state->buf));
+    if (n <= 0) {
+        *size = 0;
+        return nullptr;
+    }
+    *size = n;
+    return state->buf;
+}
+
+int lua_scripts::cache_writer(lua_State *L, const void *p, size_t sz, void *ud) {
+    (void)L;  /* not used */
+    const int fd = *(int *)ud;
+    if (AP::FS().write(fd, p, sz) != (int32_t)sz) {
+        return 1;
+    }
+    return 0;
+}
+
+int lua_scripts::load_file(lua_State *L, const char *filename) {
+    struct stat st;
+    if (!_bytecode_cache || AP::FS().stat(filename, &st) != 0) {
+        // let lua report any problems with the file
+        return luaL_loadfile(L, filename);
+    }
+    // the cache is checked against the size and modification time of
+    // the source, so a hit doesn't read the source. ROMFS has no times,
+    // so for those the source is checked against its CRC instead
+    const uint32_t size = st.st_size;
+    const uint32_t mtime = st.st_mtime;
+    uint32_t crc = 0;
+    if (mtime == 0) {
+        uint32_t crc_size;
+        if (!source_crc(filename, crc, crc_size) || crc_size != size) {
+            return luaL_loadfile(L, filename);
+        }
+    }
+
+    char cache_name[sizeof(SCRIPTING_CACHE_DIRECTORY) + 14];
+    cache_filename(filename, cache_name, sizeof(cache_name));
+
+    int fd = AP::FS().open(cache_name, O_RDONLY);
+    if (fd != -1) {
+        bytecode_header header;
+        if ((AP::FS().read(fd, &header, sizeof(header)) == sizeof(header)) &&
+            (header.magic == bytecode_magic) &&
+            (header.lua_version == LUA_VERSION_NUM) &&
+            (header.header_size == sizeof(header)) &&
+            (header.source_crc == crc) &&
+            (header.source_size == size) &&
+            (header.source_mtime == mtime)) {
+            cache_reader_state state;
+            state.fd = fd;
+            if (lua_load(L, cache_reader, &state, filename, "b") == LUA_OK) {
+                AP::FS().close(fd);
+                return LUA_OK;
+            }
+            // bad bytecode, discard the error and rebuild it from the source
+            lua_pop(L, 1);
+        }
+        AP::FS().close(fd);
+    }
+
+    const int status = luaL_loadfile(L, filename);
+    if (status != LUA_OK) {
+        return status;
+    }
+
+    // save the compiled chunk so the next load can skip the parser
+    fd = AP::FS().open(cache_name, O_WRONLY|O_CREAT|O_TRUNC);
+    if (fd == -1) {
+        return status;
+    }
+    bytecode_header header;
+    header.magic = bytecode_magic;
+    header.lua_version = LUA_VERSION_NUM;
+    header.header_size = sizeof(header);
+    header.source_crc = crc;
+    header.source_size = size;
+    header.source_mtime = mtime;
+    bool ok = AP::FS().write(fd, &header, sizeof(header)) == sizeof(header);
+    if (ok) {
+        // debug information is kept so errors still report line numbers
+        ok = lua_dump(L, cache_writer, &fd, 0) == 0;
+    }
+    AP::FS().close(fd);
+    if (!ok) {
+        AP::FS().unlink(cache_name);
+    }
+    return status;
+}
+
 lua_scripts::script_info *lua_scripts::load_script(lua_State *L, char *filename) {
-    if (int error = luaL_loadfile(L, filename)) {
+    if (int error = load_file(L, filename)) {
         switch (error) {
             case LUA_ERRSYNTAX:
                 gcs().send_text(MAV_SEVERITY_CRITICAL, "Lua: Syntax error in %s", filename);
@@ -82,10 +227,15 @@ lua_scripts::script_info *lua_scripts::load_script(lua_State *L, char *filename)
         return nullptr;
     }
 
+    memset(new_script, 0, sizeof(script_info));
     new_script->name = filename;
-    new_script->next = nullptr;
+    new_script->L = L;
+    new_script->heap_slot = -1;
 
     create_sandbox(L);
+    // keep a reference to the sandbox so the script's RUN_BUDGET_US can be read
+    lua_pushvalue(L, -1);
+    new_script->env_ref = luaL_ref(L, LUA_REGISTRYINDEX);
     lua_setupvalue(L, -2, 1);
 
     new_script->lua_ref = luaL_ref(L, LUA_REGISTRYINDEX);   // cache the reference
@@ -149,26 +299,152 @@ void lua_scripts::load_all_scripts_in_dir(lua_State *L, const char *dirname) {
         }
         snprintf(filename, size, "%s/%s", dirname, de->d_name);
 
+        // give the script a state of its own if isolation is enabled
+        lua_State *script_L = L;
+        int8_t heap_slot = -1;
+        if (_iso_heap_size > 0) {
+            script_L = create_isolated_state(heap_slot);
+            if (script_L == nullptr) {
+                gcs().send_text(MAV_SEVERITY_WARNING, "Lua: No isolated heap for %s, sharing", de->d_name);
+                script_L = L;
+            }
+        }
+
         // we have something that looks like a lua file, attempt to load it
-        script_info * script = load_script(L, filename);
+        script_info * script = load_script(script_L, filename);
         if (script == nullptr) {
+            if (heap_slot >= 0) {
+                close_isolated_state(script_L, heap_slot);
+            }
             hal.util->heap_realloc(_heap, filename, 0);
             continue;
         }
+        script->heap_slot = heap_slot;
         reschedule_script(script);
 
     }
     AP::FS().closedir(d);
 }
 
+lua_State *lua_scripts::create_isolated_state(int8_t &heap_slot) {
+    heap_slot = -1;
+    for (uint8_t i = 0; i < SCRIPTING_MAX_ISOLATED_STATES; i++) {
+        if ((_iso_heaps_in_use & (1U << i)) == 0) {
+            heap_slot = i;
+            break;
+        }
+    }
+    if (heap_slot < 0) {
+        return nullptr;
+    }
+
+    // heaps can't be freed, so they are kept for reuse if the scripts are reloaded
+    if (_iso_heaps[heap_slot] == nullptr) {
+        _iso_heaps[heap_slot] = hal.util->allocate_heap_memory(_iso_heap_size);
+        if (_iso_heaps[heap_slot] == nullptr) {
+            heap_slot = -1;
+            return nullptr;
+        }
+    }
+
+    lua_State *L = lua_newstate(alloc, _iso_heaps[heap_slot]);
+    if (L == nullptr) {
+        heap_slot = -1;
+        return nullptr;
+    }
+    lua_atpanic(L, atpanic);
+    load_generated_bindings(L);
+
+    _iso_heaps_in_use |= (1U << heap_slot);
+    return L;
+}
+
+void lua_scripts::close_isolated_state(lua_State *L, int8_t heap_slot) {
+    if (L != nullptr) {
+        lua_close(L);
+    }
+    if (heap_slot >= 0) {
+        _iso_heaps_in_use &= ~(1U << heap_slot);
+    }
+}
+
 void lua_scripts::reset_loop_overtime(lua_State *L) {
     overtime = false;
     // reset the hook to clear the counter
     const int32_t vm_steps = MAX(_vm_steps, 1000);
-    lua_sethook(L, hook, LUA_MASKCOUNT, vm_steps);
+    script_info *script = running_script;
+    if (script != nullptr && script->budget_us != 0) {
+        script->steps_remaining = vm_steps;
+        script->run_start_us = AP_HAL::micros();
+        lua_sethook(L, hook, LUA_MASKCOUNT, SCRIPTING_BUDGET_CHECK_STEPS);
+    } else {
+        lua_sethook(L, hook, LUA_MASKCOUNT, vm_steps);
+    }
+}
+
+/*
+  a script may set its own budget with a RUN_BUDGET_US global, otherwise
+  SCR_RUN_BUDGET is used. SCR_VM_I_COUNT still limits every run
+ */
+uint32_t lua_scripts::script_budget(lua_State *L, const script_info *script) const {
+    int32_t budget = _run_budget_us;
+    lua_rawgeti(L, LUA_REGISTRYINDEX, script->env_ref);
+    lua_pushstring(L, "RUN_BUDGET_US");
+    if (lua_rawget(L, -2) == LUA_TNUMBER) {
+        budget = lua_tointeger(L, -1);
+    }
+    lua_pop(L, 2);
+    return MAX(budget, 0);
 }
 
-void lua_scripts::run_next_script(lua_State *L) {
+void lua_scripts::update_stats(script_info *script, uint32_t run_time_us, int32_t run_mem) {
+    WITH_SEMAPHORE(_list_sem);
+
+    script->run_count++;
+    script->last_run_us = run_time_us;
+    script->max_run_us = MAX(script->max_run_us, run_time_us);
+    script->total_run_us += run_time_us;
+    script->total_mem = lua_gc(script->L, LUA_GCCOUNT, 0) * 1024 + lua_gc(script->L, LUA_GCCOUNTB, 0);
+    script->run_mem = run_mem;
+    script->total_allocs += script->run_allocs;
+
+    if (_debug_level > 1) {
+        gcs().send_text(MAV_SEVERITY_DEBUG, "Lua: Time: %u Mem: %d + %d Allocs: %u",
+                                            (unsigned int)run_time_us,
+                                            (int)script->total_mem,
+                                            (int)run_mem,
+                                            (unsigned int)script->run_allocs);
+    }
+
+    if ((_debug_options.get() & uint8_t(DebugOption::LOG_RUNTIME)) != 0) {
+        // log the file name without the directory
+        const char *base_name = strrchr(script->name, '/');
+        base_name = (base_name == nullptr) ? script->name : base_name + 1;
+        char name[16] {};
+        strncpy(name, base_name, sizeof(name));
+
+// @LoggerMessage: SCR
+// @Description: Scripting runtime stats
+// @Field: TimeUS: Time since system startup
+// @Field: Name: script name
+// @Field: Runtime: run time
+// @Field: Total_mem: total memory used by the state the script runs in
+// @Field: Run_mem: change in memory over the run
+// @Field: Allocs: number of allocations made by the run
+// @Field: Alloc_b: bytes allocated by the run
+        AP::logger().Write("SCR", "TimeUS,Name,Runtime,Total_mem,Run_mem,Allocs,Alloc_b",
+                           "s#sbb-b", "F-F----", "QNIiiII",
+                           AP_HAL::micros64(),
+                           name,
+                           run_time_us,
+                           (int32_t)script->total_mem,
+                           run_mem,
+                           script->run_allocs,
+                           script->run_alloc_bytes);
+    }
+}
+
+void lua_scripts::run_next_script(void) {
     if (scripts == nullptr) {
 #if defined(AP_SCRIPTING_CHECKS) && AP_SCRIPTING_CHECKS >= 1
         AP_HAL::panic("Lua: Attempted to run a script without any scripts queued");
@@ -177,8 +453,25 @@ void lua_scripts::run_next_script(lua_State *L) {
     }
 
     // strip the selected script out of the list
-    script_info *script = scripts;
-    scripts = script->next;
+    script_info *script;
+    {
+        WITH_SEMAPHORE(_list_sem);
+        script = scripts;
+        scripts = script->next;
+        running_script = script;
+    }
+
+    lua_State *L = script->L;
+
+    script->budget_us = script_budget(L, script);
+    script->run_allocs = 0;
+    script->run_alloc_bytes = 0;
+
+    if (_debug_level > 1) {
+        gcs().send_text(MAV_SEVERITY_DEBUG, "Lua: Running %s", script->name);
+    }
+
+    const int start_mem = lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
 
     // reset the hook to clear the counter
     reset_loop_overtime(L);
@@ -189,17 +482,24 @@ void lua_scripts::run_next_script(lua_State *L) {
     // pop the function to the top of the stack
     lua_rawgeti(L, LUA_REGISTRYINDEX, script->lua_ref);
 
-    if(lua_pcall(L, 0, LUA_MULTRET, 0)) {
+    const uint32_t run_start = AP_HAL::micros();
+    const int run_result = lua_pcall(L, 0, LUA_MULTRET, 0);
+    const uint32_t run_time_us = AP_HAL::micros() - run_start;
+
+    const int end_mem = lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
+    update_stats(script, run_time_us, end_mem - start_mem);
+
+    if (run_result) {
         if (overtime) {
             // script has consumed an excessive amount of CPU time
             gcs().send_text(MAV_SEVERITY_CRITICAL, "Lua: %s exceeded time limit", script->name);
-            remove_script(L, script);
         } else {
             hal.console->printf("Lua: Error: %s\n", lua_tostring(L, -1));
             gcs().send_text(MAV_SEVERITY_INFO, "Lua: %s", lua_tostring(L, -1));
-            remove_script(L, script);
         }
+        // pop the error before removing the script, which closes an isolated state
         lua_pop(L, 1);
+        remove_script(L, script);
         return;
     } else {
         int returned = lua_gettop(L) - stack_top;
@@ -231,14 +531,18 @@ void lua_scripts::run_next_script(lua_State *L) {
                    script->lua_ref = luaL_ref(L, LUA_REGISTRYINDEX);
                    luaL_unref(L, LUA_REGISTRYINDEX, old_ref);
                    reschedule_script(script);
+                   if (script->heap_slot >= 0) {
+                       // the shared state is collected by run(), isolated states are collected here
+                       lua_gc(L, LUA_GCCOLLECT, 0);
+                   }
                    break;
                 }
             default:
                 {
                     gcs().send_text(MAV_SEVERITY_CRITICAL, "Lua: %s returned bad result count (%d)", script->name, returned);
-                    remove_script(L, script);
                     // pop all the results we got that we didn't expect
                     lua_pop(L, returned);
+                    remove_script(L, script);
                     break;
                  }
          }
@@ -250,6 +554,12 @@ void lua_scripts::remove_script(lua_State *L, script_info *script) {
         return;
     }
 
+    WITH_SEMAPHORE(_list_sem);
+
+    if (running_script == script) {
+        running_script = nullptr;
+    }
+
     // ensure that the script isn't in the loaded list for any reason
     if (scripts == nullptr) {
         // nothing to do, already not in the list
@@ -264,9 +574,13 @@ void lua_scripts::remove_script(lua_State *L, script_info *script) {
         }
     }
 
-    if (L != nullptr) {
+    if (script->heap_slot >= 0) {
+        // an isolated state only holds this script, so it can be closed outright
+        close_isolated_state(script->L, script->heap_slot);
+    } else if (L != nullptr) {
         // state could be null if we are force killing all scripts
         luaL_unref(L, LUA_REGISTRYINDEX, script->lua_ref);
+        luaL_unref(L, LUA_REGISTRYINDEX, script->env_ref);
     }
     hal.util->heap_realloc(_heap, script->name, 0);
     hal.util->heap_realloc(_heap, script, 0);
@@ -280,6 +594,13 @@ void lua_scripts::reschedule_script(script_info *script) {
        return;
     }
 
+    WITH_SEMAPHORE(_list_sem);
+
+    if (running_script == script) {
+        // back in the list, so it isn't reported twice
+        running_script = nullptr;
+    }
+
     script->next = nullptr;
     if (scripts == nullptr) {
         scripts = script;
@@ -310,8 +631,82 @@ void lua_scripts::reschedule_script(script_info *script) {
 void *lua_scripts::_heap;
 
 void *lua_scripts::alloc(void *ud, void *ptr, size_t osize, size_t nsize) {
-    (void)ud; (void)osize;  /* not used */
-    return hal.util->heap_realloc(_heap, ptr, nsize);
+    // charge allocations, and blocks being grown, to the running script.
+    // osize is the type of the new object when ptr is null
+    script_info *script = running_script;
+    if (script != nullptr && nsize != 0 && (ptr == nullptr || nsize > osize)) {
+        script->run_allocs++;
+        script->run_alloc_bytes += (ptr == nullptr) ? nsize : nsize - osize;
+    }
+    return hal.util->heap_realloc(ud, ptr, nsize);
+}
+
+int lua_scripts::print_stats(const script_info *script, bool running, char *buf, size_t bufsize) const {
+    const char *base_name = strrchr(script->name, '/');
+    base_name = (base_name == nullptr) ? script->name : base_name + 1;
+
+    uint32_t avg = 0;
+    if (script->run_count > 0) {
+        avg = script->total_run_us / script->run_count;
+    }
+
+    return hal.util->snprintf(buf, bufsize, "%-16.16s %s%s RUNS=%u LAST=%u AVG=%u MAX=%u TOT=%u BUDGET=%u MEM=%u RMEM=%d ALLOCS=%u RALLOCS=%u RBYTES=%u\n",
+                              base_name,
+                              (script->heap_slot >= 0) ? "ISO" : "SHR",
+                              running ? "*" : " ",
+                              unsigned(script->run_count),
+                              unsigned(script->last_run_us),
+                              unsigned(avg),
+                              unsigned(script->max_run_us),
+                              unsigned(script->total_run_us / 1000),
+                              unsigned(script->budget_us),
+                              unsigned(script->total_mem),
+                              int(script->run_mem),
+                              unsigned(script->total_allocs),
+                              unsigned(script->run_allocs),
+                              unsigned(script->run_alloc_bytes));
+}
+
+void lua_scripts::run_allocations(uint32_t &count, uint32_t &bytes) {
+    const script_info *script = running_script;
+    count = (script != nullptr) ? script->run_allocs : 0;
+    bytes = (script != nullptr) ? script->run_alloc_bytes : 0;
+}
+
+size_t lua_scripts::script_stats(char *buf, size_t bufsize) {
+    size_t total = 0;
+
+    // a header to allow for machine parsers to determine format
+    int n = hal.util->snprintf(buf, bufsize, "ScriptsV1\n");
+    if (n <= 0) {
+        return 0;
+    }
+    buf += n;
+    bufsize -= n;
+    total += n;
+
+    WITH_SEMAPHORE(_list_sem);
+
+    // the running script is out of the list, so report it first
+    const script_info *script = running_script;
+    bool running = true;
+    if (script == nullptr) {
+        script = scripts;
+        running = false;
+    }
+    while (script != nullptr) {
+        n = print_stats(script, running, buf, bufsize);
+        if (n <= 0 || size_t(n) >= bufsize) {
+            break;
+        }
+        buf += n;
+        bufsize -= n;
+        total += n;
+        script = running ? scripts : script->next;
+        running = false;
+    }
+
+    return total;
 }
 
 void lua_scripts::repl_cleanup (void) {
@@ -343,7 +738,10 @@ void lua_scripts::run(void) {
         if (lua_state != nullptr) {
             lua_close(lua_state); // shutdown the old state
         }
-        // remove all the old scheduled scripts
+        // remove all the old scheduled scripts, and the script that was running if it panicked
+        if (running_script != nullptr) {
+            remove_script(nullptr, running_script);
+        }
         for (script_info *script = scripts; script != nullptr; script = scripts) {
             remove_script(nullptr, script);
         }
@@ -353,7 +751,7 @@ void lua_scripts::run(void) {
         repl_cleanup();
     }
 
-    lua_state = lua_newstate(alloc, NULL);
+    lua_state = lua_newstate(alloc, _heap);
     lua_State *L = lua_state;
     if (L == nullptr) {
         gcs().send_text(MAV_SEVERITY_CRITICAL, "Lua: Couldn't allocate a lua state");
@@ -363,8 +761,12 @@ void lua_scripts::run(void) {
     load_generated_bindings(L);
 
     // Scan the filesystem in an appropriate manner and autostart scripts
+    const uint32_t load_start_ms = AP_HAL::millis();
     load_all_scripts_in_dir(L, SCRIPTING_DIRECTORY);
     load_all_scripts_in_dir(L, "@ROMFS/scripts");
+    if (_debug_level > 0) {
+        gcs().send_text(MAV_SEVERITY_DEBUG, "Lua: Loaded scripts in %ums", (unsigned)(AP_HAL::millis() - load_start_ms));
+    }
 
 #ifndef __clang_analyzer__
     succeeded_initial_load = true;
@@ -401,23 +803,8 @@ void lua_scripts::run(void) {
                 hal.scheduler->delay(scripts->next_run_ms - now_ms);
             }
 
-            if (_debug_level > 1) {
-                gcs().send_text(MAV_SEVERITY_DEBUG, "Lua: Running %s", scripts->name);
-            }
-
-            const int startMem = lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
-            const uint32_t loadEnd = AP_HAL::micros();
-
-            run_next_script(L);
-
-            const uint32_t runEnd = AP_HAL::micros();
-            const int endMem = lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
-            if (_debug_level > 1) {
-                gcs().send_text(MAV_SEVERITY_DEBUG, "Lua: Time: %u Mem: %d + %d",
-                                                    (unsigned int)(runEnd - loadEnd),
-                                                    (int)endMem,
-                                                    (int)(endMem - startMem));
-            }
+            run_next_script();
+            running_script = nullptr;
 
             // garbage collect after each script, this shouldn't matter, but seems to resolve a memory leak
             lua_gc(L, LUA_GCCOLLECT, 0);
@@ -38,6 +38,21 @@
   #endif //HAL_OS_FATFS_IO
 #endif // SCRIPTING_DIRECTORY
 
+#ifndef SCRIPTING_CACHE_DIRECTORY
+  #define SCRIPTING_CACHE_DIRECTORY SCRIPTING_DIRECTORY "/cache"
+#endif // SCRIPTING_CACHE_DIRECTORY
+
+#ifndef SCRIPTING_MAX_ISOLATED_STATES
+  #if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+    #define SCRIPTING_MAX_ISOLATED_STATES 16
+  #else
+    #define SCRIPTING_MAX_ISOLATED_STATES 8
+  #endif
+#endif // SCRIPTING_MAX_ISOLATED_STATES
+
+// number of VM instructions between checks of the run time budget
+#define SCRIPTING_BUDGET_CHECK_STEPS 1000
+
 #ifndef REPL_IN
   #define REPL_IN REPL_DIRECTORY "/in"
 #endif // REPL_IN
@@ -49,7 +64,9 @@
 class lua_scripts
 {
 public:
-    lua_scripts(const AP_Int32 &vm_steps, const AP_Int32 &heap_size, const AP_Int8 &debug_level, struct AP_Scripting::terminal_s &_terminal);
+    lua_scripts(const AP_Int32 &vm_steps, const AP_Int32 &heap_size, const AP_Int8 &debug_level,
+                const AP_Int32 &iso_heap_size, const AP_Int32 &run_budget_us, const AP_Int8 &debug_options,
+                const AP_Int8 &bytecode_cache, struct AP_Scripting::terminal_s &_terminal);
 
     /* Do not allow copies */
     lua_scripts(const lua_scripts &other) = delete;
@@ -61,9 +78,19 @@ public:
     // run scripts, does not return unless an error occured
     void run(void);
 
+    // fill buf with the per script run time and memory statistics, for @SYS/scripts.txt
+    size_t script_stats(char *buf, size_t bufsize);
+
+    // allocations made so far by the current run of the running script
+    static void run_allocations(uint32_t &count, uint32_t &bytes);
+
     static bool overtime; // script exceeded it's execution slot, and we are bailing out
 private:
 
+    enum class DebugOption : uint8_t {
+        LOG_RUNTIME = 1U << 0,
+    };
+
     void create_sandbox(lua_State *L);
 
     void repl_cleanup(void);
@@ -72,16 +99,63 @@ private:
        int lua_ref;          // reference to the loaded script object
        uint64_t next_run_ms; // time (in milliseconds) the script should next be run at
        char *name;           // filename for the script // FIXME: This information should be available from Lua
+       lua_State *L;         // state the script runs in, either the shared state or its own isolated state
+       int8_t heap_slot;     // index of the isolated heap used by the script, -1 if using the shared state
+       uint32_t run_count;   // number of times the script has been run
+       uint32_t last_run_us; // CPU time taken by the most recent run
+       uint32_t max_run_us;  // longest single run
+       uint64_t total_run_us; // CPU time taken by all runs
+       uint32_t total_mem;   // memory used by the state the script runs in after the last run
+       int32_t run_mem;      // change in memory over the last run
+       int env_ref;          // reference to the script's sandbox, where it may set RUN_BUDGET_US
+       uint32_t budget_us;   // run time budget of each run, 0 if disabled
+       uint32_t run_start_us; // time the current run started
+       int32_t steps_remaining; // VM instructions left in the current run
+       uint32_t run_allocs;  // allocations made by the last run
+       uint32_t run_alloc_bytes; // bytes allocated by the last run
+       uint32_t total_allocs; // allocations made by all runs
        script_info *next;
     } script_info;
 
     script_info *load_script(lua_State *L, char *filename);
 
+    // load a script file onto the stack, preferring the cached bytecode if it matches the source
+    int load_file(lua_State *L, const char *filename);
+
+    // header placed in front of cached bytecode to detect a stale cache
+    struct PACKED bytecode_header {
+        uint32_t magic;
+        uint16_t lua_version;
+        uint16_t header_size;
+        uint32_t source_crc;        // only used for sources without a modification time
+        uint32_t source_size;
+        uint32_t source_mtime;
+    };
+    static constexpr uint32_t bytecode_magic = 0x4342504C; // LPBC
+
+    bool source_crc(const char *filename, uint32_t &crc, uint32_t &size) const;
+    void cache_filename(const char *filename, char *buf, size_t bufsize) const;
+    static const char *cache_reader(lua_State *L, void *ud, size_t *size);
+    static int cache_writer(lua_State *L, const void *p, size_t sz, void *ud);
+
     void reset_loop_overtime(lua_State *L);
 
+    // run time budget for the next run of a script
+    uint32_t script_budget(lua_State *L, const script_info *script) const;
+
     void load_all_scripts_in_dir(lua_State *L, const char *dirname);
 
-    void run_next_script(lua_State *L);
+    // create a new lua_State with its own heap for a single script, returns nullptr if none are available
+    lua_State *create_isolated_state(int8_t &heap_slot);
+    void close_isolated_state(lua_State *L, int8_t heap_slot);
+
+    void run_next_script(void);
+
+    // print one line of script_stats(), running is true for the script being run
+    int print_stats(const script_info *script, bool running, char *buf, size_t bufsize) const;
+
+    // update the run statistics of a script after it has been run
+    void update_stats(script_info *script, uint32_t run_time_us, int32_t run_mem);
 
     void remove_script(lua_State *L, script_info *script);
 
@@ -103,6 +177,9 @@ private:
     int sandbox_ref;
 
     script_info *scripts; // linked list of scripts to be run, sorted by next run time (soonest first)
+    // script currently being run, it is not in the scripts list while
+    // running. Static so the hook and allocator can charge it
+    static script_info *running_script;
 
     // hook will be run when CPU time for a script is exceeded
     // it must be static to be passed to the C API
@@ -116,8 +193,20 @@ private:
 
     const AP_Int32 & _vm_steps;
     const AP_Int8 & _debug_level;
+    const AP_Int32 & _iso_heap_size;
+    const AP_Int32 & _run_budget_us;
+    const AP_Int8 & _debug_options;
+    const AP_Int8 & _bytecode_cache;
 
+    // ud is the heap the state allocates from
     static void *alloc(void *ud, void *ptr, size_t osize, size_t nsize);
 
     static void *_heap;
+
+    // heaps for isolated states, these are allocated on demand and reused as heaps can't be freed
+    void *_iso_heaps[SCRIPTING_MAX_ISOLATED_STATES];
+    uint32_t _iso_heaps_in_use;
+
+    // protects the scripts list from being read while it is modified
+    HAL_Semaphore _list_sem;
 };
@@ -34,10 +34,40 @@ function test_offset(ofs_e, ofs_n)
   return true
 end
 
+function test_result_reuse()
+  local target = Location()
+  target:offset(30, 40)
+  local dest = Vector3f()
+  local result = Location():get_distance_NED(target, dest)
+  if result ~= dest then
+    gcs:send_text(0, "get_distance_NED did not return the destination it was given")
+    return false
+  end
+  local fresh = Location():get_distance_NED(target)
+  if (not is_equal(dest:x(), fresh:x())) or (not is_equal(dest:y(), fresh:y())) or (not is_equal(dest:z(), fresh:z())) then
+    gcs:send_text(0, string.format("Reused result %.1f, %.1f differs from new result %.1f %.1f", dest:x(), dest:y(), fresh:x(), fresh:y()))
+    return false
+  end
+  return true
+end
+
+function test_allocations()
+  local start_allocs, start_bytes = allocations()
+  local v = Vector3f()
+  local end_allocs, end_bytes = allocations()
+  if (end_allocs <= start_allocs) or (end_bytes <= start_bytes) then
+    gcs:send_text(0, string.format("Vector3f() did not count an allocation (%d, %d)", end_allocs - start_allocs, end_bytes - start_bytes))
+    return false
+  end
+  return true
+end
+
 function update()
   local all_tests_passed = true
   -- each test should run then and it's result with the previous ones
   all_tests_passed = test_offset(500, 200) and all_tests_passed
+  all_tests_passed = test_result_reuse() and all_tests_passed
+  all_tests_passed = test_allocations() and all_tests_passed
 
   if all_tests_passed then
     gcs:send_text(3, "Internal tests passed")
@@ -247,12 +247,38 @@ bool AP_Vehicle::is_crashed() const
 // @Field: DnF2: dynamic harmonic notch centre frequency for motor 2
 // @Field: DnF3: dynamic harmonic notch centre frequency for motor 3
 // @Field: DnF4: dynamic harmonic notch centre frequency for motor 4
+
+// @LoggerMessage: FTNB
+// @Description: Filter Tuning Messages for additional harmonic notch banks
+// @Field: TimeUS: microseconds since system startup
+// @Field: I: harmonic notch bank
+// @Field: NDn: number of active dynamic harmonic notches
+// @Field: DnF1: dynamic harmonic notch centre frequency for motor 1
+// @Field: DnF2: dynamic harmonic notch centre frequency for motor 2
+// @Field: DnF3: dynamic harmonic notch centre frequency for motor 3
+// @Field: DnF4: dynamic harmonic notch centre frequency for motor 4
 void AP_Vehicle::write_notch_log_messages() const
 {
-    const float* notches = ins.get_gyro_dynamic_notch_center_frequencies_hz();
+    const uint64_t now_us = AP_HAL::micros64();
+
+    // the first bank is always logged as FTN, as it was before there
+    // were multiple banks
+    const AP_InertialSensor::HarmonicNotch &first = ins.harmonic_notches[0];
+    const float* notches = first.calculated_frequencies_hz();
     AP::logger().Write(
-        "FTN", "TimeUS,NDn,DnF1,DnF2,DnF3,DnF4", "s-zzzz", "F-----", "QBffff", AP_HAL::micros64(), ins.get_num_gyro_dynamic_notch_center_frequencies(),
+        "FTN", "TimeUS,NDn,DnF1,DnF2,DnF3,DnF4", "s-zzzz", "F-----", "QBffff", now_us, first.num_calculated_frequencies(),
             notches[0], notches[1], notches[2], notches[3]);
+
+    for (uint8_t i = 1; i < HAL_INS_NUM_HARMONIC_NOTCH_FILTERS; i++) {
+        const AP_InertialSensor::HarmonicNotch &notch = ins.harmonic_notches[i];
+        if (!notch.enabled()) {
+            continue;
+        }
+        notches = notch.calculated_frequencies_hz();
+        AP::logger().Write(
+            "FTNB", "TimeUS,I,NDn,DnF1,DnF2,DnF3,DnF4", "s#-zzzz", "F------", "QBBffff", now_us, i, notch.num_calculated_frequencies(),
+                notches[0], notches[1], notches[2], notches[3]);
+    }
 }
 
 AP_Vehicle *AP_Vehicle::_singleton = nullptr;
@@ -0,0 +1,95 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BiquadCascade.h"
+
+/*
+  disable all notch stages. The cascade keeps the state of a stage
+  until it is enabled again
+ */
+void BiquadCascadeCoefficients::clear_notches()
+{
+    _num_stages = 0;
+}
+
+/*
+  load a notch stage, stages are applied in the order they are set
+ */
+void BiquadCascadeCoefficients::set_notch(uint8_t stage, const NotchFilterCoefficients &coeffs)
+{
+    if (stage >= BIQUAD_CASCADE_MAX_NOTCHES || _num_stages >= BIQUAD_CASCADE_MAX_NOTCHES) {
+        return;
+    }
+    _coeffs[stage] = coeffs;
+    _stages[_num_stages++] = stage;
+}
+
+/*
+  load the low pass filter, a zero cutoff passes samples through
+ */
+void BiquadCascadeCoefficients::set_low_pass(const DigitalBiquadFilter<Vector3f>::biquad_params &params)
+{
+    _lpf_enabled = is_positive(params.cutoff_freq) && !is_zero(params.sample_freq);
+    _lpf_b0 = params.b0;
+    _lpf_b1 = params.b1;
+    _lpf_b2 = params.b2;
+    _lpf_a1 = params.a1;
+    _lpf_a2 = params.a2;
+}
+
+/*
+  apply a new input sample, returning new output. The arithmetic is done
+  in the same order as the separate filters so the results match them
+ */
+Vector3f BiquadCascadeVector3f::apply(const BiquadCascadeCoefficients &coeffs, const Vector3f &sample)
+{
+    float v[3] { sample.x, sample.y, sample.z };
+
+    for (uint8_t i = 0; i < coeffs._num_stages; i++) {
+        const uint8_t stage = coeffs._stages[i];
+        const NotchFilterCoefficients &c = coeffs._coeffs[stage];
+        notch_state &s = _state[stage];
+        for (uint8_t a = 0; a < 3; a++) {
+            const float x0 = v[a];
+            const float out = (x0*c.b0 + s.x1[a]*c.b1 + s.x2[a]*c.b2 - s.y1[a]*c.a1 - s.y2[a]*c.a2) * c.a0_inv;
+            s.x2[a] = s.x1[a];
+            s.x1[a] = x0;
+            s.y2[a] = s.y1[a];
+            s.y1[a] = out;
+            v[a] = out;
+        }
+    }
+
+    if (coeffs._lpf_enabled) {
+        for (uint8_t a = 0; a < 3; a++) {
+            const float w0 = v[a] - _lpf_w1[a]*coeffs._lpf_a1 - _lpf_w2[a]*coeffs._lpf_a2;
+            v[a] = w0*coeffs._lpf_b0 + _lpf_w1[a]*coeffs._lpf_b1 + _lpf_w2[a]*coeffs._lpf_b2;
+            _lpf_w2[a] = _lpf_w1[a];
+            _lpf_w1[a] = w0;
+        }
+    }
+
+    return Vector3f(v[0], v[1], v[2]);
+}
+
+/*
+  reset the delayed samples of every stage, enabled or not
+ */
+void BiquadCascadeVector3f::reset()
+{
+    memset(_state, 0, sizeof(_state));
+    memset(_lpf_w1, 0, sizeof(_lpf_w1));
+    memset(_lpf_w2, 0, sizeof(_lpf_w2));
+}
@@ -0,0 +1,86 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <AP_Math/AP_Math.h>
+#include "NotchFilter.h"
+#include "HarmonicNotchFilter.h"
+#include "LowPassFilter2p.h"
+
+#ifndef BIQUAD_CASCADE_MAX_NOTCHES
+// one static notch plus two full harmonic notch banks
+#define BIQUAD_CASCADE_MAX_NOTCHES (1 + 2 * HNF_MAX_FILTERS)
+#endif
+
+/*
+  the coefficients of a cascade of notch filters followed by a low pass
+  filter.
+
+  The filters are designed by the usual NotchFilter, HarmonicNotchFilter
+  and LowPassFilter2p objects, whose coefficients are loaded into this
+  compact block whenever they change. The block is kept apart from the
+  filter state so it can be handed from the thread designing the filters
+  to the sample path without either side taking a lock.
+ */
+class BiquadCascadeCoefficients {
+public:
+    friend class BiquadCascadeVector3f;
+
+    // disable all notch stages, ready for a new set of coefficients
+    void clear_notches();
+    // load the coefficients of a notch stage and enable it
+    void set_notch(uint8_t stage, const NotchFilterCoefficients &coeffs);
+    // load the low pass filter coefficients
+    void set_low_pass(const DigitalBiquadFilter<Vector3f>::biquad_params &params);
+
+private:
+    NotchFilterCoefficients _coeffs[BIQUAD_CASCADE_MAX_NOTCHES];
+    // enabled stages in order of application
+    uint8_t _stages[BIQUAD_CASCADE_MAX_NOTCHES];
+    uint8_t _num_stages;
+
+    float _lpf_b0, _lpf_b1, _lpf_b2, _lpf_a1, _lpf_a2;
+    bool _lpf_enabled;
+};
+
+/*
+  a cascade of notch filters followed by a low pass filter, run on all
+  three axes of a vector in a single pass.
+
+  The sample path only reads a compact coefficient and state block, with
+  the state of each stage kept as one array per delay element so the
+  axis loop vectorises where the CPU allows. Each notch stage keeps its
+  state while it is disabled, so re-enabling a stage behaves as the
+  separate filters did.
+ */
+class BiquadCascadeVector3f {
+public:
+    // apply a sample to each enabled stage in turn and return the output
+    Vector3f apply(const BiquadCascadeCoefficients &coeffs, const Vector3f &sample);
+    // reset the state of all stages
+    void reset();
+
+private:
+    // direct form I notch state, as used by NotchFilter
+    struct notch_state {
+        float x1[3], x2[3];
+        float y1[3], y2[3];
+    };
+
+    notch_state _state[BIQUAD_CASCADE_MAX_NOTCHES];
+
+    // direct form II low pass state, as used by LowPassFilter2p
+    float _lpf_w1[3], _lpf_w2[3];
+};
@@ -16,7 +16,6 @@
 #include "HarmonicNotchFilter.h"
 #include <GCS_MAVLink/GCS.h>
 
-#define HNF_MAX_FILTERS 6 // must be even for double-notch filters
 #define HNF_MAX_HARMONICS 8
 
 // table of user settable parameters
@@ -71,9 +70,9 @@ const AP_Param::GroupInfo HarmonicNotchFilterParams::var_info[] = {
 
     // @Param: MODE
     // @DisplayName: Harmonic Notch Filter dynamic frequency tracking mode
-    // @Description: Harmonic Notch Filter dynamic frequency tracking mode. Dynamic updates can be throttle, RPM sensor, ESC telemetry or dynamic FFT based. Throttle-based updates should only be used with multicopters.
-    // @Range: 0 4
-    // @Values: 0:Disabled,1:Throttle,2:RPM Sensor,3:ESC Telemetry,4:Dynamic FFT
+    // @Description: Harmonic Notch Filter dynamic frequency tracking mode. Dynamic updates can be throttle, RPM sensor, ESC telemetry or dynamic FFT based. Throttle-based updates should only be used with multicopters. Each harmonic notch can use a different mode, for example the first RPM sensor for the main rotor and the second for the tail rotor.
+    // @Range: 0 5
+    // @Values: 0:Disabled,1:Throttle,2:RPM Sensor,3:ESC Telemetry,4:Dynamic FFT,5:Second RPM Sensor
     // @User: Advanced
     AP_GROUPINFO("MODE", 7, HarmonicNotchFilterParams, _tracking_mode, 1),
 
@@ -272,6 +271,24 @@ void HarmonicNotchFilter<T>::reset()
     }
 }
 
+/*
+  get the coefficients of the enabled filters so that they can be run
+  by a fused filter chain
+ */
+template <class T>
+uint8_t HarmonicNotchFilter<T>::get_coefficients(NotchFilterCoefficients coeffs[], uint8_t max_coeffs) const
+{
+    if (!_initialised) {
+        return 0;
+    }
+
+    uint8_t count = MIN(_num_enabled_filters, max_coeffs);
+    for (uint8_t i = 0; i < count; i++) {
+        _filters[i].get_coefficients(coeffs[i]);
+    }
+    return count;
+}
+
 /*
   create parameters for the harmonic notch filter and initialise defaults
  */
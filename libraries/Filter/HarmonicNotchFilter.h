@@ -21,6 +21,7 @@
 
 #define HNF_MAX_HARMONICS 8
 #define HNF_MAX_HMNC_BITSET 0xF
+#define HNF_MAX_FILTERS 6 // must be even for double-notch filters
 
 /*
   a filter that manages a set of notch filters targetted at a fundamental center frequency
@@ -42,6 +43,8 @@ public:
     T apply(const T &sample);
     // reset each of the underlying filters
     void reset();
+    // get the coefficients of the enabled filters in application order, returns the number of filters
+    uint8_t get_coefficients(NotchFilterCoefficients coeffs[], uint8_t max_coeffs) const;
 
 private:
     // underlying bank of notch filters
@@ -72,6 +75,7 @@ enum class HarmonicNotchDynamicMode {
     UpdateRPM       = 2,
     UpdateBLHeli    = 3,
     UpdateGyroFFT   = 4,
+    UpdateRPM2      = 5,
 };
 
 /*
@@ -57,6 +57,8 @@ public:
     // return the cutoff frequency
     float get_cutoff_freq(void) const;
     float get_sample_freq(void) const;
+    // return the biquad coefficients
+    const struct DigitalBiquadFilter<T>::biquad_params &get_params(void) const { return _params; }
     T apply(const T &sample);
     void reset(void);
 
@@ -95,6 +95,28 @@ void NotchFilter<T>::reset()
     signal2 = signal1 = T();
 }
 
+/*
+  get the coefficients of the filter. An uninitialised filter gives
+  coefficients that pass the input through while still shifting the
+  delayed samples, matching apply()
+ */
+template <class T>
+void NotchFilter<T>::get_coefficients(NotchFilterCoefficients &coeffs) const
+{
+    if (!initialised) {
+        coeffs.b0 = 1.0f;
+        coeffs.b1 = coeffs.b2 = coeffs.a1 = coeffs.a2 = 0.0f;
+        coeffs.a0_inv = 1.0f;
+        return;
+    }
+    coeffs.b0 = b0;
+    coeffs.b1 = b1;
+    coeffs.b2 = b2;
+    coeffs.a1 = a1;
+    coeffs.a2 = a2;
+    coeffs.a0_inv = a0_inv;
+}
+
 // table of user settable parameters
 const AP_Param::GroupInfo NotchFilterParams::var_info[] = {
 
@@ -25,6 +25,13 @@
 #include <inttypes.h>
 #include <AP_Param/AP_Param.h>
 
+/*
+  coefficients of a single notch, used to run notches outside of the
+  filter object that designed them
+ */
+struct NotchFilterCoefficients {
+    float b0, b1, b2, a1, a2, a0_inv;
+};
 
 template <class T>
 class NotchFilter {
@@ -35,6 +42,9 @@ public:
     T apply(const T &sample);
     void reset();
 
+    // get the current coefficients, an uninitialised filter passes samples through
+    void get_coefficients(NotchFilterCoefficients &coeffs) const;
+
     // calculate attenuation and quality from provided center frequency and bandwidth
     static void calculate_A_and_Q(float center_freq_hz, float bandwidth_hz, float attenuation_dB, float& A, float& Q); 
 
@@ -0,0 +1,105 @@
+#include <AP_gtest.h>
+
+#include <Filter/BiquadCascade.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#define SAMPLE_RATE_HZ 8000
+
+// a gyro like signal with motor noise at a fundamental that moves over time
+static Vector3f gyro_sample(uint32_t i, float fundamental_hz)
+{
+    const float t = float(i) / SAMPLE_RATE_HZ;
+    Vector3f v;
+    v.x = 0.5f * sinf(2 * M_PI * 3 * t) + 0.2f * sinf(2 * M_PI * fundamental_hz * t);
+    v.y = -0.3f * cosf(2 * M_PI * 7 * t) + 0.1f * sinf(2 * M_PI * 2 * fundamental_hz * t);
+    v.z = 0.05f * sinf(2 * M_PI * 3 * fundamental_hz * t) + 0.01f * ((i * 7919) % 101 - 50) / 50.0f;
+    return v;
+}
+
+/*
+  the cascade must give exactly the same output as the separate notch,
+  harmonic notch and low pass filters it replaces
+ */
+TEST(BiquadCascade, matches_separate_filters)
+{
+    NotchFilterVector3f notch;
+    HarmonicNotchFilterVector3f harmonic_notch;
+    LowPassFilter2pVector3f low_pass;
+
+    notch.init(SAMPLE_RATE_HZ, 250, 50, 30);
+    harmonic_notch.allocate_filters(0x7, true);
+    harmonic_notch.init(SAMPLE_RATE_HZ, 120, 40, 40);
+    low_pass.set_cutoff_frequency(SAMPLE_RATE_HZ, 80);
+
+    BiquadCascadeCoefficients coeffs;
+    BiquadCascadeVector3f cascade;
+    cascade.reset();
+
+    for (uint32_t i = 0; i < 50000; i++) {
+        // move the harmonic notch as a dynamic notch would
+        const float fundamental_hz = 120 + 60 * sinf(i * 0.0005f);
+        if (i % 100 == 0) {
+            harmonic_notch.update(fundamental_hz);
+
+            coeffs.clear_notches();
+            NotchFilterCoefficients c;
+            notch.get_coefficients(c);
+            coeffs.set_notch(0, c);
+            NotchFilterCoefficients hc[HNF_MAX_FILTERS];
+            const uint8_t n = harmonic_notch.get_coefficients(hc, HNF_MAX_FILTERS);
+            for (uint8_t j = 0; j < n; j++) {
+                coeffs.set_notch(1 + j, hc[j]);
+            }
+            coeffs.set_low_pass(low_pass.get_params());
+        }
+
+        const Vector3f sample = gyro_sample(i, fundamental_hz);
+        const Vector3f expected = low_pass.apply(harmonic_notch.apply(notch.apply(sample)));
+        const Vector3f filtered = cascade.apply(coeffs, sample);
+
+        // bit for bit, not just close
+        ASSERT_EQ(expected.x, filtered.x) << "sample " << i;
+        ASSERT_EQ(expected.y, filtered.y) << "sample " << i;
+        ASSERT_EQ(expected.z, filtered.z) << "sample " << i;
+    }
+}
+
+/*
+  a stage which is disabled and enabled again keeps its state, as the
+  separate filters do when they are skipped
+ */
+TEST(BiquadCascade, disabled_stage_matches_skipped_filter)
+{
+    NotchFilterVector3f notch;
+    LowPassFilter2pVector3f low_pass;
+
+    notch.init(SAMPLE_RATE_HZ, 250, 50, 30);
+    low_pass.set_cutoff_frequency(SAMPLE_RATE_HZ, 80);
+
+    NotchFilterCoefficients c;
+    notch.get_coefficients(c);
+
+    BiquadCascadeCoefficients coeffs;
+    BiquadCascadeVector3f cascade;
+    cascade.reset();
+
+    for (uint32_t i = 0; i < 20000; i++) {
+        const bool notch_enabled = (i / 1000) % 2 == 0;
+        coeffs.clear_notches();
+        if (notch_enabled) {
+            coeffs.set_notch(0, c);
+        }
+        coeffs.set_low_pass(low_pass.get_params());
+
+        const Vector3f sample = gyro_sample(i, 150);
+        const Vector3f expected = low_pass.apply(notch_enabled ? notch.apply(sample) : sample);
+        const Vector3f filtered = cascade.apply(coeffs, sample);
+
+        ASSERT_EQ(expected.x, filtered.x) << "sample " << i;
+        ASSERT_EQ(expected.y, filtered.y) << "sample " << i;
+        ASSERT_EQ(expected.z, filtered.z) << "sample " << i;
+    }
+}
+
+AP_GTEST_MAIN()
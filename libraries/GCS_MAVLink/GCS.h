@@ -25,7 +25,11 @@
 #include "MissionItemProtocol_Fence.h"
 #include "ap_message.h"
 
+// set to 1 (e.g. with -DGCS_DEBUG_SEND_MESSAGE_TIMINGS=1 in SITL) to
+// report how long sending takes, per message and per loop
+#ifndef GCS_DEBUG_SEND_MESSAGE_TIMINGS
 #define GCS_DEBUG_SEND_MESSAGE_TIMINGS 0
+#endif
 
 #ifndef HAL_NO_GCS
 
@@ -657,6 +661,13 @@ private:
 
     bool do_try_send_message(const ap_message id);
 
+    // set when a message did not fit in the transmit buffer. Until
+    // the port frees more space than send_blocked_txspace anything
+    // else we try would fail the same way, so update_send skips
+    // trying
+    bool send_blocked;
+    uint16_t send_blocked_txspace;
+
     // time when we missed sending a parameter for GCS
     static uint32_t reserve_param_space_start_ms;
     
@@ -763,6 +774,12 @@ private:
         int16_t current_session;
         uint32_t last_send_ms;
         uint8_t need_banner_send_mask;
+
+        // data read ahead of the client from the open file, which
+        // lets us read files in larger blocks than one reply
+        uint8_t *readahead;
+        uint32_t readahead_offset;
+        uint16_t readahead_len;
     };
     static struct ftp_state ftp;
 
@@ -775,6 +792,9 @@ private:
     void send_ftp_replies(void);
     void ftp_worker(void);
     void ftp_push_replies(pending_ftp &reply);
+    static void ftp_close_file(void);
+    static ssize_t ftp_read(uint32_t offset, uint8_t *data, uint16_t len);
+    static uint16_t ftp_burst_size(mavlink_channel_t chan);
 
     void send_distance_sensor(const class AP_RangeFinder_Backend *sensor, const uint8_t instance) const;
 
@@ -842,6 +862,10 @@ private:
         uint16_t fnbts_maxtime;
         uint32_t max_retry_deferred_body_us;
         uint8_t max_retry_deferred_body_type;
+        uint32_t blocked;                   // update_send calls skipped for lack of space
+        uint32_t msg_time_us[MSG_LAST];     // time spent trying to send each message
+        uint16_t msg_count[MSG_LAST];       // number of times each message was sent
+        uint16_t msg_fail_count[MSG_LAST];  // number of times each message failed to send
     } try_send_message_stats;
     uint16_t max_slowdown_ms;
 #endif
@@ -1032,6 +1056,16 @@ private:
     // GCS::update_send is called so we don't starve later links of
     // time in which they are permitted to send messages.
     uint8_t first_backend_to_send;
+
+#if GCS_DEBUG_SEND_MESSAGE_TIMINGS
+    // time spent in the links' update_send, reported every 10 seconds
+    struct {
+        uint32_t total_us;
+        uint32_t max_us;
+        uint32_t loops;
+        uint32_t last_report_ms;
+    } update_send_stats;
+#endif
 };
 
 GCS &gcs();
@@ -979,9 +979,20 @@ bool GCS_MAVLINK::do_try_send_message(const ap_message id)
     if (!try_send_message(id)) {
         // didn't fit in buffer...
 #if GCS_DEBUG_SEND_MESSAGE_TIMINGS
+        // a failed attempt can cost as much as a send, e.g. gathering
+        // the data before finding there is no room for it
+        try_send_message_stats.msg_time_us[id] += AP_HAL::micros() - start_send_message_us;
+        try_send_message_stats.msg_fail_count[id]++;
         try_send_message_stats.no_space_for_message++;
         hal.scheduler->restore_interrupts(data);
 #endif
+        // with room for a full packet the message failed for some
+        // other reason, so leave the link unblocked
+        const uint16_t space = txspace();
+        if (space < MAVLINK_MAX_PACKET_LEN) {
+            send_blocked = true;
+            send_blocked_txspace = space;
+        }
         return false;
     }
 #if GCS_DEBUG_SEND_MESSAGE_TIMINGS
@@ -991,6 +1002,8 @@ bool GCS_MAVLINK::do_try_send_message(const ap_message id)
         try_send_message_stats.longest_time_us = delta_us;
         try_send_message_stats.longest_id = id;
     }
+    try_send_message_stats.msg_time_us[id] += delta_us;
+    try_send_message_stats.msg_count[id]++;
 #endif
     return true;
 }
@@ -1065,8 +1078,18 @@ void GCS_MAVLINK::update_send()
     uint32_t retry_deferred_body_start = AP_HAL::micros();
 #endif
 
+    if (send_blocked && txspace() > send_blocked_txspace) {
+        // the port has sent some of what was queued
+        send_blocked = false;
+    }
+#if GCS_DEBUG_SEND_MESSAGE_TIMINGS
+    if (send_blocked) {
+        try_send_message_stats.blocked++;
+    }
+#endif
+
     const uint32_t start = AP_HAL::millis();
-    while (AP_HAL::millis() - start < 5) { // spend a max of 5ms sending messages.  This should never trigger - out_of_time() should become true
+    while (!send_blocked && AP_HAL::millis() - start < 5) { // spend a max of 5ms sending messages.  This should never trigger - out_of_time() should become true
         if (gcs().out_of_time()) {
 #if GCS_DEBUG_SEND_MESSAGE_TIMINGS
             try_send_message_stats.out_of_time++;
@@ -1489,6 +1512,33 @@ GCS_MAVLINK::update_receive(uint32_t max_time_us)
                 );
             try_send_message_stats.max_retry_deferred_body_us = 0;
         }
+        if (try_send_message_stats.blocked) {
+            gcs().send_text(MAV_SEVERITY_INFO,
+                            "GCS.chan(%u): blocked=%u",
+                            chan,
+                            try_send_message_stats.blocked);
+            try_send_message_stats.blocked = 0;
+        }
+
+        // the message which took the most time to send in total
+        uint8_t costliest_id = 0;
+        for (uint8_t i=1; i<MSG_LAST; i++) {
+            if (try_send_message_stats.msg_time_us[i] > try_send_message_stats.msg_time_us[costliest_id]) {
+                costliest_id = i;
+            }
+        }
+        if (try_send_message_stats.msg_time_us[costliest_id]) {
+            gcs().send_text(MAV_SEVERITY_INFO,
+                            "GCS.chan(%u): ap_msg=%u sent %u failed %u in %uus",
+                            chan,
+                            costliest_id,
+                            try_send_message_stats.msg_count[costliest_id],
+                            try_send_message_stats.msg_fail_count[costliest_id],
+                            try_send_message_stats.msg_time_us[costliest_id]);
+        }
+        memset(try_send_message_stats.msg_time_us, 0, sizeof(try_send_message_stats.msg_time_us));
+        memset(try_send_message_stats.msg_count, 0, sizeof(try_send_message_stats.msg_count));
+        memset(try_send_message_stats.msg_fail_count, 0, sizeof(try_send_message_stats.msg_fail_count));
 
         for (uint8_t i=0; i<ARRAY_SIZE(deferred_message_bucket); i++) {
             gcs().send_text(MAV_SEVERITY_INFO,
@@ -2006,6 +2056,9 @@ void GCS::update_send()
     if (_missionitemprotocol_fence != nullptr) {
         _missionitemprotocol_fence->update();
     }
+#if GCS_DEBUG_SEND_MESSAGE_TIMINGS
+    const uint32_t update_send_start_us = AP_HAL::micros();
+#endif
     // round-robin the GCS_MAVLINK backend that gets to go first so
     // one backend doesn't monopolise all of the time allowed for sending
     // messages
@@ -2015,6 +2068,23 @@ void GCS::update_send()
     for (uint8_t i=0; i<first_backend_to_send; i++) {
         chan(i)->update_send();
     }
+#if GCS_DEBUG_SEND_MESSAGE_TIMINGS
+    const uint32_t update_send_us = AP_HAL::micros() - update_send_start_us;
+    update_send_stats.total_us += update_send_us;
+    update_send_stats.max_us = MAX(update_send_stats.max_us, update_send_us);
+    update_send_stats.loops++;
+    const uint32_t now_ms = AP_HAL::millis();
+    if (now_ms - update_send_stats.last_report_ms > 10000U) {
+        send_text(MAV_SEVERITY_INFO,
+                  "GCS: update_send %uus/loop max=%uus",
+                  (unsigned)(update_send_stats.total_us / update_send_stats.loops),
+                  (unsigned)update_send_stats.max_us);
+        update_send_stats.total_us = 0;
+        update_send_stats.max_us = 0;
+        update_send_stats.loops = 0;
+        update_send_stats.last_report_ms = now_ms;
+    }
+#endif
     first_backend_to_send++;
     if (first_backend_to_send >= num_gcs()) {
         first_backend_to_send = 0;
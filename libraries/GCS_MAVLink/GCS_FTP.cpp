@@ -28,6 +28,18 @@ struct GCS_MAVLINK::ftp_state GCS_MAVLINK::ftp;
 // timeout for session inactivity
 #define FTP_SESSION_TIMEOUT 3000
 
+// size of the read ahead buffer for files on real filesystems
+#ifndef FTP_READAHEAD_SIZE
+#define FTP_READAHEAD_SIZE 2048
+#endif
+
+// burst reads are sized to keep the link busy for this long, so
+// that the round trip to the client between bursts is a small part
+// of the transfer time
+#define FTP_BURST_MS 500
+#define FTP_BURST_MIN 100
+#define FTP_BURST_MAX 1000
+
 bool GCS_MAVLINK::ftp_init(void) {
     // we can simply check if we allocated everything we need
     if (ftp.requests != nullptr) {
@@ -218,8 +230,7 @@ void GCS_MAVLINK::ftp_worker(void) {
                 // if a new session appears and the old session has
                 // been idle for more than the timeout then force
                 // close the old session
-                AP::FS().close(ftp.fd);
-                ftp.fd = -1;
+                ftp_close_file();
                 ftp.current_session = -1;
             }
             // dispatch the command as needed
@@ -230,10 +241,7 @@ void GCS_MAVLINK::ftp_worker(void) {
                 case FTP_OP::TerminateSession:
                 case FTP_OP::ResetSessions:
                     // we already handled this, just listed for completeness
-                    if (ftp.fd != -1) {
-                        AP::FS().close(ftp.fd);
-                        ftp.fd = -1;
-                    }
+                    ftp_close_file();
                     ftp.current_session = -1;
                     reply.opcode = FTP_OP::Ack;
                     break;
@@ -247,8 +255,7 @@ void GCS_MAVLINK::ftp_worker(void) {
                             // no activity for 3s, assume client has
                             // timed out receiving open reply, close
                             // the file
-                            AP::FS().close(ftp.fd);
-                            ftp.fd = -1;
+                            ftp_close_file();
                             ftp.current_session = -1;
                         }
                         if (ftp.fd != -1) {
@@ -282,6 +289,14 @@ void GCS_MAVLINK::ftp_worker(void) {
                         ftp.mode = FTP_FILE_MODE::Read;
                         ftp.current_session = request.session;
 
+                        // virtual filesystems generate their data as
+                        // it is read, and some depend on the reads
+                        // matching the reply size
+                        if (request.data[0] != '@') {
+                            ftp.readahead = new uint8_t[FTP_READAHEAD_SIZE];
+                            ftp.readahead_len = 0;
+                        }
+
                         reply.opcode = FTP_OP::Ack;
                         reply.size = sizeof(uint32_t);
                         put_le32_ptr(reply.data, (uint32_t)file_size);
@@ -306,14 +321,8 @@ void GCS_MAVLINK::ftp_worker(void) {
                             break;
                         }
 
-                        // seek to requested offset
-                        if (AP::FS().lseek(ftp.fd, request.offset, SEEK_SET) == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
-
                         // fill the buffer
-                        const ssize_t read_bytes = AP::FS().read(ftp.fd, reply.data, request.size);
+                        const ssize_t read_bytes = ftp_read(request.offset, reply.data, request.size);
                         if (read_bytes == -1) {
                             ftp_error(reply, FTP_ERROR::FailErrno);
                             break;
@@ -489,16 +498,10 @@ void GCS_MAVLINK::ftp_worker(void) {
                             break;
                         }
 
-                        // seek to requested offset
-                        if (AP::FS().lseek(ftp.fd, request.offset, SEEK_SET) == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
-
-                        const uint32_t transfer_size = 100;
+                        const uint32_t transfer_size = ftp_burst_size(request.chan);
                         for (uint32_t i = 0; (i < transfer_size); i++) {
                             // fill the buffer
-                            const ssize_t read_bytes = AP::FS().read(ftp.fd, reply.data, max_read);
+                            const ssize_t read_bytes = ftp_read(request.offset + i * max_read, reply.data, max_read);
                             if (read_bytes == -1) {
                                 ftp_error(reply, FTP_ERROR::FailErrno);
                                 break;
@@ -555,6 +558,73 @@ void GCS_MAVLINK::ftp_worker(void) {
     }
 }
 
+// close the open file, if any
+void GCS_MAVLINK::ftp_close_file(void)
+{
+    if (ftp.fd != -1) {
+        AP::FS().close(ftp.fd);
+        ftp.fd = -1;
+    }
+    delete[] ftp.readahead;
+    ftp.readahead = nullptr;
+}
+
+/*
+  read from the open file at the given offset. Reads go through the
+  read ahead buffer when we have one, which is refilled with as much
+  of the file as it can hold whenever it can't supply a whole read
+ */
+ssize_t GCS_MAVLINK::ftp_read(uint32_t offset, uint8_t *data, uint16_t len)
+{
+    if (ftp.readahead == nullptr) {
+        if (AP::FS().lseek(ftp.fd, offset, SEEK_SET) == -1) {
+            return -1;
+        }
+        return AP::FS().read(ftp.fd, data, len);
+    }
+
+    if (offset < ftp.readahead_offset || offset > ftp.readahead_offset + ftp.readahead_len) {
+        // not following on from the buffered data, start again
+        ftp.readahead_offset = offset;
+        ftp.readahead_len = 0;
+    }
+    uint16_t skip = offset - ftp.readahead_offset;
+    if (ftp.readahead_len - skip < len) {
+        // keep the data we still need and top up the buffer
+        ftp.readahead_len -= skip;
+        memmove(ftp.readahead, &ftp.readahead[skip], ftp.readahead_len);
+        ftp.readahead_offset = offset;
+        skip = 0;
+        if (AP::FS().lseek(ftp.fd, ftp.readahead_offset + ftp.readahead_len, SEEK_SET) == -1) {
+            return -1;
+        }
+        const ssize_t read_bytes = AP::FS().read(ftp.fd, &ftp.readahead[ftp.readahead_len],
+                                                 FTP_READAHEAD_SIZE - ftp.readahead_len);
+        if (read_bytes == -1) {
+            return -1;
+        }
+        ftp.readahead_len += read_bytes;
+    }
+    const uint16_t n = MIN(len, ftp.readahead_len - skip);
+    memcpy(data, &ftp.readahead[skip], n);
+    return n;
+}
+
+/*
+  number of replies to send for a burst read on a channel, aiming to
+  keep the link busy for FTP_BURST_MS
+ */
+uint16_t GCS_MAVLINK::ftp_burst_size(mavlink_channel_t chan)
+{
+    const AP_HAL::UARTDriver *port = mavlink_comm_port[chan];
+    if (port == nullptr) {
+        return FTP_BURST_MIN;
+    }
+    const uint32_t reply_bytes = packet_overhead_chan(chan) + MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL_LEN;
+    const uint32_t burst = port->bw_in_kilobytes_per_second() * 1024U * FTP_BURST_MS / (1000U * reply_bytes);
+    return constrain_int32(burst, FTP_BURST_MIN, FTP_BURST_MAX);
+}
+
 // calculates how much string length is needed to fit this in a list response
 int GCS_MAVLINK::gen_dir_entry(char *dest, size_t space, const char *path, const struct dirent * entry) {
     const bool is_file = entry->d_type == DT_REG;
@@ -70,9 +70,26 @@ GCS_MAVLINK::queued_param_send()
     }
     count -= async_replies_sent_count;
 
+#if AP_PARAM_TOKEN_TABLE_ENABLED
+    // with the token table each parameter and its name come from a
+    // lookup by index rather than a walk of the parameter tree
+    const bool use_token_table = AP_Param::token_table_valid();
+#endif
+
     while (count && _queued_parameter != nullptr) {
         char param_name[AP_MAX_NAME_SIZE];
-        _queued_parameter->copy_name_token(_queued_parameter_token, param_name, sizeof(param_name), true);
+#if AP_PARAM_TOKEN_TABLE_ENABLED
+        if (use_token_table) {
+            _queued_parameter = AP_Param::find_by_index(_queued_parameter_index, &_queued_parameter_type,
+                                                        &_queued_parameter_token, param_name, sizeof(param_name));
+            if (_queued_parameter == nullptr) {
+                break;
+            }
+        } else
+#endif
+        {
+            _queued_parameter->copy_name_token(_queued_parameter_token, param_name, sizeof(param_name), true);
+        }
 
         mavlink_msg_param_value_send(
             chan,
@@ -82,8 +99,17 @@ GCS_MAVLINK::queued_param_send()
             _queued_parameter_count,
             _queued_parameter_index);
 
-        _queued_parameter = AP_Param::next_scalar(&_queued_parameter_token, &_queued_parameter_type);
         _queued_parameter_index++;
+#if AP_PARAM_TOKEN_TABLE_ENABLED
+        if (use_token_table) {
+            // keep the token current so a walk can carry on from here
+            _queued_parameter = AP_Param::find_by_index(_queued_parameter_index, &_queued_parameter_type,
+                                                        &_queued_parameter_token);
+        } else
+#endif
+        {
+            _queued_parameter = AP_Param::next_scalar(&_queued_parameter_token, &_queued_parameter_type);
+        }
 
         if (AP_HAL::micros() - tstart > 1000) {
             // don't use more than 1ms sending blocks of parameters
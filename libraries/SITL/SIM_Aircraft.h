@@ -51,6 +51,12 @@ public:
     void set_speedup(float speedup);
     float get_speedup() { return target_speedup; }
 
+    /*
+      run the model as fast as possible rather than syncing to wall
+      clock time
+     */
+    void set_fast_time(bool enable) { use_time_sync = !enable; }
+
     /*
       set instance number
      */
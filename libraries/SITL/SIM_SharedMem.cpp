@@ -0,0 +1,257 @@
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+    Simulator connector for physics backends sharing a memory region
+    with SITL. Each SITL instance uses its own region, so a single
+    physics process can step any number of vehicles in lock-step
+    without a network round trip per frame.
+*/
+
+#include "SIM_SharedMem.h"
+
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include <AP_HAL/AP_HAL.h>
+
+// how long to block for the physics backend before re-waking it
+#define SHM_TIMEOUT_MS 100
+
+extern const AP_HAL::HAL& hal;
+
+using namespace SITL;
+
+/*
+  the region is shared between processes, so the futex calls must not
+  use the private variants
+ */
+static void shm_wake(uint32_t *word)
+{
+#ifdef __linux__
+    syscall(SYS_futex, word, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#else
+    (void)word;
+#endif
+}
+
+static void shm_wait(uint32_t *word, uint32_t expected, uint32_t timeout_ms)
+{
+#ifdef __linux__
+    struct timespec ts;
+    ts.tv_sec = timeout_ms / 1000;
+    ts.tv_nsec = (timeout_ms % 1000) * 1000000UL;
+    syscall(SYS_futex, word, FUTEX_WAIT, expected, &ts, nullptr, 0);
+#else
+    // no futex, poll the sequence word
+    (void)word;
+    (void)expected;
+    (void)timeout_ms;
+    usleep(20);
+#endif
+}
+
+SharedMem::SharedMem(const char *frame_str) :
+    Aircraft(frame_str)
+{
+    printf("Starting SITL: SharedMem\n");
+
+    const char *colon = strchr(frame_str, ':');
+    if (colon && colon[1] != 0) {
+        segment_name = colon+1;
+    }
+}
+
+/*
+  open (creating if needed) the shared region for this instance. The
+  physics backend may create it first, so both sides use O_CREAT
+ */
+bool SharedMem::open_region(void)
+{
+    if (segment_name == nullptr) {
+        // instance is only known once the model has been set up
+        snprintf(name_buf, sizeof(name_buf), SITL_SHM_NAME_FORMAT, unsigned(instance));
+        segment_name = name_buf;
+    }
+
+    int fd = shm_open(segment_name, O_RDWR | O_CREAT, 0600);
+    if (fd == -1) {
+        printf("SharedMem: shm_open(%s) failed: %s\n", segment_name, strerror(errno));
+        return false;
+    }
+    if (ftruncate(fd, sizeof(struct sitl_shm_region)) != 0) {
+        printf("SharedMem: ftruncate(%s) failed: %s\n", segment_name, strerror(errno));
+        close(fd);
+        return false;
+    }
+    void *ptr = mmap(nullptr, sizeof(struct sitl_shm_region), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED) {
+        printf("SharedMem: mmap(%s) failed: %s\n", segment_name, strerror(errno));
+        return false;
+    }
+    region = (struct sitl_shm_region *)ptr;
+
+    /*
+      the sequence words are reset each time SITL attaches, so a region
+      left behind by an earlier run with servo_seq equal to state_seq
+      isn't taken to be in step. A physics backend still answering a
+      frame of the earlier run stores a stale state_seq, which SITL
+      ignores as it only accepts the sequence it is waiting for
+     */
+    __atomic_store_n(&region->servo_seq, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&region->state_seq, 0, __ATOMIC_RELAXED);
+    region->version = SITL_SHM_VERSION;
+    __atomic_store_n(&region->magic, SITL_SHM_MAGIC, __ATOMIC_RELEASE);
+    shm_wake(&region->servo_seq);
+
+    printf("SharedMem: using region %s\n", segment_name);
+    return true;
+}
+
+/*
+    publish servos and return the sequence number the physics must answer
+*/
+uint32_t SharedMem::output_servos(const struct sitl_input &input)
+{
+    struct sitl_shm_servos &servos = region->servos;
+    servos.frame_rate = rate_hz;
+    servos.frame_count = frame_counter;
+    for (uint8_t i=0; i<SITL_SHM_NUM_SERVOS; i++) {
+        servos.pwm[i] = input.servos[i];
+    }
+
+    const uint32_t seq = __atomic_add_fetch(&region->servo_seq, 1, __ATOMIC_RELEASE);
+    shm_wake(&region->servo_seq);
+    return seq;
+}
+
+/*
+    block until the physics backend has answered the given servo frame
+*/
+void SharedMem::wait_state(uint32_t seq)
+{
+    // use wall clock time, simulated time is stopped while we wait
+    uint64_t wait_start_us = get_wall_time_us();
+    while (true) {
+        const uint32_t state_seq = __atomic_load_n(&region->state_seq, __ATOMIC_ACQUIRE);
+        if (state_seq == seq) {
+            return;
+        }
+        shm_wait(&region->state_seq, state_seq, SHM_TIMEOUT_MS);
+
+        const uint64_t now_us = get_wall_time_us();
+        if (now_us - wait_start_us > 1000000UL) {
+            wait_start_us = now_us;
+            printf("SharedMem: waiting for physics on %s\n", segment_name);
+            // in case the physics backend started after our wake
+            shm_wake(&region->servo_seq);
+        }
+    }
+}
+
+void SharedMem::recv_fdm(void)
+{
+    const struct sitl_shm_state &state = region->state;
+
+    accel_body = Vector3f(state.accel_body[0], state.accel_body[1], state.accel_body[2]);
+    gyro = Vector3f(state.gyro[0], state.gyro[1], state.gyro[2]);
+    velocity_ef = Vector3f(state.velocity[0], state.velocity[1], state.velocity[2]);
+    position = Vector3f(state.position[0], state.position[1], state.position[2]);
+
+    Quaternion quat(state.quaternion[0], state.quaternion[1], state.quaternion[2], state.quaternion[3]);
+    quat.rotation_matrix(dcm);
+
+    // velocity relative to airmass in body frame
+    velocity_air_bf = dcm.transposed() * velocity_ef;
+
+    // airspeed
+    airspeed = velocity_air_bf.length();
+
+    // airspeed as seen by a fwd pitot tube (limited to 120m/s)
+    airspeed_pitot = constrain_float(velocity_air_bf * Vector3f(1.0f, 0.0f, 0.0f), 0.0f, 120.0f);
+
+    // Convert from a meters from origin physics to a lat long alt
+    update_position();
+
+    // update range finder distances
+    for (uint8_t i=0; i<SITL_SHM_NUM_RANGEFINDERS; i++) {
+        if (!isnan(state.rng[i])) {
+            rangefinder_m[i] = state.rng[i];
+        }
+    }
+
+    // update wind vane
+    if (!isnan(state.wind_vane_direction)) {
+        wind_vane_apparent.direction = state.wind_vane_direction;
+    }
+    if (!isnan(state.wind_vane_speed)) {
+        wind_vane_apparent.speed = state.wind_vane_speed;
+    }
+
+    double deltat;
+    if (state.timestamp_s < last_timestamp_s) {
+        // Physics time has gone backwards, don't reset AP
+        printf("Detected physics reset\n");
+        deltat = 0;
+    } else {
+        deltat = state.timestamp_s - last_timestamp_s;
+    }
+    time_now_us += deltat * 1.0e6;
+
+    if (is_positive(deltat) && deltat < 0.1) {
+        // time in us to hz
+        adjust_frame_time(1.0 / deltat);
+
+        // match actual frame rate with desired speedup
+        time_advance();
+    }
+    last_timestamp_s = state.timestamp_s;
+    frame_counter++;
+}
+
+/*
+   update the shared memory simulation by one time step
+*/
+void SharedMem::update(const struct sitl_input &input)
+{
+    if (region == nullptr && !open_region()) {
+        // nothing useful we can do, avoid spinning
+        usleep(100000);
+        return;
+    }
+
+    // hand the servos to the physics and wait for it to step
+    const uint32_t seq = output_servos(input);
+    wait_state(seq);
+    recv_fdm();
+
+    // update magnetic field
+    // as the model does not provide mag field we calculate it from position and attitude
+    update_mag_field_bf();
+
+    // allow for changes in physics step
+    adjust_frame_time(constrain_float(sitl->loop_rate_hz, rate_hz-1, rate_hz+1));
+}
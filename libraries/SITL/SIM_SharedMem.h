@@ -0,0 +1,54 @@
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+    lock-step simulator connector using a shared memory region,
+    see examples/SharedMem/readme.md
+*/
+#pragma once
+
+#include "SIM_Aircraft.h"
+#include "SIM_SharedMem_protocol.h"
+
+namespace SITL {
+
+class SharedMem : public Aircraft {
+public:
+    SharedMem(const char *frame_str);
+
+    /* update model by one time step */
+    void update(const struct sitl_input &input) override;
+
+    /* static object creator */
+    static Aircraft *create(const char *frame_str) {
+        return new SharedMem(frame_str);
+    }
+
+private:
+    // segment name from the frame string, nullptr for the instance default
+    const char *segment_name;
+    char name_buf[32];
+
+    struct sitl_shm_region *region;
+
+    uint32_t frame_counter;
+    double last_timestamp_s;
+
+    bool open_region(void);
+    uint32_t output_servos(const struct sitl_input &input);
+    void wait_state(uint32_t seq);
+    void recv_fdm(void);
+};
+
+}
@@ -0,0 +1,69 @@
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+    layout of the shared memory region used by the SharedMem SITL
+    backend. This header is plain C so that physics backends can
+    include it directly.
+*/
+#pragma once
+
+#include <stdint.h>
+
+#define SITL_SHM_MAGIC   0x4D485341 // "ASHM"
+#define SITL_SHM_VERSION 1
+
+// default segment name, formatted with the SITL instance number
+#define SITL_SHM_NAME_FORMAT "/ardupilot_sitl_%u"
+
+#define SITL_SHM_NUM_SERVOS 16
+#define SITL_SHM_NUM_RANGEFINDERS 6
+
+// written by ArduPilot before servo_seq is incremented
+struct sitl_shm_servos {
+    uint16_t frame_rate;
+    uint16_t reserved;
+    uint32_t frame_count;
+    uint16_t pwm[SITL_SHM_NUM_SERVOS];
+};
+
+// written by the physics backend before state_seq is updated
+struct sitl_shm_state {
+    double timestamp_s;     // physics time
+    float gyro[3];          // rad/s, body frame
+    float accel_body[3];    // m/s/s, body frame
+    float position[3];      // m, NED from origin
+    float quaternion[4];    // body to earth rotation
+    float velocity[3];      // m/s, NED
+    float rng[SITL_SHM_NUM_RANGEFINDERS]; // m, NaN if not fitted
+    float wind_vane_direction; // rad, NaN if not fitted
+    float wind_vane_speed;     // m/s, NaN if not fitted
+};
+
+struct sitl_shm_region {
+    uint32_t magic;
+    uint32_t version;
+
+    /*
+      lock-step sequence words, also used as futex words on Linux.
+      ArduPilot increments servo_seq once the servos block is
+      written. The physics backend then writes the state block and
+      stores the servo_seq value it answered into state_seq.
+     */
+    uint32_t servo_seq;
+    uint32_t state_seq;
+
+    struct sitl_shm_servos servos;
+    struct sitl_shm_state state;
+};
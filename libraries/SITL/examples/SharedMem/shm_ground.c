@@ -0,0 +1,113 @@
+/*
+  minimal physics backend for the SITL SharedMem interface
+
+  Serves any number of SITL instances from one process. Every vehicle
+  sits level on the ground at the origin, which is enough to check the
+  lock-step exchange and to measure the achievable frame rate.
+
+  build: gcc -O2 -Wall -I../.. -o shm_ground shm_ground.c -lrt
+  run:   ./shm_ground 4      (for SITL instances 0 to 3)
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#include "SIM_SharedMem_protocol.h"
+
+#define MAX_VEHICLES 32
+
+struct vehicle {
+    struct sitl_shm_region *region;
+    uint32_t last_seq;
+    double time_s;
+};
+
+static struct sitl_shm_region *open_region(unsigned instance)
+{
+    char name[32];
+    snprintf(name, sizeof(name), SITL_SHM_NAME_FORMAT, instance);
+    int fd = shm_open(name, O_RDWR | O_CREAT, 0600);
+    if (fd == -1 || ftruncate(fd, sizeof(struct sitl_shm_region)) != 0) {
+        perror(name);
+        exit(1);
+    }
+    void *ptr = mmap(NULL, sizeof(struct sitl_shm_region), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED) {
+        perror("mmap");
+        exit(1);
+    }
+    return (struct sitl_shm_region *)ptr;
+}
+
+static void step(struct vehicle *v, uint32_t seq)
+{
+    struct sitl_shm_region *r = v->region;
+    if (seq < v->last_seq) {
+        // region was set up again
+        v->time_s = 0;
+    }
+    v->last_seq = seq;
+    v->time_s += 1.0 / (r->servos.frame_rate ? r->servos.frame_rate : 1000);
+
+    struct sitl_shm_state *s = &r->state;
+    memset(s, 0, sizeof(*s));
+    s->timestamp_s = v->time_s;
+    s->accel_body[2] = -9.80665f;
+    s->quaternion[0] = 1;
+    for (unsigned i=0; i<SITL_SHM_NUM_RANGEFINDERS; i++) {
+        s->rng[i] = NAN;
+    }
+    s->wind_vane_direction = NAN;
+    s->wind_vane_speed = NAN;
+
+    __atomic_store_n(&r->state_seq, seq, __ATOMIC_RELEASE);
+    syscall(SYS_futex, &r->state_seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned count = argc > 1 ? atoi(argv[1]) : 1;
+    if (count < 1 || count > MAX_VEHICLES) {
+        fprintf(stderr, "vehicle count must be 1 to %u\n", MAX_VEHICLES);
+        return 1;
+    }
+    struct vehicle vehicles[MAX_VEHICLES] = {0};
+    for (unsigned i=0; i<count; i++) {
+        vehicles[i].region = open_region(i);
+    }
+
+    while (1) {
+        unsigned stepped = 0;
+        for (unsigned i=0; i<count; i++) {
+            struct sitl_shm_region *r = vehicles[i].region;
+            if (__atomic_load_n(&r->magic, __ATOMIC_ACQUIRE) != SITL_SHM_MAGIC) {
+                continue;
+            }
+            const uint32_t seq = __atomic_load_n(&r->servo_seq, __ATOMIC_ACQUIRE);
+            if (seq != __atomic_load_n(&r->state_seq, __ATOMIC_RELAXED)) {
+                step(&vehicles[i], seq);
+                stepped++;
+            }
+        }
+        if (stepped == 0 && count == 1) {
+            // single vehicle, sleep until SITL publishes servos
+            struct sitl_shm_region *r = vehicles[0].region;
+            struct timespec ts = { 0, 100000000 };
+            syscall(SYS_futex, &r->servo_seq, FUTEX_WAIT, r->state_seq, &ts, NULL, 0);
+        } else if (stepped == 0) {
+            sched_yield();
+        }
+    }
+    return 0;
+}